@@ -0,0 +1,128 @@
+// Times ObjImporter::Import single threaded and with one thread per hardware thread, next to the tinyobjloader parse alone.
+// Link it with ObjImporter.cpp, which holds the tinyobjloader implementation:
+//   g++ -std=c++20 -O2 -pthread -Isrc -Isrc/vendor -I<Vulkan SDK>/include -I<GLFW>/include Benchmarks/ObjImportBenchmark.cpp src/Mesh/ObjImporter.cpp -o ObjImportBenchmark
+//   ObjImportBenchmark Res/Models/viking_room.obj
+//   ObjImportBenchmark --grid 1000        (writes and imports a 1000x1000 quad grid, 2M triangles)
+
+#include "Mesh/ObjImporter.hpp"
+
+#include "tinyobjloader/tiny_obj_loader.h"
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <limits>
+#include <filesystem>
+
+namespace VE
+{
+	static constexpr uint32_t RUN_COUNT = 3;
+
+	// Shared positions and UVs on a regular grid, the vertex reuse of a typical tessellated or scanned mesh
+	static std::string WriteGrid(uint32_t size)
+	{
+		std::string path = (std::filesystem::temp_directory_path() / ("grid" + std::to_string(size) + ".obj")).string();
+		std::ofstream file(path);
+
+		for (uint32_t y = 0; y <= size; y++)
+		{
+			for (uint32_t x = 0; x <= size; x++)
+			{
+				file << "v " << x << " " << y << " 0\nvt " << static_cast<float>(x) / size << " " << static_cast<float>(y) / size << "\n";
+			}
+		}
+
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				uint32_t i = y * (size + 1) + x + 1;
+				uint32_t j = i + size + 1;
+				file << "f " << i << "/" << i << " " << i + 1 << "/" << i + 1 << " " << j + 1 << "/" << j + 1 << "\n";
+				file << "f " << i << "/" << i << " " << j + 1 << "/" << j + 1 << " " << j << "/" << j << "\n";
+			}
+		}
+
+		if (!file)
+		{
+			throw std::runtime_error("Error: Failed to write " + path);
+		}
+		return path;
+	}
+
+	// Best of RUN_COUNT runs in milliseconds
+	template<typename Function>
+	static double Measure(Function function)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (uint32_t run = 0; run < RUN_COUNT; run++)
+		{
+			auto startTime = std::chrono::high_resolution_clock::now();
+			function();
+			auto endTime = std::chrono::high_resolution_clock::now();
+			best = std::min(best, std::chrono::duration<double, std::milli>(endTime - startTime).count());
+		}
+		return best;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace VE;
+
+	if (argc < 2)
+	{
+		std::cerr << "Usage: ObjImportBenchmark <file.obj> | --grid <size>" << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		bool isGrid = std::string(argv[1]) == "--grid";
+		std::string path = isGrid ? WriteGrid(argc > 2 ? std::stoul(argv[2]) : 1000) : argv[1];
+
+		double parseTime = Measure([&]()
+		{
+			tinyobj::attrib_t attrib;
+			std::vector<tinyobj::shape_t> shapes;
+			std::vector<tinyobj::material_t> materials;
+			std::string warn, err;
+			tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str());
+		});
+
+		ImportSettings settings;
+		MeshData serialMesh, parallelMesh;
+
+		settings.threadCount = 1;
+		double serialTime = Measure([&]() { serialMesh = ObjImporter::Import(path, settings); });
+
+		settings.threadCount = 0;
+		double parallelTime = Measure([&]() { parallelMesh = ObjImporter::Import(path, settings); });
+
+		std::cout	<< path << ": " << serialMesh.vertices.size() << " vertices, " << serialMesh.indices.size() / 3 << " triangles, best of " << RUN_COUNT << " runs" << std::endl
+					<< "Parse:                " << parseTime << " ms" << std::endl
+					<< "Import, 1 thread:     " << serialTime << " ms (dedup " << serialTime - parseTime << " ms)" << std::endl
+					<< "Import, up to " << std::max(1u, std::thread::hardware_concurrency()) << " threads: " << parallelTime << " ms (dedup " << parallelTime - parseTime << " ms)" << std::endl;
+
+		// Chunks are merged in order, threading must not change the result
+		if (serialMesh.vertices != parallelMesh.vertices || serialMesh.indices != parallelMesh.indices)
+		{
+			std::cerr << "Error: Single and multi threaded imports differ" << std::endl;
+			return 1;
+		}
+
+		if (isGrid)
+		{
+			std::filesystem::remove(path);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,117 @@
+// Compares VertexHashMap against the std::unordered_map and std::hash<Vertex> that Model.cpp used for vertex deduplication.
+// Standalone, only needs the glm headers plus the Vulkan and GLFW include directories that Buffer.hpp pulls in:
+//   g++ -std=c++20 -O2 -Isrc -Isrc/vendor -I<Vulkan SDK>/include -I<GLFW>/include Benchmarks/VertexHashMapBenchmark.cpp -o VertexHashMapBenchmark
+//   VertexHashMapBenchmark [unique vertices] [lookups]
+
+#include "Mesh/VertexHashMap.hpp"
+
+#include <glm/gtx/hash.hpp>
+
+#include <unordered_map>
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <type_traits>
+#include <string>
+
+namespace std
+{
+	// The specialization Model.cpp used before VertexHashMap
+	template<> struct hash<VE::Vertex> {
+		size_t operator()(VE::Vertex const& vertex) const
+		{
+			return ((hash<glm::vec3>()(vertex.position) ^
+				(hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^
+				(hash<glm::vec2>()(vertex.texCoords) << 1);
+		}
+	};
+}
+
+namespace VE
+{
+	static constexpr uint32_t RUN_COUNT = 3;
+
+	// Deduplicates the stream the way the importers do and returns the index buffer
+	template<typename Map>
+	static std::vector<uint32_t> Deduplicate(const std::vector<Vertex>& stream)
+	{
+		Map uniqueVertices;
+		std::vector<uint32_t> indices;
+		indices.reserve(stream.size());
+		uint32_t vertexCount = 0;
+
+		for (const auto& vertex : stream)
+		{
+			if constexpr (std::is_same_v<Map, VertexHashMap>)
+			{
+				auto [index, inserted] = uniqueVertices.TryEmplace(vertex, vertexCount);
+				vertexCount += inserted ? 1 : 0;
+				indices.push_back(index);
+			}
+			else
+			{
+				auto [it, inserted] = uniqueVertices.try_emplace(vertex, vertexCount);
+				vertexCount += inserted ? 1 : 0;
+				indices.push_back(it->second);
+			}
+		}
+
+		return indices;
+	}
+
+	// Best of RUN_COUNT runs in milliseconds
+	template<typename Map>
+	static double Measure(const std::vector<Vertex>& stream, std::vector<uint32_t>& indices)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (uint32_t run = 0; run < RUN_COUNT; run++)
+		{
+			auto startTime = std::chrono::high_resolution_clock::now();
+			indices = Deduplicate<Map>(stream);
+			auto endTime = std::chrono::high_resolution_clock::now();
+			best = std::min(best, std::chrono::duration<double, std::milli>(endTime - startTime).count());
+		}
+		return best;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace VE;
+
+	size_t uniqueCount = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+	size_t lookupCount = argc > 2 ? std::stoull(argv[2]) : 6'000'000;
+
+	// Quantized positions and UVs like a scanned or tessellated mesh, every vertex is looked up about six times
+	std::mt19937 rng(1);
+	std::vector<Vertex> uniqueVertices(uniqueCount);
+	for (auto& vertex : uniqueVertices)
+	{
+		vertex.position = glm::vec3(rng() % 1000 / 10.0f, rng() % 1000 / 10.0f, rng() % 1000 / 10.0f);
+		vertex.color = glm::vec3(1.0f, 1.0f, 1.0f);
+		vertex.texCoords = glm::vec2(rng() % 1024 / 1024.0f, rng() % 1024 / 1024.0f);
+	}
+
+	std::vector<Vertex> stream(lookupCount);
+	for (auto& vertex : stream)
+	{
+		vertex = uniqueVertices[rng() % uniqueCount];
+	}
+
+	std::vector<uint32_t> mapIndices, flatIndices;
+	double mapTime = Measure<std::unordered_map<Vertex, uint32_t>>(stream, mapIndices);
+	double flatTime = Measure<VertexHashMap>(stream, flatIndices);
+
+	std::cout	<< lookupCount << " lookups, " << uniqueCount << " unique vertices, best of " << RUN_COUNT << " runs" << std::endl
+				<< "std::unordered_map: " << mapTime << " ms" << std::endl
+				<< "VertexHashMap:      " << flatTime << " ms (" << mapTime / flatTime << "x)" << std::endl;
+
+	if (mapIndices != flatIndices)
+	{
+		std::cerr << "Error: The maps produced different indices" << std::endl;
+		return 1;
+	}
+	return 0;
+}
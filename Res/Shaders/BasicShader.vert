@@ -1,7 +1,7 @@
 #version 450
 
 layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 color;
+layout(location = 1) in vec3 color; // Packed normal with VertexFormat::Compact
 layout(location = 2) in vec2 texCoord;
 
 layout(location = 0) out vec3 fragColor;
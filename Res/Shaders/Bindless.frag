@@ -0,0 +1,17 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragCoord;
+// Constant across a draw, and every draw of a multi-draw is its own invocation group, so the index needs no nonuniformEXT
+layout(location = 2) flat in uint textureIndex;
+
+// Every texture of the scene, see BindlessTextureArray
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+	outColor = texture(textures[textureIndex], fragCoord);
+}
@@ -1,3 +1,7 @@
 glslc BasicShader.vert -o basicshadervert.spv
 glslc BasicShader.frag -o basicshaderfrag.spv
+glslc MeshletCull.comp -o meshletcullcomp.spv
+glslc VirtualTexture.frag -o virtualtexturefrag.spv
+glslc Bindless.vert -o bindlessvert.spv
+glslc Bindless.frag -o bindlessfrag.spv
 pause
\ No newline at end of file
@@ -0,0 +1,76 @@
+#version 450
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragCoord;
+
+layout(set = 1, binding = 0) uniform sampler2D physicalCache;
+layout(set = 1, binding = 1) uniform usampler2D indirection;
+
+// One flag per page of every registered virtual texture, read back and cleared by the host
+layout(std430, set = 1, binding = 2) writeonly buffer Feedback
+{
+    uint requested[];
+};
+
+layout(push_constant) uniform VirtualTextureParams
+{
+    uvec2 size;          // Texels at mip 0
+    uvec2 tableSize;     // Indirection texels at mip 0, one per page
+    uint feedbackOffset;
+    uint topMip;
+    uint feedbackPixel;  // Pixel of every 4x4 block that writes feedback this frame
+    uint padding;
+} params;
+
+layout(location = 0) out vec4 outColor;
+
+// Must match VirtualTextureCache
+const float PAGE_SIZE = 128.0;
+const float PAGE_BORDER = 4.0;
+const float PAGE_CONTENT = PAGE_SIZE - 2.0 * PAGE_BORDER;
+
+uvec2 TableSize(uint mip)
+{
+    return max(params.tableSize >> mip, uvec2(1));
+}
+
+vec2 MipSize(uint mip)
+{
+    return vec2(max(params.size >> mip, uvec2(1)));
+}
+
+void main()
+{
+    // Derivatives are taken before wrapping, so repeating UVs don't select a coarse mip at the seams
+    vec2 texel = fragCoord * vec2(params.size);
+    vec2 dx = dFdx(texel);
+    vec2 dy = dFdy(texel);
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy)));
+    uint mip = uint(clamp(floor(lod), 0.0, float(params.topMip)));
+
+    vec2 uv = fract(fragCoord);
+    uvec2 page = min(uvec2(uv * MipSize(mip) / PAGE_CONTENT), TableSize(mip) - 1u);
+
+    uint pixel = (uint(gl_FragCoord.x) & 3u) | ((uint(gl_FragCoord.y) & 3u) << 2);
+    if (pixel == params.feedbackPixel)
+    {
+        uint levelOffset = 0;
+        for (uint i = 0; i < mip; i++)
+        {
+            uvec2 levelSize = TableSize(i);
+            levelOffset += levelSize.x * levelSize.y;
+        }
+        requested[params.feedbackOffset + levelOffset + page.y * TableSize(mip).x + page.x] = 1u;
+    }
+
+    // The entry names the slot holding this page or its nearest resident ancestor and the mip that slot holds
+    uvec4 entry = texelFetch(indirection, ivec2(page), int(mip));
+    uint residentMip = entry.b;
+    uvec2 residentPage = page >> (residentMip - mip);
+
+    vec2 local = uv * MipSize(residentMip) - vec2(residentPage) * PAGE_CONTENT;
+    local = clamp(local, vec2(0.5 - PAGE_BORDER), vec2(PAGE_CONTENT + PAGE_BORDER - 0.5));
+
+    vec2 physical = (vec2(entry.rg) * PAGE_SIZE + PAGE_BORDER + local) / vec2(textureSize(physicalCache, 0));
+    outColor = textureLod(physicalCache, physical, 0.0);
+}
@@ -0,0 +1,491 @@
+// Runs MeshletCull.comp on the first available Vulkan device, preferring a software one such as lavapipe or SwiftShader,
+// and checks which meshlets survive and the indirect draws written for them, including the first instance that
+// carries the texture index looked up by the meshlet's material. Returns non-zero on failure.
+//   g++ -std=c++20 -Isrc -Isrc/vendor -I<Vulkan SDK>/include -I<GLFW>/include Tests/MeshletCullTest.cpp -lvulkan -o MeshletCullTest
+//   MeshletCullTest [Res/Shaders/meshletcullcomp.spv]
+// With several drivers installed, VK_ICD_FILENAMES=<lvp_icd.json> forces lavapipe.
+
+#include "Mesh/MeshData.hpp"
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+#define TEST_CHECK(x)																\
+	if (!(x))																		\
+	{																				\
+		throw std::runtime_error(std::string("Check failed: ") + #x);				\
+	}
+
+namespace VE
+{
+	// Matches the push constants of MeshletCull.comp and MeshletCuller::CullParams
+	struct CullParams
+	{
+		glm::vec4	planes[6];
+		glm::vec4	cameraPosition;
+		uint32_t	meshletCount;
+		uint32_t	drawOffset;
+		uint32_t	counterIndex;
+		uint32_t	materialOffset;
+	};
+
+	static_assert(sizeof(Meshlet) == 48, "Meshlet has to match the std430 layout in MeshletCull.comp");
+	static_assert(sizeof(CullParams) == 128, "CullParams has to match the push constants in MeshletCull.comp");
+
+	static constexpr uint32_t DRAW_OFFSET = 4;
+	static constexpr uint32_t COUNTER_INDEX = 1;
+	static constexpr uint32_t MATERIAL_OFFSET = 2;
+	static constexpr uint32_t DRAW_CAPACITY = 16;
+	// Bindless indices of the model's three materials follow two slots of another model
+	static constexpr std::array<uint32_t, 5> MATERIAL_INDICES = { 90, 91, 7, 8, 9 };
+
+	struct HostBuffer
+	{
+		VkBuffer		buffer = VK_NULL_HANDLE;
+		VkDeviceMemory	memory = VK_NULL_HANDLE;
+		void*			data = nullptr;
+	};
+
+	class CullTest
+	{
+	public:
+		CullTest() = default;
+		~CullTest();
+
+		CullTest(const CullTest& otherTest) = delete;
+		CullTest& operator=(const CullTest& otherTest) = delete;
+	public:
+		void Run(const std::string& shaderPath);
+	private:
+		void CreateDevice();
+		HostBuffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
+		void CreatePipeline(const std::string& shaderPath);
+		void Dispatch(const CullParams& params, uint32_t meshletCount);
+	private:
+		VkInstance						m_Instance = VK_NULL_HANDLE;
+		VkPhysicalDevice				m_PhysicalDevice = VK_NULL_HANDLE;
+		VkDevice						m_Device = VK_NULL_HANDLE;
+		VkQueue							m_Queue = VK_NULL_HANDLE;
+		uint32_t						m_QueueFamily = 0;
+		VkDescriptorSetLayout			m_DescriptorSetLayout = VK_NULL_HANDLE;
+		VkPipelineLayout				m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline						m_Pipeline = VK_NULL_HANDLE;
+		VkDescriptorPool				m_DescriptorPool = VK_NULL_HANDLE;
+		VkCommandPool					m_CommandPool = VK_NULL_HANDLE;
+		HostBuffer						m_Meshlets;
+		HostBuffer						m_Draws;
+		HostBuffer						m_Counters;
+		HostBuffer						m_Materials;
+	};
+
+	CullTest::~CullTest()
+	{
+		if (!m_Device)
+		{
+			vkDestroyInstance(m_Instance, nullptr);
+			return;
+		}
+
+		for (HostBuffer* buffer : { &m_Meshlets, &m_Draws, &m_Counters, &m_Materials })
+		{
+			vkDestroyBuffer(m_Device, buffer->buffer, nullptr);
+			vkFreeMemory(m_Device, buffer->memory, nullptr);
+		}
+		vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
+		vkDestroyDescriptorPool(m_Device, m_DescriptorPool, nullptr);
+		vkDestroyPipeline(m_Device, m_Pipeline, nullptr);
+		vkDestroyPipelineLayout(m_Device, m_PipelineLayout, nullptr);
+		vkDestroyDescriptorSetLayout(m_Device, m_DescriptorSetLayout, nullptr);
+		vkDestroyDevice(m_Device, nullptr);
+		vkDestroyInstance(m_Instance, nullptr);
+	}
+
+	void CullTest::Run(const std::string& shaderPath)
+	{
+		CreateDevice();
+		CreatePipeline(shaderPath);
+
+		// Camera at the origin looking down -Z with a 90 degree field of view, near 0.1 and far 100.
+		// Planes point inwards, a meshlet is culled once its bounding sphere is fully behind one of them
+		const float s = 1.0f / std::sqrt(2.0f);
+		CullParams params{};
+		params.planes[0] = glm::vec4(s, 0.0f, -s, 0.0f);		// Left
+		params.planes[1] = glm::vec4(-s, 0.0f, -s, 0.0f);		// Right
+		params.planes[2] = glm::vec4(0.0f, s, -s, 0.0f);		// Bottom
+		params.planes[3] = glm::vec4(0.0f, -s, -s, 0.0f);		// Top
+		params.planes[4] = glm::vec4(0.0f, 0.0f, -1.0f, -0.1f);	// Near
+		params.planes[5] = glm::vec4(0.0f, 0.0f, 1.0f, 100.0f);	// Far
+		params.cameraPosition = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		params.drawOffset = DRAW_OFFSET;
+		params.counterIndex = COUNTER_INDEX;
+		params.materialOffset = MATERIAL_OFFSET;
+
+		// A cone cutoff of 1 disables the back-face test
+		const glm::vec3 noCone(0.0f, 0.0f, 1.0f);
+		std::vector<Meshlet> meshlets =
+		{
+			{ glm::vec3(0.0f, 0.0f, -10.0f),	1.0f, noCone,							1.0f },	// 0 In front of the camera
+			{ glm::vec3(0.0f, 0.0f, 10.0f),		1.0f, noCone,							1.0f },	// 1 Behind the camera
+			{ glm::vec3(-30.0f, 0.0f, -10.0f),	1.0f, noCone,							1.0f },	// 2 Left of the frustum
+			{ glm::vec3(10.5f, 0.0f, -10.0f),	1.0f, noCone,							1.0f },	// 3 Straddles the right plane
+			{ glm::vec3(0.0f, 0.0f, -200.0f),	1.0f, noCone,							1.0f },	// 4 Beyond the far plane
+			{ glm::vec3(0.0f, 0.0f, -10.0f),	1.0f, glm::vec3(0.0f, 0.0f, -1.0f),	0.5f },	// 5 Every triangle faces away
+			{ glm::vec3(0.0f, 0.0f, -10.0f),	1.0f, glm::vec3(0.0f, 0.0f, 1.0f),		0.5f },	// 6 Faces the camera
+			{ glm::vec3(0.0f, 0.0f, -10.0f),	1.0f, noCone,							1.0f }	// 7 Visible but past meshletCount
+		};
+		for (uint32_t i = 0; i < meshlets.size(); i++)
+		{
+			meshlets[i].firstIndex = i * 300;
+			meshlets[i].indexCount = 30 + i * 3;
+			meshlets[i].vertexOffset = static_cast<int32_t>(i) * 1000 - 2000;
+			meshlets[i].material = i % 3;
+		}
+
+		params.meshletCount = static_cast<uint32_t>(meshlets.size()) - 1;
+		std::memcpy(m_Meshlets.data, meshlets.data(), meshlets.size() * sizeof(Meshlet));
+		std::memset(m_Draws.data, 0xFF, DRAW_CAPACITY * sizeof(VkDrawIndexedIndirectCommand));
+		std::memset(m_Counters.data, 0xFF, 4 * sizeof(uint32_t));
+		std::memset(m_Materials.data, 0xFF, MATERIAL_INDICES.size() * sizeof(uint32_t));
+
+		Dispatch(params, static_cast<uint32_t>(meshlets.size()));
+
+		const uint32_t* counters = static_cast<const uint32_t*>(m_Counters.data);
+		const VkDrawIndexedIndirectCommand* draws = static_cast<const VkDrawIndexedIndirectCommand*>(m_Draws.data);
+		std::cout << "Surviving meshlets: " << counters[COUNTER_INDEX] << std::endl;
+
+		const std::array<uint32_t, 3> expected = { 0, 3, 6 };
+		TEST_CHECK(counters[COUNTER_INDEX] == expected.size())
+		TEST_CHECK(counters[0] == 0)
+
+		// Survivors are packed to the front of the range in whatever order the atomics handed out the slots
+		std::vector<VkDrawIndexedIndirectCommand> survivors(draws + DRAW_OFFSET, draws + DRAW_OFFSET + expected.size());
+		std::sort(survivors.begin(), survivors.end(), [](const auto& a, const auto& b) { return a.firstIndex < b.firstIndex; });
+		for (uint32_t i = 0; i < expected.size(); i++)
+		{
+			const Meshlet& meshlet = meshlets[expected[i]];
+			TEST_CHECK(survivors[i].indexCount == meshlet.indexCount)
+			TEST_CHECK(survivors[i].instanceCount == 1)
+			TEST_CHECK(survivors[i].firstIndex == meshlet.firstIndex)
+			TEST_CHECK(survivors[i].vertexOffset == meshlet.vertexOffset)
+			TEST_CHECK(survivors[i].firstInstance == MATERIAL_INDICES[MATERIAL_OFFSET + meshlet.material])
+		}
+
+		// The fill before the dispatch zeroes the unused tail, which then draws nothing
+		for (uint32_t i = DRAW_OFFSET + static_cast<uint32_t>(expected.size()); i < DRAW_OFFSET + params.meshletCount; i++)
+		{
+			TEST_CHECK(draws[i].indexCount == 0 && draws[i].instanceCount == 0)
+		}
+	}
+
+	void CullTest::CreateDevice()
+	{
+		VkApplicationInfo appInfo{};
+		appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+		appInfo.pApplicationName = "MeshletCullTest";
+		appInfo.apiVersion = VK_API_VERSION_1_0;
+
+		VkInstanceCreateInfo instanceInfo{};
+		instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+		instanceInfo.pApplicationInfo = &appInfo;
+
+		if (vkCreateInstance(&instanceInfo, nullptr, &m_Instance) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Error: Failed to create a Vulkan instance!");
+		}
+
+		uint32_t deviceCount = 0;
+		vkEnumeratePhysicalDevices(m_Instance, &deviceCount, nullptr);
+		std::vector<VkPhysicalDevice> devices(deviceCount);
+		vkEnumeratePhysicalDevices(m_Instance, &deviceCount, devices.data());
+
+		for (VkPhysicalDevice device : devices)
+		{
+			VkPhysicalDeviceProperties properties;
+			vkGetPhysicalDeviceProperties(device, &properties);
+
+			uint32_t familyCount = 0;
+			vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+			std::vector<VkQueueFamilyProperties> families(familyCount);
+			vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+
+			for (uint32_t i = 0; i < familyCount; i++)
+			{
+				bool isBetter = !m_PhysicalDevice || properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU;
+				if ((families[i].queueFlags & VK_QUEUE_COMPUTE_BIT) && isBetter)
+				{
+					m_PhysicalDevice = device;
+					m_QueueFamily = i;
+					break;
+				}
+			}
+		}
+
+		if (!m_PhysicalDevice)
+		{
+			throw std::runtime_error("Error: No Vulkan device with a compute queue!");
+		}
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
+		std::cout << "Device: " << properties.deviceName << std::endl;
+
+		float priority = 1.0f;
+		VkDeviceQueueCreateInfo queueInfo{};
+		queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+		queueInfo.queueFamilyIndex = m_QueueFamily;
+		queueInfo.queueCount = 1;
+		queueInfo.pQueuePriorities = &priority;
+
+		VkDeviceCreateInfo deviceInfo{};
+		deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		deviceInfo.queueCreateInfoCount = 1;
+		deviceInfo.pQueueCreateInfos = &queueInfo;
+
+		if (vkCreateDevice(m_PhysicalDevice, &deviceInfo, nullptr, &m_Device) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Error: Failed to create a logical device!");
+		}
+		vkGetDeviceQueue(m_Device, m_QueueFamily, 0, &m_Queue);
+
+		m_Meshlets = CreateBuffer(DRAW_CAPACITY * sizeof(Meshlet), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+		m_Draws = CreateBuffer(DRAW_CAPACITY * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+		m_Counters = CreateBuffer(4 * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+		m_Materials = CreateBuffer(MATERIAL_INDICES.size() * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+	}
+
+	HostBuffer CullTest::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage)
+	{
+		HostBuffer result;
+
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = size;
+		bufferInfo.usage = usage;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		if (vkCreateBuffer(m_Device, &bufferInfo, nullptr, &result.buffer) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Error: Failed to create a buffer!");
+		}
+
+		VkMemoryRequirements requirements;
+		vkGetBufferMemoryRequirements(m_Device, result.buffer, &requirements);
+
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &memoryProperties);
+
+		// Host coherent memory keeps the test free of staging copies and flushes
+		const VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		uint32_t memoryType = UINT32_MAX;
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+		{
+			if ((requirements.memoryTypeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & flags) == flags)
+			{
+				memoryType = i;
+				break;
+			}
+		}
+		if (memoryType == UINT32_MAX)
+		{
+			throw std::runtime_error("Error: No host coherent memory type!");
+		}
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = requirements.size;
+		allocInfo.memoryTypeIndex = memoryType;
+		if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &result.memory) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Error: Failed to allocate buffer memory!");
+		}
+
+		vkBindBufferMemory(m_Device, result.buffer, result.memory, 0);
+		vkMapMemory(m_Device, result.memory, 0, VK_WHOLE_SIZE, 0, &result.data);
+		return result;
+	}
+
+	void CullTest::CreatePipeline(const std::string& shaderPath)
+	{
+		// Same bindings and push constant range as MeshletCuller
+		std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+		for (uint32_t i = 0; i < bindings.size(); i++)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+
+		VkDescriptorSetLayoutCreateInfo setLayoutInfo{};
+		setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		setLayoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		setLayoutInfo.pBindings = bindings.data();
+		vkCreateDescriptorSetLayout(m_Device, &setLayoutInfo, nullptr, &m_DescriptorSetLayout);
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.size = sizeof(CullParams);
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &pushConstantRange;
+		vkCreatePipelineLayout(m_Device, &layoutInfo, nullptr, &m_PipelineLayout);
+
+		std::ifstream shaderFile(shaderPath, std::ios::ate | std::ios::binary);
+		if (!shaderFile.is_open())
+		{
+			throw std::runtime_error("Error: Failed to open " + shaderPath);
+		}
+		std::vector<uint32_t> shaderCode(static_cast<size_t>(shaderFile.tellg()) / sizeof(uint32_t));
+		shaderFile.seekg(0);
+		shaderFile.read(reinterpret_cast<char*>(shaderCode.data()), shaderCode.size() * sizeof(uint32_t));
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.size() * sizeof(uint32_t);
+		moduleInfo.pCode = shaderCode.data();
+
+		VkShaderModule shaderModule;
+		if (vkCreateShaderModule(m_Device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Error: Failed to create the shader module!");
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(m_Device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline);
+		vkDestroyShaderModule(m_Device, shaderModule, nullptr);
+		if (result != VK_SUCCESS)
+		{
+			throw std::runtime_error("Error: Failed to create the meshlet culling pipeline!");
+		}
+	}
+
+	void CullTest::Dispatch(const CullParams& params, uint32_t meshletCount)
+	{
+		VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 };
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.maxSets = 1;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+		vkCreateDescriptorPool(m_Device, &poolInfo, nullptr, &m_DescriptorPool);
+
+		VkDescriptorSetAllocateInfo setInfo{};
+		setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		setInfo.descriptorPool = m_DescriptorPool;
+		setInfo.descriptorSetCount = 1;
+		setInfo.pSetLayouts = &m_DescriptorSetLayout;
+
+		VkDescriptorSet descriptorSet;
+		vkAllocateDescriptorSets(m_Device, &setInfo, &descriptorSet);
+
+		std::array<VkDescriptorBufferInfo, 4> bufferInfos{};
+		bufferInfos[0] = { m_Meshlets.buffer, 0, VK_WHOLE_SIZE };
+		bufferInfos[1] = { m_Draws.buffer, 0, VK_WHOLE_SIZE };
+		bufferInfos[2] = { m_Counters.buffer, 0, VK_WHOLE_SIZE };
+		bufferInfos[3] = { m_Materials.buffer, 0, VK_WHOLE_SIZE };
+
+		std::array<VkWriteDescriptorSet, 4> writes{};
+		for (uint32_t binding = 0; binding < writes.size(); binding++)
+		{
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = descriptorSet;
+			writes[binding].dstBinding = binding;
+			writes[binding].descriptorCount = 1;
+			writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[binding].pBufferInfo = &bufferInfos[binding];
+		}
+		vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+		VkCommandPoolCreateInfo commandPoolInfo{};
+		commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		commandPoolInfo.queueFamilyIndex = m_QueueFamily;
+		vkCreateCommandPool(m_Device, &commandPoolInfo, nullptr, &m_CommandPool);
+
+		VkCommandBufferAllocateInfo commandBufferInfo{};
+		commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		commandBufferInfo.commandPool = m_CommandPool;
+		commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		commandBufferInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer;
+		vkAllocateCommandBuffers(m_Device, &commandBufferInfo, &commandBuffer);
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+		// Same clears, table upload and barriers as MeshletCuller::Cull
+		vkCmdFillBuffer(commandBuffer, m_Draws.buffer, 0, DRAW_CAPACITY * sizeof(VkDrawIndexedIndirectCommand), 0);
+		vkCmdFillBuffer(commandBuffer, m_Counters.buffer, 0, 4 * sizeof(uint32_t), 0);
+		vkCmdUpdateBuffer(commandBuffer, m_Materials.buffer, 0, MATERIAL_INDICES.size() * sizeof(uint32_t), MATERIAL_INDICES.data());
+
+		VkMemoryBarrier fillBarrier{};
+		fillBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		fillBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		fillBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &fillBarrier, 0, nullptr, 0, nullptr);
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+		vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+		vkCmdDispatch(commandBuffer, (meshletCount + 63) / 64, 1, 1);
+
+		VkMemoryBarrier hostBarrier{};
+		hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		hostBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+
+		vkEndCommandBuffer(commandBuffer);
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+		if (vkQueueSubmit(m_Queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Error: Failed to submit the culling dispatch!");
+		}
+		vkQueueWaitIdle(m_Queue);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string shaderPath = argc > 1 ? argv[1] : "Res/Shaders/meshletcullcomp.spv";
+
+	try
+	{
+		VE::CullTest test;
+		test.Run(shaderPath);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	std::cout << "Meshlet culling test passed" << std::endl;
+	return 0;
+}
@@ -4,9 +4,14 @@
 #include "glm/gtx/transform.hpp"
 
 #include "Model.hpp"
+#include "AssetLoader.hpp"
 #include "Texture.hpp"
 
+#include "Descriptor/DescriptorWriter.hpp"
+
 #include <iostream>
+#include <vector>
+#include <string>
 
 namespace VE
 {
@@ -18,19 +23,48 @@ namespace VE
 
     void Application::Run()
     {
-        // Create Descriptors here
+        // Create Descriptors here, sets come from the device's growable allocator
         m_Device.CreateDescriptorLayouts();
-        m_Device.CreateDescriptorPool(2);
 
-        Model model(&m_Device, "D:\\OpenGL Projects\\VulkanEngine\\Res\\Models\\viking_room.obj");
+        ImportSettings importSettings{};
+        importSettings.threadCount = IMPORT_THREAD_COUNT;
+        importSettings.optimize = OPTIMIZE_MESHES;
+        importSettings.vertexFormat = VERTEX_FORMAT;
+        importSettings.lodCount = MESH_LOD_COUNT;
+        importSettings.buildMeshlets = BUILD_MESHLETS;
+
+        // Loading runs in the background, the first frames are drawn while the model is still being decoded
+        AssetLoader assetLoader(&m_Device, ASSET_THREAD_COUNT, RESOURCE_CACHE_BUDGET);
+        const char* texturePath = "D:\\OpenGL Projects\\VulkanEngine\\Res\\Textures\\viking_room.png";
+        bool useVirtualTexture = VIRTUAL_TEXTURING && m_Device.HasVirtualTextureCache();
+
+        std::shared_ptr<Model> model = assetLoader.LoadModel("D:\\OpenGL Projects\\VulkanEngine\\Res\\Models\\viking_room.obj",
+            useVirtualTexture ? "" : texturePath, importSettings);
+        if (useVirtualTexture)
+        {
+            model->SetVirtualTexture(assetLoader.LoadVirtualTexture(texturePath));
+        }
 
-        Renderer renderer(&m_Window, &m_Device);
+        Renderer renderer(&m_Window, &m_Device, VERTEX_FORMAT);
 
+        std::vector<Model*> models = { model.get() };
+        double lastStatsTime = glfwGetTime();
         while(!m_Window.ShouldClose())
         {
             m_Window.PollEvents();
 
-            renderer.DrawFrame(model);
+            assetLoader.Update();
+            renderer.DrawFrame(models);
+
+            // Descriptor writes per frame should drop to zero once nothing changes, a steady count means redundant updates
+            double time = glfwGetTime();
+            if (time - lastStatsTime >= STATS_INTERVAL)
+            {
+                const DescriptorWriter& descriptorWriter = m_Device.GetDescriptorWriter();
+                m_Window.SetSubtitle("descriptor writes " + std::to_string(descriptorWriter.GetFrameWriteCount()) +
+                    " last frame, " + std::to_string(descriptorWriter.GetTotalWriteCount()) + " total");
+                lastStatsTime = time;
+            }
         }
 
         vkDeviceWaitIdle(m_Device.GetVkDevice());
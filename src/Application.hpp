@@ -20,6 +20,15 @@ namespace VE
     public:
         static constexpr int WIDTH = 1280;
         static constexpr int HEIGHT = 720;
+        static constexpr uint32_t IMPORT_THREAD_COUNT = 0; // 0 = one per hardware thread
+        static constexpr uint32_t ASSET_THREAD_COUNT = 0; // 0 = one per hardware thread besides the main thread
+        static constexpr VkDeviceSize RESOURCE_CACHE_BUDGET = 512ull * 1024 * 1024; // Unused meshes and textures are evicted above this
+        static constexpr bool OPTIMIZE_MESHES = true;
+        static constexpr VertexFormat VERTEX_FORMAT = VertexFormat::Compact;
+        static constexpr uint32_t MESH_LOD_COUNT = 4;
+        static constexpr bool BUILD_MESHLETS = true;
+        static constexpr bool VIRTUAL_TEXTURING = true; // Streams the texture page by page where the device supports it
+        static constexpr double STATS_INTERVAL = 0.5; // Seconds between updates of the stats in the window title
     private:
         Window  m_Window;
         Device  m_Device;
@@ -0,0 +1,293 @@
+#include "AssetLoader.hpp"
+
+#include "UploadContext.hpp"
+
+namespace VE
+{
+	AssetLoader::AssetLoader(Device* device, uint32_t threadCount, VkDeviceSize cacheBudget)
+		:	m_Device(device), m_ResourceCache(cacheBudget), m_PendingCount(0), m_ThreadPool(threadCount)
+	{
+	}
+
+	VkDeviceSize AssetLoader::DecodedAsset::GetUploadSize() const
+	{
+		VkDeviceSize uploadSize = texture ? textureData.GetUploadSize() : 0;
+		for (const auto& baseColor : newBaseColors)
+		{
+			uploadSize += baseColor.data.GetUploadSize();
+		}
+		if (meshSource)
+		{
+			const MeshView& view = meshSource->view;
+			VkDeviceSize indexSize = view.indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+			uploadSize +=	static_cast<VkDeviceSize>(view.vertexCount) * VertexStride(view.vertexFormat) +
+							static_cast<VkDeviceSize>(view.indexCount) * indexSize + view.meshlets.size_bytes();
+		}
+		return uploadSize;
+	}
+
+	std::shared_ptr<Model> AssetLoader::LoadModel(std::string_view modelPath, std::string_view texturePath, const ImportSettings& importSettings)
+	{
+		auto model = std::make_shared<Model>(m_Device);
+		model->SetMesh(LoadMesh(modelPath, importSettings));
+		if (!texturePath.empty())
+		{
+			model->SetTexture(LoadTexture(texturePath));
+		}
+		return model;
+	}
+
+	std::shared_ptr<Mesh> AssetLoader::LoadMesh(std::string_view filePath, const ImportSettings& importSettings)
+	{
+		// Settings that change the imported data make a different mesh
+		std::string key = ResourceCache::MakeKey(ResourceType::Mesh, filePath, importSettings.CookFlags());
+
+		bool inserted = false;
+		auto mesh = m_ResourceCache.Acquire<Mesh>(key, [this]() { return std::make_shared<Mesh>(m_Device); }, &inserted);
+
+		if (inserted)
+		{
+			auto asset = std::make_shared<DecodedAsset>();
+			asset->path = filePath;
+			asset->mesh = mesh;
+			QueueDecode(asset, [this, importSettings](DecodedAsset& decoded) { DecodeMesh(decoded, importSettings); });
+		}
+		return mesh;
+	}
+
+	std::shared_ptr<Texture> AssetLoader::LoadTexture(std::string_view filePath)
+	{
+		return AcquireTexture(filePath, nullptr);
+	}
+
+	std::vector<std::shared_ptr<Texture>> AssetLoader::LoadTextures(std::span<const std::string> filePaths)
+	{
+		auto batch = std::make_shared<DecodeBatch>();
+
+		std::vector<std::shared_ptr<Texture>> textures;
+		textures.reserve(filePaths.size());
+		for (const auto& filePath : filePaths)
+		{
+			textures.push_back(AcquireTexture(filePath, batch));
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		ReleaseBatchLocked(*batch);
+
+		return textures;
+	}
+
+	std::shared_ptr<VirtualTexture> AssetLoader::LoadVirtualTexture(std::string_view filePath)
+	{
+		std::string key = ResourceCache::MakeKey(ResourceType::VirtualTexture, filePath);
+
+		bool inserted = false;
+		auto texture = m_ResourceCache.Acquire<VirtualTexture>(key, [this]() { return std::make_shared<VirtualTexture>(m_Device); }, &inserted);
+
+		if (inserted)
+		{
+			auto asset = std::make_shared<DecodedAsset>();
+			asset->path = filePath;
+			asset->virtualTexture = texture;
+			QueueDecode(asset, [](DecodedAsset& decoded)
+			{
+				// Pages are cut from RGBA8 levels on the host, so blocks are always expanded and the chain always built
+				decoded.textureData = Texture::Decode(decoded.path);
+				Texture::DecompressBlocks(decoded.textureData);
+				Texture::GenerateMipChain(decoded.textureData);
+			});
+		}
+		return texture;
+	}
+
+	std::shared_ptr<Texture> AssetLoader::AcquireTexture(std::string_view filePath, const std::shared_ptr<DecodeBatch>& batch)
+	{
+		std::string key = ResourceCache::MakeKey(ResourceType::Texture, filePath);
+
+		bool inserted = false;
+		auto texture = m_ResourceCache.Acquire<Texture>(key, [this]() { return std::make_shared<Texture>(m_Device); }, &inserted);
+
+		if (inserted)
+		{
+			auto asset = std::make_shared<DecodedAsset>();
+			asset->path = filePath;
+			asset->texture = texture;
+			if (batch)
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				batch->remaining++;
+				asset->batch = batch;
+			}
+			QueueDecode(asset, [this](DecodedAsset& decoded)
+			{
+				decoded.textureData = Texture::Decode(decoded.path);
+				PrepareTexture(decoded.textureData);
+			});
+		}
+		return texture;
+	}
+
+	void AssetLoader::DecodeMesh(DecodedAsset& asset, const ImportSettings& importSettings)
+	{
+		asset.meshSource = Mesh::Decode(asset.path, importSettings);
+
+		const std::vector<MeshMaterial>& materials = asset.meshSource->materials;
+		asset.baseColors.resize(materials.size());
+
+		for (const auto& submesh : asset.meshSource->view.submeshes)
+		{
+			uint32_t materialIndex = submesh.material;
+			if (materialIndex >= materials.size() || !materials[materialIndex].HasBaseColor() || asset.baseColors[materialIndex])
+			{
+				continue;
+			}
+
+			// Runs on a worker, the cache lookup is thread safe. A texture seen for the first time is decoded right here
+			// and uploaded together with the mesh, embedded images are keyed by their source file and material
+			const MeshMaterial& material = materials[materialIndex];
+			bool isEmbedded = material.baseColorPath.empty();
+			std::string key = isEmbedded ?	ResourceCache::MakeKey(ResourceType::Texture, asset.path, materialIndex + 1ull) :
+											ResourceCache::MakeKey(ResourceType::Texture, material.baseColorPath);
+
+			bool inserted = false;
+			asset.baseColors[materialIndex] = m_ResourceCache.Acquire<Texture>(key, [this]() { return std::make_shared<Texture>(m_Device); }, &inserted);
+
+			if (inserted)
+			{
+				DecodedTexture& decoded = asset.newBaseColors.emplace_back();
+				decoded.texture = asset.baseColors[materialIndex];
+				decoded.data = isEmbedded ? Texture::Decode(asset.path, material.baseColorData) : Texture::Decode(material.baseColorPath);
+				PrepareTexture(decoded.data);
+			}
+		}
+	}
+
+	void AssetLoader::PrepareTexture(TextureData& data) const
+	{
+		if (!Texture::SupportsFormat(m_Device, data.format))
+		{
+			Texture::DecompressBlocks(data);
+		}
+		if (!Texture::CanBlitMipmaps(m_Device))
+		{
+			Texture::GenerateMipChain(data);
+		}
+		Texture::Stage(m_Device->GetUploadContext(), data);
+	}
+
+	void AssetLoader::QueueDecode(std::shared_ptr<DecodedAsset> asset, std::function<void(DecodedAsset&)> decode)
+	{
+		m_PendingCount++;
+
+		m_ThreadPool.Submit([this, asset, decode = std::move(decode)]()
+		{
+			try
+			{
+				decode(*asset);
+			}
+			catch (...)
+			{
+				asset->error = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (asset->batch)
+			{
+				asset->batch->decoded.push_back(asset);
+				ReleaseBatchLocked(*asset->batch);
+			}
+			else
+			{
+				m_Decoded.push_back(asset);
+			}
+		});
+	}
+
+	void AssetLoader::ReleaseBatchLocked(DecodeBatch& batch)
+	{
+		if (--batch.remaining == 0)
+		{
+			m_Decoded.insert(m_Decoded.end(), batch.decoded.begin(), batch.decoded.end());
+			batch.decoded.clear();
+		}
+	}
+
+	void AssetLoader::Update()
+	{
+		std::vector<std::shared_ptr<DecodedAsset>> decoded;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			decoded.swap(m_Decoded);
+		}
+
+		VkDeviceSize uploadedBytes = 0;
+		size_t uploadCount = 0;
+
+		for (; uploadCount < decoded.size(); uploadCount++)
+		{
+			DecodedAsset& asset = *decoded[uploadCount];
+
+			// Batch members arrive next to each other and are recorded together
+			bool continuesBatch = uploadCount > 0 && asset.batch && asset.batch == decoded[uploadCount - 1]->batch;
+			if (uploadedBytes >= UPLOAD_BUDGET && !continuesBatch)
+			{
+				break;
+			}
+
+			m_PendingCount--;
+
+			if (asset.error)
+			{
+				std::rethrow_exception(asset.error);
+			}
+
+			if (asset.mesh)
+			{
+				asset.mesh->Upload(*asset.meshSource);
+				asset.mesh->SetBaseColors(std::move(asset.baseColors));
+			}
+			for (auto& baseColor : asset.newBaseColors)
+			{
+				baseColor.texture->Create(baseColor.data);
+			}
+			if (asset.texture)
+			{
+				asset.texture->Create(asset.textureData);
+			}
+			if (asset.virtualTexture)
+			{
+				asset.virtualTexture->Create(std::move(asset.textureData));
+			}
+			uploadedBytes += asset.GetUploadSize();
+		}
+
+		// Whatever didn't fit into this frame's budget is picked up first next frame
+		if (uploadCount < decoded.size())
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Decoded.insert(m_Decoded.begin(), decoded.begin() + uploadCount, decoded.end());
+		}
+
+		if (uploadCount > 0)
+		{
+			UploadToken token = m_Device->GetUploadContext().Submit();
+			for (size_t i = 0; i < uploadCount; i++)
+			{
+				if (decoded[i]->mesh)
+				{
+					decoded[i]->mesh->SetUploadToken(token);
+				}
+				if (decoded[i]->texture)
+				{
+					decoded[i]->texture->SetUploadToken(token);
+				}
+				for (const auto& baseColor : decoded[i]->newBaseColors)
+				{
+					baseColor.texture->SetUploadToken(token);
+				}
+			}
+		}
+
+		m_ResourceCache.Trim();
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Device.hpp"
+#include "Model.hpp"
+#include "Texture.hpp"
+#include "VirtualTexture.hpp"
+#include "ThreadPool.hpp"
+#include "ResourceCache.hpp"
+
+#include "Mesh/Mesh.hpp"
+
+#include <string>
+#include <string_view>
+#include <span>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <exception>
+#include <functional>
+
+namespace VE
+{
+	// Loads meshes and textures in the background. File reads, parsing and decoding run on the thread pool,
+	// the device side work is done by Update on the main thread within a per frame upload budget.
+	// Every load goes through the resource cache, so a file requested again is shared instead of loaded twice.
+	// Returned handles are empty until their upload completes, the renderer skips models while IsReady is false.
+	class AssetLoader
+	{
+	public:
+		AssetLoader(Device* device, uint32_t threadCount = 0, VkDeviceSize cacheBudget = DEFAULT_CACHE_BUDGET);
+		~AssetLoader() = default;
+
+		AssetLoader(const AssetLoader& otherLoader) = delete;
+		AssetLoader& operator=(const AssetLoader& otherLoader) = delete;
+	public:
+		// Staging bytes recorded per Update, a single larger asset is still uploaded whole
+		static inline constexpr VkDeviceSize UPLOAD_BUDGET = 32ull * 1024 * 1024;
+		static inline constexpr VkDeviceSize DEFAULT_CACHE_BUDGET = 512ull * 1024 * 1024;
+	public:
+		// The texture is used for submeshes the mesh brings no base color texture for, it may be empty when there are none
+		std::shared_ptr<Model> LoadModel(std::string_view modelPath, std::string_view texturePath, const ImportSettings& importSettings = {});
+		std::shared_ptr<Mesh> LoadMesh(std::string_view filePath, const ImportSettings& importSettings = {});
+		std::shared_ptr<Texture> LoadTexture(std::string_view filePath);
+		// Decodes the whole batch in parallel and uploads it in one submission once the last texture is decoded,
+		// so a level's textures become ready together. The upload budget never splits a batch
+		std::vector<std::shared_ptr<Texture>> LoadTextures(std::span<const std::string> filePaths);
+		// Streamed into the device's VirtualTextureCache page by page, check Device::HasVirtualTextureCache first
+		std::shared_ptr<VirtualTexture> LoadVirtualTexture(std::string_view filePath);
+		// Uploads decoded assets as one batch and evicts unused cache entries, call once per frame from the main thread
+		void Update();
+		inline size_t GetPendingCount() const { return m_PendingCount; }
+		inline const ResourceCache& GetResourceCache() const { return m_ResourceCache; }
+	private:
+		struct DecodedAsset;
+
+		struct DecodeBatch
+		{
+			size_t										remaining = 1; // Held by LoadTextures until every member is queued
+			std::vector<std::shared_ptr<DecodedAsset>>	decoded;
+		};
+
+		struct DecodedTexture
+		{
+			std::shared_ptr<Texture>	texture;
+			TextureData					data;
+		};
+
+		struct DecodedAsset
+		{
+			std::string								path;
+			std::shared_ptr<Mesh>					mesh;
+			std::unique_ptr<MeshSource>				meshSource;
+			std::vector<std::shared_ptr<Texture>>	baseColors; // Per material of the mesh, see Mesh::SetBaseColors
+			std::vector<DecodedTexture>				newBaseColors; // Base colors seen for the first time, uploaded with the mesh
+			std::shared_ptr<Texture>				texture;
+			std::shared_ptr<VirtualTexture>			virtualTexture;
+			TextureData								textureData;
+			std::shared_ptr<DecodeBatch>			batch;
+			std::exception_ptr						error;
+
+			VkDeviceSize GetUploadSize() const;
+		};
+	private:
+		std::shared_ptr<Texture> AcquireTexture(std::string_view filePath, const std::shared_ptr<DecodeBatch>& batch);
+		void DecodeMesh(DecodedAsset& asset, const ImportSettings& importSettings);
+		// Runs on the worker, decompresses blocks the device can't sample, builds mips it can't blit and stages the result
+		void PrepareTexture(TextureData& data) const;
+		void QueueDecode(std::shared_ptr<DecodedAsset> asset, std::function<void(DecodedAsset&)> decode);
+		// Hands the batch to Update once its last member is done, m_Mutex must be held
+		void ReleaseBatchLocked(DecodeBatch& batch);
+	private:
+		Device*										m_Device;
+		ResourceCache								m_ResourceCache;
+		size_t										m_PendingCount;
+		std::vector<std::shared_ptr<DecodedAsset>>	m_Decoded; // Guarded by m_Mutex
+		std::mutex									m_Mutex;
+		ThreadPool									m_ThreadPool; // Last, so the workers are joined before the members they write to go away
+	};
+}
@@ -1,10 +1,13 @@
 #include "Buffer.hpp"
 
+#include <cassert>
+#include <cstring>
+
 namespace VE
 {
 	Buffer::Buffer(Device* device, uint64_t dataSize)
 		: m_Device(device), m_Buffer(VK_NULL_HANDLE),
-			m_DeviceMemory(VK_NULL_HANDLE), m_DataSize(dataSize)
+			m_Allocation{}, m_DataSize(dataSize)
 	{
 	}
 
@@ -14,19 +17,19 @@ namespace VE
 		{
 			vkDestroyBuffer(m_Device->GetVkDevice(), m_Buffer, nullptr);
 		}
-		if (m_DeviceMemory)
-		{
-			vkFreeMemory(m_Device->GetVkDevice(), m_DeviceMemory, nullptr);
-		}
+		m_Device->GetAllocator().Free(m_Allocation);
 	}
 
 	void Buffer::UploadData(const void* memory, const uint64_t dataSize)
 	{
 		assert(dataSize == m_DataSize);
+		assert(m_Allocation.mappedData && "Buffer memory is not host visible");
 
-		void* data;
-		vkMapMemory(this->m_Device->GetVkDevice(), m_DeviceMemory, 0, this->m_DataSize, 0, &data);
-		memcpy(data, memory, static_cast<std::size_t>(this->m_DataSize));
-		vkUnmapMemory(this->m_Device->GetVkDevice(), m_DeviceMemory);
+		memcpy(m_Allocation.mappedData, memory, static_cast<std::size_t>(this->m_DataSize));
+	}
+
+	void Buffer::AllocateMemory(VkMemoryPropertyFlags properties)
+	{
+		m_Allocation = m_Device->GetAllocator().AllocateBuffer(m_Buffer, properties);
 	}
 }
@@ -24,6 +24,25 @@ namespace VE
 		}
 	};
 
+	// Positions are unorm16 relative to the mesh bounds, the dequantization is folded into the model matrix
+	struct CompactVertex
+	{
+		uint16_t	position[4];
+		uint32_t	normal; // A2B10G10R10 unorm holding normal * 0.5 + 0.5, replaces the unused color
+		uint16_t	texCoords[2]; // Half float
+	};
+
+	enum class VertexFormat
+	{
+		Full,
+		Compact
+	};
+
+	inline uint32_t VertexStride(VertexFormat format)
+	{
+		return format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+	}
+
 	class Buffer
 	{
 	public:
@@ -31,7 +50,9 @@ namespace VE
 		virtual ~Buffer();
 	public:
 		inline VkBuffer GetVkBuffer() const { return m_Buffer; }
-		inline VkDeviceMemory GetVkDeviceMemory() const { return m_DeviceMemory; }
+		inline VkDeviceMemory GetVkDeviceMemory() const { return m_Allocation.memory; }
+		inline VkDeviceSize GetMemoryOffset() const { return m_Allocation.offset; }
+		inline void* GetMappedData() const { return m_Allocation.mappedData; }
 		inline uint64_t GetDataSize() const { return m_DataSize; }
 	public:
 		virtual void UploadData(const void* memory, const uint64_t dataSize);
@@ -39,10 +60,11 @@ namespace VE
 		virtual uint32_t GetDataCount() const = 0;
 	protected:
 		virtual void CreateBuffer() = 0;
+		void AllocateMemory(VkMemoryPropertyFlags properties);
 	protected:
 		Device*			m_Device;
 		VkBuffer		m_Buffer;
-		VkDeviceMemory	m_DeviceMemory;
+		Allocation		m_Allocation;
 		uint64_t		m_DataSize;
 	};
 }
@@ -0,0 +1,135 @@
+#include "GeometryPool.hpp"
+
+#include "Swapchain.hpp"
+#include "UploadContext.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+namespace VE
+{
+	GeometryPool::GeometryPool(Device* device)
+		:	m_Device(device)
+	{
+	}
+
+	GeometryHandle GeometryPool::Allocate(const void* vertices, uint32_t vertexCount, VertexFormat vertexFormat, const void* indices, uint32_t indexCount, VkIndexType indexType)
+	{
+		uint32_t vertexStride = VertexStride(vertexFormat);
+		uint32_t indexSize = IndexBuffer::IndexSize(indexType);
+		VkDeviceSize vertexBytes = static_cast<VkDeviceSize>(vertexCount) * vertexStride;
+		VkDeviceSize indexBytes = static_cast<VkDeviceSize>(indexCount) * indexSize;
+
+		// A page is bound with a single index type and vertexOffset counts in units of the page's vertex stride
+		GeometryHandle handle{};
+		handle.indexType = indexType;
+		handle.vertexFormat = vertexFormat;
+		for (uint32_t i = 0; i < m_Pages.size() && !handle.IsValid(); i++)
+		{
+			if (m_Pages[i].indexBuffer->GetIndexType() == indexType && m_Pages[i].vertexBuffer->GetVertexFormat() == vertexFormat)
+			{
+				TryAllocate(i, vertexBytes, indexBytes, handle);
+			}
+		}
+
+		if (!handle.IsValid())
+		{
+			CreatePage(vertexBytes, indexBytes, vertexFormat, indexType);
+			if (!TryAllocate(static_cast<uint32_t>(m_Pages.size() - 1), vertexBytes, indexBytes, handle))
+			{
+				throw std::runtime_error("Error: Mesh doesn't fit into a newly created geometry page!");
+			}
+		}
+
+		handle.vertexCount = vertexCount;
+		handle.indexCount = indexCount;
+
+		const Page& page = m_Pages[handle.page];
+		UploadContext& uploadContext = m_Device->GetUploadContext();
+		uploadContext.UploadBuffer(page.vertexBuffer->GetVkBuffer(), static_cast<VkDeviceSize>(handle.vertexOffset) * vertexStride, vertices, vertexBytes);
+		uploadContext.UploadBuffer(page.indexBuffer->GetVkBuffer(), static_cast<VkDeviceSize>(handle.firstIndex) * indexSize, indices, indexBytes);
+
+		return handle;
+	}
+
+	void GeometryPool::Free(GeometryHandle& handle)
+	{
+		if (!handle.IsValid())
+		{
+			return;
+		}
+
+		// Frames still in flight may be drawing from these ranges
+		m_PendingFrees.push_back({ handle, Swapchain::MAX_FRAMES_IN_FLIGHT });
+		handle = GeometryHandle{};
+	}
+
+	void GeometryPool::BeginFrame()
+	{
+		for (auto& pending : m_PendingFrees)
+		{
+			if (--pending.framesLeft == 0)
+			{
+				Page& page = m_Pages[pending.handle.page];
+				page.vertexRanges->Free(pending.handle.vertexRange);
+				page.indexRanges->Free(pending.handle.indexRange);
+			}
+		}
+
+		m_PendingFrees.erase(std::remove_if(m_PendingFrees.begin(), m_PendingFrees.end(), [](const PendingFree& pending)
+		{
+			return pending.framesLeft == 0;
+		}), m_PendingFrees.end());
+	}
+
+	void GeometryPool::Bind(VkCommandBuffer commandBuffer, uint32_t page) const
+	{
+		m_Pages[page].vertexBuffer->BindBuffer(commandBuffer);
+		m_Pages[page].indexBuffer->BindBuffer(commandBuffer);
+	}
+
+	bool GeometryPool::TryAllocate(uint32_t page, VkDeviceSize vertexSize, VkDeviceSize indexSize, GeometryHandle& handle)
+	{
+		Page& target = m_Pages[page];
+		uint32_t vertexStride = VertexStride(target.vertexBuffer->GetVertexFormat());
+
+		VkDeviceSize vertexOffset, indexOffset;
+		uint32_t vertexRange = target.vertexRanges->Allocate(vertexSize, vertexStride, &vertexOffset);
+		if (vertexRange == MemoryBlock::INVALID_RANGE)
+		{
+			return false;
+		}
+
+		// Index ranges stay 4 byte aligned so copies into them are always legal
+		uint32_t indexRange = target.indexRanges->Allocate(indexSize, 4, &indexOffset);
+		if (indexRange == MemoryBlock::INVALID_RANGE)
+		{
+			target.vertexRanges->Free(vertexRange);
+			return false;
+		}
+
+		handle.page = page;
+		handle.vertexRange = vertexRange;
+		handle.indexRange = indexRange;
+		handle.vertexOffset = static_cast<int32_t>(vertexOffset / vertexStride);
+		handle.firstIndex = static_cast<uint32_t>(indexOffset / IndexBuffer::IndexSize(target.indexBuffer->GetIndexType()));
+
+		return true;
+	}
+
+	void GeometryPool::CreatePage(VkDeviceSize vertexSize, VkDeviceSize indexSize, VertexFormat vertexFormat, VkIndexType indexType)
+	{
+		// Meshes that don't fit into a regular page get a page sized for them, including the padding
+		// TryAllocate may need to align the ranges to the vertex stride and to 4 bytes
+		vertexSize = std::max(VERTEX_PAGE_SIZE, vertexSize + VertexStride(vertexFormat) - 1);
+		indexSize = std::max(INDEX_PAGE_SIZE, (indexSize + 3 + 3) / 4 * 4);
+
+		Page page{};
+		page.vertexBuffer = std::make_unique<VertexBuffer>(m_Device, vertexSize, vertexFormat);
+		page.indexBuffer = std::make_unique<IndexBuffer>(m_Device, indexSize, indexType);
+		page.vertexRanges = std::make_unique<MemoryBlock>(VK_NULL_HANDLE, vertexSize, 0, 0, nullptr);
+		page.indexRanges = std::make_unique<MemoryBlock>(VK_NULL_HANDLE, indexSize, 0, 0, nullptr);
+
+		m_Pages.push_back(std::move(page));
+	}
+}
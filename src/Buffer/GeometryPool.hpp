@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "Device.hpp"
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "Memory/MemoryBlock.hpp"
+
+#include <vector>
+#include <memory>
+
+namespace VE
+{
+	struct GeometryHandle
+	{
+		uint32_t	page = UINT32_MAX;
+		uint32_t	firstIndex = 0;
+		uint32_t	indexCount = 0;
+		int32_t		vertexOffset = 0;
+		uint32_t	vertexCount = 0;
+		uint32_t	vertexRange = MemoryBlock::INVALID_RANGE;
+		uint32_t		indexRange = MemoryBlock::INVALID_RANGE;
+		VkIndexType		indexType = VK_INDEX_TYPE_UINT16;
+		VertexFormat	vertexFormat = VertexFormat::Full;
+
+		inline bool IsValid() const { return page != UINT32_MAX; }
+	};
+
+	// Suballocates the vertex and index data of every mesh from a few large buffers so the
+	// renderer can bind geometry once and draw each mesh with (firstIndex, vertexOffset).
+	class GeometryPool
+	{
+	public:
+		explicit GeometryPool(Device* device);
+		~GeometryPool() = default;
+
+		GeometryPool(const GeometryPool& otherPool) = delete;
+		GeometryPool& operator=(const GeometryPool& otherPool) = delete;
+	public:
+		static inline constexpr VkDeviceSize VERTEX_PAGE_SIZE = 32ull * 1024 * 1024;
+		static inline constexpr VkDeviceSize INDEX_PAGE_SIZE = 16ull * 1024 * 1024;
+	public:
+		GeometryHandle Allocate(const void* vertices, uint32_t vertexCount, VertexFormat vertexFormat, const void* indices, uint32_t indexCount, VkIndexType indexType);
+		void Free(GeometryHandle& handle);
+		void BeginFrame();
+		void Bind(VkCommandBuffer commandBuffer, uint32_t page) const;
+	private:
+		struct Page
+		{
+			std::unique_ptr<VertexBuffer>	vertexBuffer;
+			std::unique_ptr<IndexBuffer>	indexBuffer;
+			std::unique_ptr<MemoryBlock>	vertexRanges;
+			std::unique_ptr<MemoryBlock>	indexRanges;
+		};
+
+		struct PendingFree
+		{
+			GeometryHandle	handle;
+			uint32_t		framesLeft;
+		};
+	private:
+		bool TryAllocate(uint32_t page, VkDeviceSize vertexSize, VkDeviceSize indexSize, GeometryHandle& handle);
+		void CreatePage(VkDeviceSize vertexSize, VkDeviceSize indexSize, VertexFormat vertexFormat, VkIndexType indexType);
+	private:
+		Device*						m_Device;
+		std::vector<Page>			m_Pages;
+		std::vector<PendingFree>	m_PendingFrees;
+	};
+}
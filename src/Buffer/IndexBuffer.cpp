@@ -1,13 +1,20 @@
 #include "IndexBuffer.hpp"
 
+#include "UploadContext.hpp"
+
 namespace VE
 {
-	IndexBuffer::IndexBuffer(Device* device, uint64_t dataSize, const void* data)
-		: Buffer(device, dataSize), m_StagingBuffer(device, dataSize)
+	IndexBuffer::IndexBuffer(Device* device, uint64_t dataSize, VkIndexType indexType)
+		: Buffer(device, dataSize), m_IndexType(indexType)
+	{
+		CreateBuffer();
+	}
+
+	IndexBuffer::IndexBuffer(Device* device, uint64_t dataSize, VkIndexType indexType, const void* data)
+		: Buffer(device, dataSize), m_IndexType(indexType)
 	{
 		CreateBuffer();
-		m_StagingBuffer.UploadData(data, dataSize);
-		CopyBuffer(m_StagingBuffer.GetVkBuffer(), dataSize);
+		this->m_Device->GetUploadContext().UploadBuffer(this->m_Buffer, 0, data, dataSize);
 	}
 
 	void IndexBuffer::CreateBuffer()
@@ -20,61 +27,16 @@ namespace VE
 
 		VK_CHECK(vkCreateBuffer(this->m_Device->GetVkDevice(), &bufferInfo, nullptr, &this->m_Buffer))
 
-		VkMemoryRequirements memRequirements;
-		vkGetBufferMemoryRequirements(this->m_Device->GetVkDevice(), this->m_Buffer, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = Device::FindMemoryType(m_Device, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-		VK_CHECK(vkAllocateMemory(this->m_Device->GetVkDevice(), &allocInfo, nullptr, &m_DeviceMemory))
-		vkBindBufferMemory(this->m_Device->GetVkDevice(), this->m_Buffer, m_DeviceMemory, 0);
+		AllocateMemory(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 	}
 
 	void IndexBuffer::BindBuffer(VkCommandBuffer commandBuffer) const
 	{
-		vkCmdBindIndexBuffer(commandBuffer, this->m_Buffer, 0, VK_INDEX_TYPE_UINT16);
-	}
-
-	void IndexBuffer::CopyBuffer(VkBuffer srcBuffer, VkDeviceSize memSize)
-	{
-		VkCommandBufferAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandPool = this->m_Device->GetCommandPool();
-		allocInfo.commandBufferCount = 1;
-
-		VkCommandBuffer commandBuffer;
-		VK_CHECK(vkAllocateCommandBuffers(this->m_Device->GetVkDevice(), &allocInfo, &commandBuffer))
-
-		VkCommandBufferBeginInfo beginInfo {};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-		vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-		VkBufferCopy copyRegion{};
-		copyRegion.srcOffset = 0; // Optional
-		copyRegion.dstOffset = 0; // Optional
-		copyRegion.size = memSize;
-		vkCmdCopyBuffer(commandBuffer, srcBuffer, this->m_Buffer, 1, &copyRegion);
-
-		vkEndCommandBuffer(commandBuffer);
-
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffer;
-
-		vkQueueSubmit(this->m_Device->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(this->m_Device->GetGraphicsQueue());
-
-		vkFreeCommandBuffers(this->m_Device->GetVkDevice(), this->m_Device->GetCommandPool(), 1, &commandBuffer);
+		vkCmdBindIndexBuffer(commandBuffer, this->m_Buffer, 0, m_IndexType);
 	}
 
 	uint32_t IndexBuffer::GetDataCount() const
 	{
-		return static_cast<uint32_t>(m_DataSize / sizeof(uint16_t));
+		return static_cast<uint32_t>(m_DataSize / IndexSize(m_IndexType));
 	}
 }
@@ -1,25 +1,27 @@
 #pragma once
 
 #include "Buffer.hpp"
-#include "StagingBuffer.hpp"
 
 namespace VE
 {
 	class IndexBuffer final : public Buffer
 	{
 	public:
-		IndexBuffer(Device* device, uint64_t dataSize, const void* data);
+		IndexBuffer(Device* device, uint64_t dataSize, VkIndexType indexType);
+		IndexBuffer(Device* device, uint64_t dataSize, VkIndexType indexType, const void* data);
 
 		IndexBuffer(const IndexBuffer& otherBuffer) = delete;
 		IndexBuffer& operator=(const IndexBuffer& otherBuffer) = delete;
+	public:
+		static inline uint32_t IndexSize(VkIndexType indexType) { return indexType == VK_INDEX_TYPE_UINT32 ? sizeof(uint32_t) : sizeof(uint16_t); }
+		inline VkIndexType GetIndexType() const { return m_IndexType; }
 	public:
 		void BindBuffer(VkCommandBuffer commandBuffer) const override;
-		void CopyBuffer(VkBuffer srcBuffer, VkDeviceSize memSize);
 		uint32_t GetDataCount() const override;
 	private:
 		void CreateBuffer() override;
 	private:
-		StagingBuffer m_StagingBuffer;
+		VkIndexType m_IndexType;
 	};
 }
 
@@ -18,16 +18,7 @@ namespace VE
 
 		VK_CHECK(vkCreateBuffer(m_Device->GetVkDevice(), &bufferInfo, nullptr, &this->m_Buffer))
 
-		VkMemoryRequirements memRequirements;
-		vkGetBufferMemoryRequirements(m_Device->GetVkDevice(), this->m_Buffer, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = Device::FindMemoryType(m_Device, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-		VK_CHECK(vkAllocateMemory(m_Device->GetVkDevice(), &allocInfo, nullptr, &m_DeviceMemory))
-		vkBindBufferMemory(m_Device->GetVkDevice(), this->m_Buffer, m_DeviceMemory, 0);
+		AllocateMemory(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 	}
 
 	void StagingBuffer::BindBuffer(VkCommandBuffer commandBuffer) const
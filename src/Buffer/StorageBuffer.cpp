@@ -0,0 +1,32 @@
+#include "StorageBuffer.hpp"
+
+namespace VE
+{
+	StorageBuffer::StorageBuffer(Device* device, uint64_t dataSize, VkBufferUsageFlags extraUsage, VkMemoryPropertyFlags memoryProperties)
+		: Buffer(device, dataSize), m_ExtraUsage(extraUsage), m_MemoryProperties(memoryProperties)
+	{
+		CreateBuffer();
+	}
+
+	void StorageBuffer::CreateBuffer()
+	{
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = this->m_DataSize;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | m_ExtraUsage;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VK_CHECK(vkCreateBuffer(this->m_Device->GetVkDevice(), &bufferInfo, nullptr, &this->m_Buffer))
+
+		AllocateMemory(m_MemoryProperties);
+	}
+
+	void StorageBuffer::BindBuffer(VkCommandBuffer commandBuffer) const
+	{
+	}
+
+	uint32_t StorageBuffer::GetDataCount() const
+	{
+		return 1;
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Buffer.hpp"
+
+namespace VE
+{
+	// Buffer written by transfers or shaders, extraUsage adds e.g. VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT.
+	// Device local unless other memory properties are asked for, host visible ones can be read back through GetMappedData
+	class StorageBuffer final : public Buffer
+	{
+	public:
+		StorageBuffer(Device* device, uint64_t dataSize, VkBufferUsageFlags extraUsage = 0,
+			VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		StorageBuffer(const StorageBuffer& otherBuffer) = delete;
+		StorageBuffer& operator=(const StorageBuffer& otherBuffer) = delete;
+	public:
+		void BindBuffer(VkCommandBuffer commandBuffer) const override;
+		uint32_t GetDataCount() const override;
+	private:
+		void CreateBuffer() override;
+	private:
+		VkBufferUsageFlags		m_ExtraUsage;
+		VkMemoryPropertyFlags	m_MemoryProperties;
+	};
+}
@@ -0,0 +1,40 @@
+#include "UniformRing.hpp"
+
+#include "Swapchain.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace VE
+{
+	UniformRing::UniformRing(Device* device, VkDeviceSize frameSize)
+		:	m_FrameSize(frameSize), m_Alignment(1), m_FrameBegin(0), m_Head(0)
+	{
+		m_Alignment = device->GetProperties().limits.minUniformBufferOffsetAlignment;
+		m_FrameSize = (m_FrameSize + m_Alignment - 1) / m_Alignment * m_Alignment;
+
+		m_Buffer = std::make_unique<UniformBuffer>(device, m_FrameSize * Swapchain::MAX_FRAMES_IN_FLIGHT);
+	}
+
+	void UniformRing::BeginFrame(const uint32_t frame)
+	{
+		// The frame's fence has been waited on, so everything in its region can be overwritten
+		m_FrameBegin = m_FrameSize * frame;
+		m_Head = m_FrameBegin;
+	}
+
+	uint32_t UniformRing::Push(const void* data, const VkDeviceSize dataSize)
+	{
+		VkDeviceSize offset = (m_Head + m_Alignment - 1) / m_Alignment * m_Alignment;
+
+		if (offset + dataSize > m_FrameBegin + m_FrameSize)
+		{
+			throw std::runtime_error("Error: Uniform ring is out of space for this frame!");
+		}
+
+		memcpy(static_cast<char*>(m_Buffer->GetMappedData()) + offset, data, static_cast<std::size_t>(dataSize));
+		m_Head = offset + dataSize;
+
+		return static_cast<uint32_t>(offset);
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "Device.hpp"
+#include "UniformBuffer.hpp"
+
+#include <memory>
+
+namespace VE
+{
+	// One persistently mapped uniform buffer split into a region per frame in flight.
+	// Callers suballocate aligned chunks every frame and bind them through dynamic offsets.
+	class UniformRing
+	{
+	public:
+		UniformRing(Device* device, VkDeviceSize frameSize);
+		~UniformRing() = default;
+
+		UniformRing(const UniformRing& otherRing) = delete;
+		UniformRing& operator=(const UniformRing& otherRing) = delete;
+	public:
+		inline VkBuffer GetVkBuffer() const { return m_Buffer->GetVkBuffer(); }
+	public:
+		void BeginFrame(const uint32_t frame);
+		uint32_t Push(const void* data, const VkDeviceSize dataSize);
+	private:
+		std::unique_ptr<UniformBuffer>	m_Buffer;
+		VkDeviceSize					m_FrameSize;
+		VkDeviceSize					m_Alignment;
+		VkDeviceSize					m_FrameBegin;
+		VkDeviceSize					m_Head;
+	};
+}
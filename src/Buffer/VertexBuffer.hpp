@@ -1,25 +1,26 @@
 #pragma once
 
 #include "Buffer.hpp"
-#include "StagingBuffer.hpp"
 
 namespace VE
 {
 	class VertexBuffer final : public Buffer
 	{
 	public:
-		VertexBuffer(Device* device, uint64_t dataSize, const void* data);
+		VertexBuffer(Device* device, uint64_t dataSize, VertexFormat vertexFormat);
+		VertexBuffer(Device* device, uint64_t dataSize, VertexFormat vertexFormat, const void* data);
 
 		VertexBuffer(const VertexBuffer& otherBuffer) = delete;
 		VertexBuffer& operator=(const VertexBuffer& otherBuffer) = delete;
+	public:
+		inline VertexFormat GetVertexFormat() const { return m_VertexFormat; }
 	public:
 		void BindBuffer(VkCommandBuffer commandBuffer) const override;
-		void CopyBuffer(VkBuffer srcBuffer, VkDeviceSize memSize);
 		uint32_t GetDataCount() const override;
 	private:
 		void CreateBuffer() override;
 	private:
-		StagingBuffer m_StagingBuffer;
+		VertexFormat m_VertexFormat;
 	};
 }
 
@@ -0,0 +1,137 @@
+#include "BindlessTextureArray.hpp"
+
+#include "Utilities.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+namespace VE
+{
+	BindlessTextureArray::BindlessTextureArray(Device* device)
+		:	m_Device(device), m_DescriptorSetLayout(VK_NULL_HANDLE), m_DescriptorPool(VK_NULL_HANDLE),
+			m_DescriptorSet(VK_NULL_HANDLE), m_Capacity(0), m_NextIndex(0)
+	{
+		const VkPhysicalDeviceDescriptorIndexingPropertiesEXT& limits = m_Device->GetDescriptorIndexingProperties();
+		m_Capacity = std::min({ MAX_TEXTURES,
+			limits.maxDescriptorSetUpdateAfterBindSampledImages, limits.maxDescriptorSetUpdateAfterBindSamplers,
+			limits.maxPerStageDescriptorUpdateAfterBindSampledImages, limits.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+		CreateDescriptorSetLayout();
+		CreateDescriptorSet();
+	}
+
+	BindlessTextureArray::~BindlessTextureArray()
+	{
+		vkDestroyDescriptorPool(m_Device->GetVkDevice(), m_DescriptorPool, nullptr);
+		vkDestroyDescriptorSetLayout(m_Device->GetVkDevice(), m_DescriptorSetLayout, nullptr);
+	}
+
+	bool BindlessTextureArray::IsSupported(Device* device)
+	{
+		const VkPhysicalDeviceDescriptorIndexingFeaturesEXT& features = device->GetDescriptorIndexingFeatures();
+		return	device->GetEnabledFeatures().shaderSampledImageArrayDynamicIndexing &&
+				device->GetEnabledFeatures().drawIndirectFirstInstance &&
+				features.runtimeDescriptorArray &&
+				features.descriptorBindingPartiallyBound &&
+				features.descriptorBindingSampledImageUpdateAfterBind;
+	}
+
+	uint32_t BindlessTextureArray::Register(VkImageView imageView, VkSampler sampler)
+	{
+		uint32_t index;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (!m_FreeIndices.empty())
+			{
+				index = m_FreeIndices.back();
+				m_FreeIndices.pop_back();
+			}
+			else if (m_NextIndex < m_Capacity)
+			{
+				index = m_NextIndex++;
+			}
+			else
+			{
+				throw std::runtime_error("Error: Bindless texture array is full!");
+			}
+		}
+
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.sampler = sampler;
+		imageInfo.imageView = imageView;
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkWriteDescriptorSet writeDescriptorSet{};
+		writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSet.dstSet = m_DescriptorSet;
+		writeDescriptorSet.dstBinding = 0;
+		writeDescriptorSet.dstArrayElement = index;
+		writeDescriptorSet.descriptorCount = 1;
+		writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writeDescriptorSet.pImageInfo = &imageInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetVkDevice(), 1, &writeDescriptorSet, 0, nullptr);
+		return index;
+	}
+
+	void BindlessTextureArray::Unregister(uint32_t index)
+	{
+		// Partially bound, so the stale descriptor can stay until the slot is written again
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_FreeIndices.push_back(index);
+	}
+
+	void BindlessTextureArray::Bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t set) const
+	{
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, set, 1, &m_DescriptorSet, 0, nullptr);
+	}
+
+	void BindlessTextureArray::CreateDescriptorSetLayout()
+	{
+		VkDescriptorSetLayoutBinding binding{};
+		binding.binding = 0;
+		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		binding.descriptorCount = m_Capacity;
+		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		VkDescriptorBindingFlagsEXT bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT;
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo{};
+		bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+		bindingFlagsInfo.bindingCount = 1;
+		bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.pNext = &bindingFlagsInfo;
+		layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &binding;
+
+		VK_CHECK(vkCreateDescriptorSetLayout(m_Device->GetVkDevice(), &layoutInfo, nullptr, &m_DescriptorSetLayout))
+	}
+
+	void BindlessTextureArray::CreateDescriptorSet()
+	{
+		VkDescriptorPoolSize poolSize{};
+		poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		poolSize.descriptorCount = m_Capacity;
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+		poolInfo.maxSets = 1;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+
+		VK_CHECK(vkCreateDescriptorPool(m_Device->GetVkDevice(), &poolInfo, nullptr, &m_DescriptorPool))
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_DescriptorSetLayout;
+
+		VK_CHECK(vkAllocateDescriptorSets(m_Device->GetVkDevice(), &allocInfo, &m_DescriptorSet))
+	}
+}
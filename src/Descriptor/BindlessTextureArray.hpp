@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "Device.hpp"
+
+#include <vector>
+#include <mutex>
+
+namespace VE
+{
+	// One partially bound, update after bind array of combined image samplers that every texture registers into.
+	// Shaders index it with the draw's first instance, see Model::GetMaterialIndex, so draws with different textures
+	// need no state change in between and the array is bound once per pipeline switch. Needs VK_EXT_descriptor_indexing
+	// and drawIndirectFirstInstance, see IsSupported.
+	class BindlessTextureArray
+	{
+	public:
+		explicit BindlessTextureArray(Device* device);
+		~BindlessTextureArray();
+
+		BindlessTextureArray(const BindlessTextureArray& otherArray) = delete;
+		BindlessTextureArray& operator=(const BindlessTextureArray& otherArray) = delete;
+	public:
+		static inline constexpr uint32_t MAX_TEXTURES = 4096;
+		static inline constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+	public:
+		static bool IsSupported(Device* device);
+		// Writes the descriptor right away, update after bind lets this happen while earlier frames are in flight
+		uint32_t Register(VkImageView imageView, VkSampler sampler);
+		// The slot is reused by later textures, the caller makes sure no frame in flight still samples it
+		void Unregister(uint32_t index);
+		void Bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t set) const;
+		inline VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+		// MAX_TEXTURES clamped to the device's update after bind limits
+		inline uint32_t GetCapacity() const { return m_Capacity; }
+	private:
+		void CreateDescriptorSetLayout();
+		void CreateDescriptorSet();
+	private:
+		Device*					m_Device;
+		VkDescriptorSetLayout	m_DescriptorSetLayout;
+		VkDescriptorPool		m_DescriptorPool;
+		VkDescriptorSet			m_DescriptorSet;
+		uint32_t				m_Capacity;
+		uint32_t				m_NextIndex;
+		std::vector<uint32_t>	m_FreeIndices;
+		std::mutex				m_Mutex;
+	};
+}
@@ -0,0 +1,116 @@
+#include "DescriptorAllocator.hpp"
+
+#include "Utilities.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <algorithm>
+
+namespace VE
+{
+	// Descriptors reserved per set, covers the model, meshlet culling and virtual texture layouts
+	static constexpr std::array<VkDescriptorPoolSize, 4> DESCRIPTORS_PER_SET =
+	{{
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 },
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 }
+	}};
+
+	DescriptorAllocator::DescriptorAllocator(VkDevice device, bool isTransient)
+		:	m_Device(device), m_IsTransient(isTransient), m_CurrentPool(0), m_SetsPerPool(INITIAL_SETS_PER_POOL)
+	{
+	}
+
+	DescriptorAllocator::~DescriptorAllocator()
+	{
+		for (VkDescriptorPool pool : m_Pools)
+		{
+			vkDestroyDescriptorPool(m_Device, pool, nullptr);
+		}
+	}
+
+	VkDescriptorPool DescriptorAllocator::Allocate(std::span<const VkDescriptorSetLayout> layouts, VkDescriptorSet* sets)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+		allocInfo.pSetLayouts = layouts.data();
+
+		// Sets freed by long lived allocators leave room in earlier pools, so every pool is tried before growing.
+		// The error for a full pool differs between drivers without VK_KHR_maintenance1, any failure counts as full
+		for (size_t i = 0; i < m_Pools.size(); i++)
+		{
+			size_t poolIndex = (m_CurrentPool + i) % m_Pools.size();
+			allocInfo.descriptorPool = m_Pools[poolIndex];
+			if (vkAllocateDescriptorSets(m_Device, &allocInfo, sets) == VK_SUCCESS)
+			{
+				m_CurrentPool = poolIndex;
+				return m_Pools[poolIndex];
+			}
+		}
+
+		allocInfo.descriptorPool = CreatePool();
+		if (vkAllocateDescriptorSets(m_Device, &allocInfo, sets) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Error: Descriptor sets don't fit into an empty descriptor pool!");
+		}
+
+		m_CurrentPool = m_Pools.size() - 1;
+		return allocInfo.descriptorPool;
+	}
+
+	VkDescriptorSet DescriptorAllocator::Allocate(VkDescriptorSetLayout layout)
+	{
+		VkDescriptorSet set;
+		Allocate(std::span<const VkDescriptorSetLayout>(&layout, 1), &set);
+		return set;
+	}
+
+	void DescriptorAllocator::Free(VkDescriptorPool pool, std::span<const VkDescriptorSet> sets)
+	{
+		if (m_IsTransient)
+		{
+			throw std::runtime_error("Error: Transient descriptor sets are released by Reset!");
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		VK_CHECK(vkFreeDescriptorSets(m_Device, pool, static_cast<uint32_t>(sets.size()), sets.data()))
+	}
+
+	void DescriptorAllocator::Reset()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (VkDescriptorPool pool : m_Pools)
+		{
+			VK_CHECK(vkResetDescriptorPool(m_Device, pool, 0))
+		}
+		m_CurrentPool = 0;
+	}
+
+	VkDescriptorPool DescriptorAllocator::CreatePool()
+	{
+		std::array<VkDescriptorPoolSize, DESCRIPTORS_PER_SET.size()> poolSizes = DESCRIPTORS_PER_SET;
+		for (VkDescriptorPoolSize& poolSize : poolSizes)
+		{
+			poolSize.descriptorCount *= m_SetsPerPool;
+		}
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = m_IsTransient ? 0 : VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+		poolInfo.maxSets = m_SetsPerPool;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.pPoolSizes = poolSizes.data();
+
+		VkDescriptorPool pool;
+		VK_CHECK(vkCreateDescriptorPool(m_Device, &poolInfo, nullptr, &pool))
+
+		m_Pools.push_back(pool);
+		m_SetsPerPool = std::min(m_SetsPerPool * 2, MAX_SETS_PER_POOL);
+		return pool;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <span>
+#include <mutex>
+
+namespace VE
+{
+	// Hands out descriptor sets from a chain of pools and adds a larger pool whenever the existing ones run out.
+	// Long lived allocators free sets one by one, transient ones can't and are reset as a whole instead, the
+	// device keeps one transient allocator per frame in flight for sets that only live for that frame.
+	class DescriptorAllocator
+	{
+	public:
+		DescriptorAllocator(VkDevice device, bool isTransient);
+		~DescriptorAllocator();
+
+		DescriptorAllocator(const DescriptorAllocator& otherAllocator) = delete;
+		DescriptorAllocator& operator=(const DescriptorAllocator& otherAllocator) = delete;
+	public:
+		static inline constexpr uint32_t INITIAL_SETS_PER_POOL = 32;
+		static inline constexpr uint32_t MAX_SETS_PER_POOL = 1024;
+	public:
+		// Allocates one set per layout from a single pool and returns that pool, Free needs it
+		VkDescriptorPool Allocate(std::span<const VkDescriptorSetLayout> layouts, VkDescriptorSet* sets);
+		VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+		// Long lived allocators only
+		void Free(VkDescriptorPool pool, std::span<const VkDescriptorSet> sets);
+		// Transient allocators only, every set handed out since the last reset must be out of use
+		void Reset();
+		inline size_t GetPoolCount() const { return m_Pools.size(); }
+	private:
+		VkDescriptorPool CreatePool();
+	private:
+		VkDevice						m_Device;
+		bool							m_IsTransient;
+		std::vector<VkDescriptorPool>	m_Pools;
+		size_t							m_CurrentPool; // Tried first, the one the last allocation succeeded in
+		uint32_t						m_SetsPerPool; // Of the next pool, doubles up to MAX_SETS_PER_POOL
+		std::mutex						m_Mutex;
+	};
+}
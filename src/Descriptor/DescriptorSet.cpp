@@ -1,18 +1,22 @@
 #include "DescriptorSet.hpp"
 
-#include "Buffer/UniformBuffer.hpp"
+#include "DescriptorWriter.hpp"
+#include "DescriptorAllocator.hpp"
+
+#include "Buffer/UniformRing.hpp"
 
 #include "Swapchain.hpp"
 
 #include "Utilities.hpp"
 
 #include <vector>
+#include <cassert>
 #include <iostream>
 
 namespace VE
 {
 	DescriptorSet::DescriptorSet(Device* device)
-		:	m_Device(device)
+		:	m_Device(device), m_DescriptorPool(VK_NULL_HANDLE)
 	{
 	}
 
@@ -20,7 +24,11 @@ namespace VE
 	{
 		if (!m_DescriptorSets.empty())
 		{
-			vkFreeDescriptorSets(m_Device->GetVkDevice(), m_Device->GetDescriptorPool(), m_DescriptorSets.size(), m_DescriptorSets.data());
+			for (VkDescriptorSet set : m_DescriptorSets)
+			{
+				m_Device->GetDescriptorWriter().Forget(set);
+			}
+			m_Device->GetDescriptorAllocator().Free(m_DescriptorPool, m_DescriptorSets);
 		}
 	}
 
@@ -28,50 +36,41 @@ namespace VE
 	{
 		for (size_t i = 0; i < Swapchain::MAX_FRAMES_IN_FLIGHT; i++)
 		{
-			size_t k = 0;
-			for (size_t j = 0; j < Device::NUM_UNIFORMS; j++)
-			{
-				m_DescriptorBuffers.insert({ Key((uint32_t)i, (uint32_t)k), std::make_unique<UniformBuffer>(m_Device, sizeof(GlobalUniform)) });
-				k++;
-			}
+			size_t k = Device::NUM_UNIFORMS;
 			for (size_t j = 0; j < Device::NUM_SAMPLERS; j++)
 			{
-				m_DescriptorImages.insert({ Key((uint32_t)i, (uint32_t)k), std::make_unique<Texture>(m_Device) });
+				m_DescriptorImages.insert({ Key((uint32_t)i, (uint32_t)k), nullptr });
 				k++;
 			}
 		}
 
 		m_DescriptorSets.resize(m_Device->GetDescriptorSetLayouts().size());
+		m_DescriptorPool = m_Device->GetDescriptorAllocator().Allocate(m_Device->GetDescriptorSetLayouts(), m_DescriptorSets.data());
+
+		// Uniform bindings all point at the shared ring, only their dynamic offsets change per draw
+		m_DynamicOffsets.resize(m_DescriptorSets.size());
+		for (size_t i = 0; i < m_DescriptorSets.size(); i++)
+		{
+			m_DynamicOffsets[i].fill(0);
 
-		VkDescriptorSetAllocateInfo descriptorSetAllocInfo{};
-		descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		descriptorSetAllocInfo.descriptorPool = m_Device->GetDescriptorPool();
-		descriptorSetAllocInfo.descriptorSetCount = static_cast<uint32_t>(m_DescriptorSets.size());
-		descriptorSetAllocInfo.pSetLayouts = m_Device->GetDescriptorSetLayouts().data();
+			for (uint32_t j = 0; j < Device::NUM_UNIFORMS; j++)
+			{
+				VkDescriptorBufferInfo bufferInfo{};
+				bufferInfo.buffer = m_Device->GetUniformRing().GetVkBuffer();
+				bufferInfo.offset = 0;
+				bufferInfo.range = sizeof(GlobalUniform);
 
-		VK_CHECK(vkAllocateDescriptorSets(m_Device->GetVkDevice(), &descriptorSetAllocInfo, m_DescriptorSets.data()))
+				m_Device->GetDescriptorWriter().WriteBuffer(m_DescriptorSets[i], j, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, bufferInfo);
+			}
+		}
 	}
 
 	void DescriptorSet::UpdateBuffer(const uint32_t set, const uint32_t binding, const void* data, const uint64_t dataSize)
 	{
-		size_t loc = Key(set, binding);
-		m_DescriptorBuffers.at(loc)->UploadData(data, dataSize);
-
-		VkDescriptorBufferInfo bufferInfo{};
-		bufferInfo.buffer = m_DescriptorBuffers.at(loc)->GetVkBuffer();
-		bufferInfo.offset = 0;
-		bufferInfo.range = m_DescriptorBuffers.at(loc)->GetDataSize();
-
-		VkWriteDescriptorSet writeDescriptorSet{};
-		writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		writeDescriptorSet.dstSet = m_DescriptorSets[set];
-		writeDescriptorSet.dstBinding = binding;
-		writeDescriptorSet.dstArrayElement = 0;
-		writeDescriptorSet.descriptorCount = 1;
-		writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		writeDescriptorSet.pBufferInfo = &bufferInfo;
-
-		vkUpdateDescriptorSets(m_Device->GetVkDevice(), 1, &writeDescriptorSet, 0, nullptr);
+		assert(binding < Device::NUM_UNIFORMS);
+		assert(dataSize <= sizeof(GlobalUniform));
+
+		m_DynamicOffsets[set][binding] = m_Device->GetUniformRing().Push(data, dataSize);
 	}
 
 	void DescriptorSet::UpdateImage(const uint32_t set, const uint32_t binding)
@@ -83,27 +82,20 @@ namespace VE
 		imageInfo.imageView = m_DescriptorImages.at(loc)->GetImageView();
 		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-		VkWriteDescriptorSet writeDescriptorSet{};
-		writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		writeDescriptorSet.dstSet = m_DescriptorSets[set];
-		writeDescriptorSet.dstBinding = binding;
-		writeDescriptorSet.dstArrayElement = 0;
-		writeDescriptorSet.descriptorCount = 1;
-		writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		writeDescriptorSet.pImageInfo = &imageInfo;
-
-		vkUpdateDescriptorSets(m_Device->GetVkDevice(), 1, &writeDescriptorSet, 0, nullptr);
+		// Only queued when the texture changed, the writer issues it before the frame binds any set
+		m_Device->GetDescriptorWriter().WriteImage(m_DescriptorSets[set], binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, imageInfo);
 	}
 
-	void DescriptorSet::SetTexture(const uint32_t set, const uint32_t binding, std::string_view filePath)
+	void DescriptorSet::SetTexture(const uint32_t set, const uint32_t binding, std::shared_ptr<Texture> texture)
 	{
 		size_t loc = Key(set, binding);
-		m_DescriptorImages.at(loc)->Create(filePath);
+		m_DescriptorImages.at(loc) = std::move(texture);
 	}
 
 	void DescriptorSet::Bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, const uint32_t set)
 	{
-		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &m_DescriptorSets[set], 0, 0);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &m_DescriptorSets[set],
+			static_cast<uint32_t>(m_DynamicOffsets[set].size()), m_DynamicOffsets[set].data());
 	}
 
 	size_t DescriptorSet::Key(const uint32_t i, const uint32_t j) const
@@ -1,11 +1,12 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
 
 #include "Device.hpp"
 #include "Texture.hpp"
-#include "Buffer/UniformBuffer.hpp"
 
+#include <array>
 #include <memory>
 #include <unordered_map>
 
@@ -19,8 +20,7 @@ namespace VE
 		std::vector<VkDescriptorBufferInfo> bufferInfos;
 	};
 
-	using BufferMap = std::unordered_map<size_t, std::unique_ptr<Buffer>>;
-	using TextureMap = std::unordered_map<size_t, std::unique_ptr<Texture>>;
+	using TextureMap = std::unordered_map<size_t, std::shared_ptr<Texture>>;
 
 	class DescriptorSet
 	{
@@ -37,15 +37,18 @@ namespace VE
 	public:
 		void Create();
 		void UpdateBuffer(const uint32_t set, const uint32_t binding, const void* data, const uint64_t dataSize);
+		// Cheap to call every frame, see DescriptorWriter
 		void UpdateImage(const uint32_t set, const uint32_t binding);
-		void SetTexture(const uint32_t set, const uint32_t binding, std::string_view filePath);
+		// Textures are shared, see ResourceCache
+		void SetTexture(const uint32_t set, const uint32_t binding, std::shared_ptr<Texture> texture);
 		void Bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, const uint32_t set);
 	private:
 		size_t Key(const uint32_t i, const uint32_t j) const;
 	private:
 		Device*								m_Device;
 		std::vector<VkDescriptorSet>		m_DescriptorSets;
-		BufferMap							m_DescriptorBuffers;
+		VkDescriptorPool					m_DescriptorPool; // The allocator pool all sets came from
+		std::vector<std::array<uint32_t, Device::NUM_UNIFORMS>> m_DynamicOffsets;
 		TextureMap							m_DescriptorImages;
 	};
 }
@@ -0,0 +1,101 @@
+#include "DescriptorWriter.hpp"
+
+#include <algorithm>
+
+namespace VE
+{
+	static bool operator==(const VkDescriptorImageInfo& a, const VkDescriptorImageInfo& b)
+	{
+		return a.sampler == b.sampler && a.imageView == b.imageView && a.imageLayout == b.imageLayout;
+	}
+
+	static bool operator==(const VkDescriptorBufferInfo& a, const VkDescriptorBufferInfo& b)
+	{
+		return a.buffer == b.buffer && a.offset == b.offset && a.range == b.range;
+	}
+
+	DescriptorWriter::DescriptorWriter(VkDevice device)
+		:	m_Device(device), m_FrameWriteCount(0), m_TotalWriteCount(0)
+	{
+	}
+
+	void DescriptorWriter::WriteImage(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, const VkDescriptorImageInfo& imageInfo)
+	{
+		Update(set, binding, type, imageInfo, VkDescriptorBufferInfo{});
+	}
+
+	void DescriptorWriter::WriteBuffer(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, const VkDescriptorBufferInfo& bufferInfo)
+	{
+		Update(set, binding, type, VkDescriptorImageInfo{}, bufferInfo);
+	}
+
+	void DescriptorWriter::Forget(VkDescriptorSet set)
+	{
+		m_Sets.erase(set);
+		m_PendingSets.erase(std::remove(m_PendingSets.begin(), m_PendingSets.end(), set), m_PendingSets.end());
+	}
+
+	void DescriptorWriter::Flush()
+	{
+		m_Writes.clear();
+		for (VkDescriptorSet set : m_PendingSets)
+		{
+			for (BindingState& state : m_Sets.at(set))
+			{
+				if (!state.isPending)
+				{
+					continue;
+				}
+				state.isPending = false;
+
+				VkWriteDescriptorSet write{};
+				write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				write.dstSet = set;
+				write.dstBinding = state.binding;
+				write.dstArrayElement = 0;
+				write.descriptorCount = 1;
+				write.descriptorType = state.type;
+				write.pImageInfo = &state.imageInfo;
+				write.pBufferInfo = &state.bufferInfo;
+				m_Writes.push_back(write);
+			}
+		}
+		m_PendingSets.clear();
+
+		if (!m_Writes.empty())
+		{
+			vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(m_Writes.size()), m_Writes.data(), 0, nullptr);
+		}
+
+		m_FrameWriteCount = static_cast<uint32_t>(m_Writes.size());
+		m_TotalWriteCount += m_FrameWriteCount;
+	}
+
+	void DescriptorWriter::Update(VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+		const VkDescriptorImageInfo& imageInfo, const VkDescriptorBufferInfo& bufferInfo)
+	{
+		std::vector<BindingState>& bindings = m_Sets[set];
+
+		auto it = std::find_if(bindings.begin(), bindings.end(), [binding](const BindingState& state) { return state.binding == binding; });
+		if (it == bindings.end())
+		{
+			it = bindings.insert(bindings.end(), BindingState{ binding, type, imageInfo, bufferInfo, false });
+		}
+		else if (it->type == type && it->imageInfo == imageInfo && it->bufferInfo == bufferInfo)
+		{
+			return;
+		}
+
+		it->type = type;
+		it->imageInfo = imageInfo;
+		it->bufferInfo = bufferInfo;
+
+		// A set only needs to be listed once however many of its bindings change
+		bool isSetPending = std::any_of(bindings.begin(), bindings.end(), [](const BindingState& state) { return state.isPending; });
+		if (!isSetPending)
+		{
+			m_PendingSets.push_back(set);
+		}
+		it->isPending = true;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <unordered_map>
+
+namespace VE
+{
+	// Remembers what every (set, binding) was last written with and only queues a write when the resource changes.
+	// Queued writes are issued together by Flush, which the renderer calls once per frame before any set is bound.
+	// Main thread only.
+	class DescriptorWriter
+	{
+	public:
+		explicit DescriptorWriter(VkDevice device);
+		~DescriptorWriter() = default;
+
+		DescriptorWriter(const DescriptorWriter& otherWriter) = delete;
+		DescriptorWriter& operator=(const DescriptorWriter& otherWriter) = delete;
+	public:
+		void WriteImage(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, const VkDescriptorImageInfo& imageInfo);
+		void WriteBuffer(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, const VkDescriptorBufferInfo& bufferInfo);
+		// Drops the cached state and pending writes of a set, call before freeing it since the handle may be reused
+		void Forget(VkDescriptorSet set);
+		// Issues every queued write in one vkUpdateDescriptorSets call
+		void Flush();
+		// Writes issued by the last Flush
+		inline uint32_t GetFrameWriteCount() const { return m_FrameWriteCount; }
+		inline uint64_t GetTotalWriteCount() const { return m_TotalWriteCount; }
+	private:
+		struct BindingState
+		{
+			uint32_t				binding;
+			VkDescriptorType		type;
+			VkDescriptorImageInfo	imageInfo;
+			VkDescriptorBufferInfo	bufferInfo;
+			bool					isPending;
+		};
+
+		// Queues the write unless it matches what the binding was last written with
+		void Update(VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+			const VkDescriptorImageInfo& imageInfo, const VkDescriptorBufferInfo& bufferInfo);
+	private:
+		VkDevice														m_Device;
+		std::unordered_map<VkDescriptorSet, std::vector<BindingState>>	m_Sets;
+		std::vector<VkDescriptorSet>									m_PendingSets;
+		std::vector<VkWriteDescriptorSet>								m_Writes;
+		uint32_t														m_FrameWriteCount;
+		uint64_t														m_TotalWriteCount;
+	};
+}
@@ -3,20 +3,38 @@
 #include <GLFW/glfw3.h>
 
 #include "Swapchain.hpp"
+#include "Buffer/UniformRing.hpp"
+#include "UploadContext.hpp"
+#include "Buffer/GeometryPool.hpp"
+#include "SamplerCache.hpp"
+#include "Descriptor/BindlessTextureArray.hpp"
+#include "Descriptor/DescriptorWriter.hpp"
+#include "Descriptor/DescriptorAllocator.hpp"
+#include "VirtualTextureCache.hpp"
 
 #include "Utilities.hpp"
 
 #include <stdexcept>
 #include <string>
 #include <array>
+#include <limits>
 #include <unordered_set>
+#include <algorithm>
+#include <cstring>
 
 namespace VE
 {
+    static bool HasExtension(const std::vector<VkExtensionProperties>& extensions, const char* name)
+    {
+        return std::any_of(extensions.begin(), extensions.end(), [name](const VkExtensionProperties& ext) { return strcmp(ext.extensionName, name) == 0; });
+    }
+
     Device::Device(Window* window)
         : m_Window(window), m_Instance(VK_NULL_HANDLE), m_PhysicalDevice(VK_NULL_HANDLE),
             m_LogicalDevice(VK_NULL_HANDLE), m_GraphicsQueue(VK_NULL_HANDLE), m_PresentQueue(VK_NULL_HANDLE),
-            m_Surface(VK_NULL_HANDLE), m_CommandPool(VK_NULL_HANDLE)
+            m_TransferQueue(VK_NULL_HANDLE),
+            m_Surface(VK_NULL_HANDLE), m_CommandPool(VK_NULL_HANDLE),
+            m_EnabledFeatures{}, m_Properties{}, m_DescriptorIndexingFeatures{}, m_DescriptorIndexingProperties{}
     {
         m_ValidationLayers =
         {
@@ -33,6 +51,15 @@ namespace VE
         PickPhysicalDevice();
         CreateLogicalDevice();
         CreateCommandPool();
+        CreateAllocator();
+        CreateUniformRing();
+        CreateUploadContext();
+        CreateGeometryPool();
+        CreateSamplerCache();
+        CreateBindlessTextures();
+        CreateDescriptorWriter();
+        CreateDescriptorAllocators();
+        CreateVirtualTextureCache();
     }
 
     Device::~Device()
@@ -139,6 +166,8 @@ namespace VE
         {
             throw std::runtime_error("Error: Failed to find suitable GPU!");
         }
+
+        vkGetPhysicalDeviceProperties(m_PhysicalDevice, &m_Properties);
     }
 
     bool Device::IsDeviceSuitable(VkPhysicalDevice physicalDevice)
@@ -187,9 +216,13 @@ namespace VE
         std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
         vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
+        std::optional<uint32_t> computeTransferFamily;
+
         for(size_t i = 0; i < queueFamilies.size(); i++)
         {
-            if(queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+            VkQueueFlags flags = queueFamilies[i].queueFlags;
+
+            if((flags & VK_QUEUE_GRAPHICS_BIT) && !indices.graphicsFamily.has_value())
             {
                 indices.graphicsFamily = static_cast<uint32_t>(i);
             }
@@ -197,17 +230,32 @@ namespace VE
             VkBool32 presentSupport = VK_FALSE;
             vkGetPhysicalDeviceSurfaceSupportKHR(device, static_cast<uint32_t>(i), m_Surface, &presentSupport);
 
-            if(presentSupport)
+            if(presentSupport && !indices.presentFamily.has_value())
             {
                 indices.presentFamily = static_cast<uint32_t>(i);
             }
 
-            if(indices.IsComplete())
+            // Prefer a transfer only family (DMA engine), then any family without graphics
+            if((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT))
             {
-                break;
+                bool transferOnly = !(flags & VK_QUEUE_COMPUTE_BIT);
+
+                if(transferOnly && !indices.transferFamily.has_value())
+                {
+                    indices.transferFamily = static_cast<uint32_t>(i);
+                }
+                else if(!transferOnly && !computeTransferFamily.has_value())
+                {
+                    computeTransferFamily = static_cast<uint32_t>(i);
+                }
             }
         }
 
+        if(!indices.transferFamily.has_value())
+        {
+            indices.transferFamily = computeTransferFamily;
+        }
+
         return indices;
     }
 
@@ -222,6 +270,11 @@ namespace VE
                 indices.presentFamily.value()
         };
 
+        if(indices.transferFamily.has_value())
+        {
+            queueFamilies.insert(indices.transferFamily.value());
+        }
+
         float queuePriorities = 1.0f;
         for(size_t i{}; const uint32_t family : queueFamilies)
         {
@@ -234,8 +287,17 @@ namespace VE
             i++;
         }
 
-        VkPhysicalDeviceFeatures deviceFeatures{}; // No features just yet
+        VkPhysicalDeviceFeatures supportedFeatures{};
+        vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supportedFeatures);
+
+        VkPhysicalDeviceFeatures deviceFeatures{};
         deviceFeatures.samplerAnisotropy = VK_TRUE;
+        deviceFeatures.fullDrawIndexUint32 = supportedFeatures.fullDrawIndexUint32; // Otherwise 32 bit indices stop at maxDrawIndexedIndexValue
+        deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+        deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance; // Culled draws carry the bindless texture index
+        deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC; // KTX2 textures are decoded on the CPU without it
+        deviceFeatures.fragmentStoresAndAtomics = supportedFeatures.fragmentStoresAndAtomics; // Virtual texture feedback, fully resident textures without it
+        deviceFeatures.shaderSampledImageArrayDynamicIndexing = supportedFeatures.shaderSampledImageArrayDynamicIndexing; // Bindless textures
 
         uint32_t extensionCount{};
         vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extensionCount, nullptr);
@@ -243,13 +305,53 @@ namespace VE
         std::vector<VkExtensionProperties> extensions(extensionCount);
         vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extensionCount, extensions.data());
 
+        std::vector<const char*> enabledExtensions = m_DeviceExtensions;
+
+        // Bindless textures only need the features below, the renderer falls back to a texture per model without them
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT supportedIndexing{};
+        supportedIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        m_DescriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        m_DescriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+        if(HasExtension(extensions, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) && HasExtension(extensions, VK_KHR_MAINTENANCE3_EXTENSION_NAME))
+        {
+            auto getFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(vkGetInstanceProcAddr(m_Instance, "vkGetPhysicalDeviceFeatures2KHR"));
+            auto getProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties2KHR>(vkGetInstanceProcAddr(m_Instance, "vkGetPhysicalDeviceProperties2KHR"));
+
+            VkPhysicalDeviceFeatures2KHR features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+            features2.pNext = &supportedIndexing;
+            getFeatures2(m_PhysicalDevice, &features2);
+
+            VkPhysicalDeviceProperties2KHR properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+            properties2.pNext = &m_DescriptorIndexingProperties;
+            getProperties2(m_PhysicalDevice, &properties2);
+            m_DescriptorIndexingProperties.pNext = nullptr;
+
+            if(supportedIndexing.runtimeDescriptorArray && supportedIndexing.descriptorBindingPartiallyBound &&
+                supportedIndexing.descriptorBindingSampledImageUpdateAfterBind)
+            {
+                m_DescriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+                m_DescriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+                m_DescriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+                enabledExtensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+                enabledExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+            }
+        }
+
         VkDeviceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
         createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         createInfo.pEnabledFeatures = &deviceFeatures;
-        createInfo.enabledExtensionCount = static_cast<uint32_t>(m_DeviceExtensions.size());
-        createInfo.ppEnabledExtensionNames = m_DeviceExtensions.data();
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+        createInfo.ppEnabledExtensionNames = enabledExtensions.data();
+
+        if(m_DescriptorIndexingFeatures.runtimeDescriptorArray)
+        {
+            createInfo.pNext = &m_DescriptorIndexingFeatures;
+        }
 
 #ifndef NDEBUG
         createInfo.enabledLayerCount = static_cast<uint32_t>(m_ValidationLayers.size());
@@ -257,9 +359,15 @@ namespace VE
 #endif
 
         VK_CHECK(vkCreateDevice(m_PhysicalDevice, &createInfo, nullptr, &m_LogicalDevice))
+        m_EnabledFeatures = deviceFeatures;
 
         vkGetDeviceQueue(m_LogicalDevice, indices.graphicsFamily.value(), 0, &m_GraphicsQueue);
         vkGetDeviceQueue(m_LogicalDevice, indices.presentFamily.value(), 0, &m_PresentQueue);
+
+        if(indices.transferFamily.has_value())
+        {
+            vkGetDeviceQueue(m_LogicalDevice, indices.transferFamily.value(), 0, &m_TransferQueue);
+        }
     }
 
     void Device::CreateSurface()
@@ -282,6 +390,62 @@ namespace VE
         VK_CHECK(vkCreateCommandPool(m_LogicalDevice, &poolInfo, nullptr, &m_CommandPool))
     }
 
+    void Device::CreateAllocator()
+    {
+        m_Allocator = std::make_unique<Allocator>(m_PhysicalDevice, m_LogicalDevice, m_Properties.limits);
+    }
+
+    void Device::CreateUniformRing()
+    {
+        m_UniformRing = std::make_unique<UniformRing>(this, UNIFORM_RING_FRAME_SIZE);
+    }
+
+    void Device::CreateUploadContext()
+    {
+        m_UploadContext = std::make_unique<UploadContext>(this);
+    }
+
+    void Device::CreateGeometryPool()
+    {
+        m_GeometryPool = std::make_unique<GeometryPool>(this);
+    }
+
+    void Device::CreateSamplerCache()
+    {
+        m_SamplerCache = std::make_unique<SamplerCache>(this);
+    }
+
+    void Device::CreateBindlessTextures()
+    {
+        if (BindlessTextureArray::IsSupported(this))
+        {
+            m_BindlessTextures = std::make_unique<BindlessTextureArray>(this);
+        }
+    }
+
+    void Device::CreateDescriptorWriter()
+    {
+        m_DescriptorWriter = std::make_unique<DescriptorWriter>(m_LogicalDevice);
+    }
+
+    void Device::CreateDescriptorAllocators()
+    {
+        m_DescriptorAllocator = std::make_unique<DescriptorAllocator>(m_LogicalDevice, false);
+
+        for (uint32_t i = 0; i < Swapchain::MAX_FRAMES_IN_FLIGHT; i++)
+        {
+            m_FrameDescriptorAllocators.push_back(std::make_unique<DescriptorAllocator>(m_LogicalDevice, true));
+        }
+    }
+
+    void Device::CreateVirtualTextureCache()
+    {
+        if (VirtualTextureCache::IsSupported(this))
+        {
+            m_VirtualTextureCache = std::make_unique<VirtualTextureCache>(this);
+        }
+    }
+
     SwapchainSupportDetails Device::QuerySwapchainSupport(VkPhysicalDevice physicalDevice) const
     {
         SwapchainSupportDetails details;
@@ -333,8 +497,16 @@ namespace VE
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &commandBuffer;
 
-        vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(m_GraphicsQueue);
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        VkFence fence;
+        VK_CHECK(vkCreateFence(m_LogicalDevice, &fenceInfo, nullptr, &fence))
+
+        // Only wait for this submission instead of draining the whole queue
+        vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, fence);
+        vkWaitForFences(m_LogicalDevice, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+        vkDestroyFence(m_LogicalDevice, fence, nullptr);
 
         vkFreeCommandBuffers(m_LogicalDevice, m_CommandPool, 1, &commandBuffer);
     }
@@ -355,7 +527,7 @@ namespace VE
             for (size_t j = 0; j < numDescUniforms; j++)
             {
                 layoutBindings[i][k].binding = static_cast<uint32_t>(k);
-                layoutBindings[i][k].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                layoutBindings[i][k].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
                 layoutBindings[i][k].descriptorCount = 1;
                 layoutBindings[i][k].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
                 layoutBindings[i][k].pImmutableSamplers = nullptr;
@@ -385,26 +557,6 @@ namespace VE
         }
     }
 
-    void Device::CreateDescriptorPool(const uint32_t numObjects)
-    {
-        std::array<VkDescriptorPoolSize, 2> poolSizes;
-
-        poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        poolSizes[0].descriptorCount = 1 * numObjects;
-
-        poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        poolSizes[1].descriptorCount = 1 * numObjects;
-
-        VkDescriptorPoolCreateInfo poolCreateInfo{};
-        poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-        poolCreateInfo.maxSets = 2 * numObjects;
-        poolCreateInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-        poolCreateInfo.pPoolSizes = poolSizes.data();
-
-        VK_CHECK(vkCreateDescriptorPool(m_LogicalDevice, &poolCreateInfo, nullptr, &m_DescriptorPool))
-    }
-
     uint32_t Device::FindMemoryType(Device* device, uint32_t typeFilter, VkMemoryPropertyFlags properties)
     {
         VkPhysicalDeviceMemoryProperties memProperties;
@@ -422,6 +574,19 @@ namespace VE
         throw std::runtime_error("Error: Failed to find suitable memory type!");
     }
 
+    bool Device::SupportsFormatFeatures(VkFormat format, VkFormatFeatureFlags features) const
+    {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &properties);
+
+        return (properties.optimalTilingFeatures & features) == features;
+    }
+
+    bool Device::SupportsLinearBlit(VkFormat format) const
+    {
+        return SupportsFormatFeatures(format, VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+    }
+
     void Device::Clean()
     {
         if (!m_DescriptorSetLayouts.empty())
@@ -431,10 +596,16 @@ namespace VE
                 vkDestroyDescriptorSetLayout(m_LogicalDevice, layout, nullptr);
             }
         }
-        if (m_DescriptorPool != VK_NULL_HANDLE)
-        {
-            vkDestroyDescriptorPool(m_LogicalDevice, m_DescriptorPool, nullptr);
-        }
+        m_VirtualTextureCache.reset();
+        m_FrameDescriptorAllocators.clear();
+        m_DescriptorAllocator.reset();
+        m_BindlessTextures.reset();
+        m_DescriptorWriter.reset();
+        m_SamplerCache.reset();
+        m_UploadContext.reset();
+        m_GeometryPool.reset();
+        m_UniformRing.reset();
+        m_Allocator.reset();
         if (m_CommandPool != VK_NULL_HANDLE)
         {
             vkDestroyCommandPool(m_LogicalDevice, m_CommandPool, nullptr);
@@ -4,16 +4,28 @@
 
 #include "Window.hpp"
 
+#include "Memory/Allocator.hpp"
+
 #include <vector>
 #include <optional>
 #include <memory>
 
 namespace VE
 {
+    class UniformRing;
+    class UploadContext;
+    class GeometryPool;
+    class VirtualTextureCache;
+    class SamplerCache;
+    class BindlessTextureArray;
+    class DescriptorWriter;
+    class DescriptorAllocator;
+
     struct QueueFamilyIndices
     {
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        std::optional<uint32_t> transferFamily; // Only set for families without graphics support
 
         inline bool IsComplete() { return graphicsFamily.has_value() && presentFamily.has_value(); }
     };
@@ -39,6 +51,7 @@ namespace VE
         static uint32_t FindMemoryType(Device* device, uint32_t typeFilter, VkMemoryPropertyFlags properties);
         static inline constexpr uint32_t NUM_UNIFORMS = 1;
         static inline constexpr uint32_t NUM_SAMPLERS = 1;
+        static inline constexpr VkDeviceSize UNIFORM_RING_FRAME_SIZE = 1024 * 1024;
     public:
         inline VkDevice GetVkDevice() const { return m_LogicalDevice; }
         inline VkPhysicalDevice GetPhysicalDevice() const { return m_PhysicalDevice; }
@@ -48,13 +61,38 @@ namespace VE
         inline VkCommandPool GetCommandPool() const { return m_CommandPool; }
         inline VkQueue GetGraphicsQueue() const { return m_GraphicsQueue; }
         inline VkQueue GetPresentQueue() const { return m_PresentQueue; }
+        inline VkQueue GetTransferQueue() const { return m_TransferQueue; }
+        inline bool HasTransferQueue() const { return m_TransferQueue != VK_NULL_HANDLE; }
         inline const std::vector<VkDescriptorSetLayout>& GetDescriptorSetLayouts() const { return m_DescriptorSetLayouts; }
-        inline VkDescriptorPool GetDescriptorPool() const { return m_DescriptorPool; }
+        // Sets that live until they are freed, e.g. per model sets
+        inline DescriptorAllocator& GetDescriptorAllocator() const { return *m_DescriptorAllocator; }
+        // Sets that only live for one frame, reset as a whole once the frame's fence has signaled
+        inline DescriptorAllocator& GetFrameDescriptorAllocator(uint32_t frame) const { return *m_FrameDescriptorAllocators[frame]; }
+        inline Allocator& GetAllocator() const { return *m_Allocator; }
+        inline UniformRing& GetUniformRing() const { return *m_UniformRing; }
+        inline UploadContext& GetUploadContext() const { return *m_UploadContext; }
+        inline GeometryPool& GetGeometryPool() const { return *m_GeometryPool; }
+        // Only created when the device can write feedback from fragment shaders, see VirtualTextureCache::IsSupported
+        inline VirtualTextureCache& GetVirtualTextureCache() const { return *m_VirtualTextureCache; }
+        inline bool HasVirtualTextureCache() const { return m_VirtualTextureCache != nullptr; }
+        inline const VkPhysicalDeviceFeatures& GetEnabledFeatures() const { return m_EnabledFeatures; }
+        // Queried once when the physical device is picked
+        inline const VkPhysicalDeviceProperties& GetProperties() const { return m_Properties; }
+        inline SamplerCache& GetSamplerCache() const { return *m_SamplerCache; }
+        inline DescriptorWriter& GetDescriptorWriter() const { return *m_DescriptorWriter; }
+        // Only created with descriptor indexing, see BindlessTextureArray::IsSupported
+        inline BindlessTextureArray& GetBindlessTextures() const { return *m_BindlessTextures; }
+        inline bool HasBindlessTextures() const { return m_BindlessTextures != nullptr; }
+        // Zeroed when VK_EXT_descriptor_indexing isn't available
+        inline const VkPhysicalDeviceDescriptorIndexingFeaturesEXT& GetDescriptorIndexingFeatures() const { return m_DescriptorIndexingFeatures; }
+        inline const VkPhysicalDeviceDescriptorIndexingPropertiesEXT& GetDescriptorIndexingProperties() const { return m_DescriptorIndexingProperties; }
     public:
         VkCommandBuffer BeginSingleTimeCommands();
         void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
         void CreateDescriptorLayouts();
-        void CreateDescriptorPool(const uint32_t numObjects);
+        bool SupportsFormatFeatures(VkFormat format, VkFormatFeatureFlags features) const;
+        // Optimal tiling images of the format can be mipmapped with linear vkCmdBlitImage
+        bool SupportsLinearBlit(VkFormat format) const;
     private:
         void CreateInstance();
         bool CheckValidationLayers(const std::vector<const char*>& layers);
@@ -65,6 +103,15 @@ namespace VE
         void CreateLogicalDevice();
         void CreateSurface();
         void CreateCommandPool();
+        void CreateAllocator();
+        void CreateUniformRing();
+        void CreateUploadContext();
+        void CreateGeometryPool();
+        void CreateSamplerCache();
+        void CreateBindlessTextures();
+        void CreateDescriptorWriter();
+        void CreateDescriptorAllocators();
+        void CreateVirtualTextureCache();
         SwapchainSupportDetails QuerySwapchainSupport(VkPhysicalDevice physicalDevice) const;
         void Clean();
     private:
@@ -74,10 +121,24 @@ namespace VE
         VkDevice                            m_LogicalDevice;
         VkQueue                             m_GraphicsQueue;
         VkQueue                             m_PresentQueue;
+        VkQueue                             m_TransferQueue;
         VkSurfaceKHR                        m_Surface;
         VkCommandPool                       m_CommandPool;
         std::vector<VkDescriptorSetLayout>  m_DescriptorSetLayouts;
-        VkDescriptorPool                    m_DescriptorPool;
+        std::unique_ptr<Allocator>          m_Allocator;
+        std::unique_ptr<UniformRing>        m_UniformRing;
+        std::unique_ptr<UploadContext>      m_UploadContext;
+        std::unique_ptr<GeometryPool>       m_GeometryPool;
+        std::unique_ptr<SamplerCache>       m_SamplerCache;
+        std::unique_ptr<BindlessTextureArray> m_BindlessTextures;
+        std::unique_ptr<DescriptorWriter>   m_DescriptorWriter;
+        std::unique_ptr<DescriptorAllocator> m_DescriptorAllocator;
+        std::vector<std::unique_ptr<DescriptorAllocator>> m_FrameDescriptorAllocators;
+        std::unique_ptr<VirtualTextureCache> m_VirtualTextureCache;
+        VkPhysicalDeviceFeatures            m_EnabledFeatures;
+        VkPhysicalDeviceProperties          m_Properties;
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT   m_DescriptorIndexingFeatures; // Only the enabled features
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT m_DescriptorIndexingProperties;
     private:
         std::vector<const char*> m_ValidationLayers;
         std::vector<const char*> m_DeviceExtensions;
@@ -0,0 +1,432 @@
+#include "BlockDecoder.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <string>
+
+namespace VE
+{
+	// Bit i is the subset of texel i in the 2 subset BC7 partitions
+	static constexpr uint16_t PARTITIONS_2[64] =
+	{
+		0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+		0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+		0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+		0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+	};
+
+	static constexpr uint8_t PARTITIONS_3[64][16] =
+	{
+		{ 0,0,1,1, 0,0,1,1, 0,2,2,1, 2,2,2,2 }, { 0,0,0,1, 0,0,1,1, 2,2,1,1, 2,2,2,1 }, { 0,0,0,0, 2,0,0,1, 2,2,1,1, 2,2,1,1 }, { 0,2,2,2, 0,0,2,2, 0,0,1,1, 0,1,1,1 },
+		{ 0,0,0,0, 0,0,0,0, 1,1,2,2, 1,1,2,2 }, { 0,0,1,1, 0,0,1,1, 0,0,2,2, 0,0,2,2 }, { 0,0,2,2, 0,0,2,2, 1,1,1,1, 1,1,1,1 }, { 0,0,1,1, 0,0,1,1, 2,2,1,1, 2,2,1,1 },
+		{ 0,0,0,0, 0,0,0,0, 1,1,1,1, 2,2,2,2 }, { 0,0,0,0, 1,1,1,1, 1,1,1,1, 2,2,2,2 }, { 0,0,0,0, 1,1,1,1, 2,2,2,2, 2,2,2,2 }, { 0,0,1,2, 0,0,1,2, 0,0,1,2, 0,0,1,2 },
+		{ 0,1,1,2, 0,1,1,2, 0,1,1,2, 0,1,1,2 }, { 0,1,2,2, 0,1,2,2, 0,1,2,2, 0,1,2,2 }, { 0,0,1,1, 0,1,1,2, 1,1,2,2, 1,2,2,2 }, { 0,0,1,1, 2,0,0,1, 2,2,0,0, 2,2,2,0 },
+		{ 0,0,0,1, 0,0,1,1, 0,1,1,2, 1,1,2,2 }, { 0,1,1,1, 0,0,1,1, 2,0,0,1, 2,2,0,0 }, { 0,0,0,0, 1,1,2,2, 1,1,2,2, 1,1,2,2 }, { 0,0,2,2, 0,0,2,2, 0,0,2,2, 1,1,1,1 },
+		{ 0,1,1,1, 0,1,1,1, 0,2,2,2, 0,2,2,2 }, { 0,0,0,1, 0,0,0,1, 2,2,2,1, 2,2,2,1 }, { 0,0,0,0, 0,0,1,1, 0,1,2,2, 0,1,2,2 }, { 0,0,0,0, 1,1,0,0, 2,2,1,0, 2,2,1,0 },
+		{ 0,1,2,2, 0,1,2,2, 0,0,1,1, 0,0,0,0 }, { 0,0,1,2, 0,0,1,2, 1,1,2,2, 2,2,2,2 }, { 0,1,1,0, 1,2,2,1, 1,2,2,1, 0,1,1,0 }, { 0,0,0,0, 0,1,1,0, 1,2,2,1, 1,2,2,1 },
+		{ 0,0,2,2, 1,1,0,2, 1,1,0,2, 0,0,2,2 }, { 0,1,1,0, 0,1,1,0, 2,0,0,2, 2,2,2,2 }, { 0,0,1,1, 0,1,2,2, 0,1,2,2, 0,0,1,1 }, { 0,0,0,0, 2,0,0,0, 2,2,1,1, 2,2,2,1 },
+		{ 0,0,0,0, 0,0,0,2, 1,1,2,2, 1,2,2,2 }, { 0,2,2,2, 0,0,2,2, 0,0,1,2, 0,0,1,1 }, { 0,0,1,1, 0,0,1,2, 0,0,2,2, 0,2,2,2 }, { 0,1,2,0, 0,1,2,0, 0,1,2,0, 0,1,2,0 },
+		{ 0,0,0,0, 1,1,1,1, 2,2,2,2, 0,0,0,0 }, { 0,1,2,0, 1,2,0,1, 2,0,1,2, 0,1,2,0 }, { 0,1,2,0, 2,0,1,2, 1,2,0,1, 0,1,2,0 }, { 0,0,1,1, 2,2,0,0, 1,1,2,2, 0,0,1,1 },
+		{ 0,0,1,1, 1,1,2,2, 2,2,0,0, 0,0,1,1 }, { 0,1,0,1, 0,1,0,1, 2,2,2,2, 2,2,2,2 }, { 0,0,0,0, 0,0,0,0, 2,1,2,1, 2,1,2,1 }, { 0,0,2,2, 1,1,2,2, 0,0,2,2, 1,1,2,2 },
+		{ 0,0,2,2, 0,0,1,1, 0,0,2,2, 0,0,1,1 }, { 0,2,2,0, 1,2,2,1, 0,2,2,0, 1,2,2,1 }, { 0,1,0,1, 2,2,2,2, 2,2,2,2, 0,1,0,1 }, { 0,0,0,0, 2,1,2,1, 2,1,2,1, 2,1,2,1 },
+		{ 0,1,0,1, 0,1,0,1, 0,1,0,1, 2,2,2,2 }, { 0,2,2,2, 0,1,1,1, 0,2,2,2, 0,1,1,1 }, { 0,0,0,2, 1,1,1,2, 0,0,0,2, 1,1,1,2 }, { 0,0,0,0, 2,1,1,2, 2,1,1,2, 2,1,1,2 },
+		{ 0,2,2,2, 0,1,1,1, 0,1,1,1, 0,2,2,2 }, { 0,0,0,2, 1,1,1,2, 1,1,1,2, 0,0,0,2 }, { 0,1,1,0, 0,1,1,0, 0,1,1,0, 2,2,2,2 }, { 0,0,0,0, 0,0,0,0, 2,1,1,2, 2,1,1,2 },
+		{ 0,1,1,0, 0,1,1,0, 2,2,2,2, 2,2,2,2 }, { 0,0,2,2, 0,0,1,1, 0,0,1,1, 0,0,2,2 }, { 0,0,2,2, 1,1,2,2, 1,1,2,2, 0,0,2,2 }, { 0,0,0,0, 0,0,0,0, 0,0,0,0, 2,1,1,2 },
+		{ 0,0,0,2, 0,0,0,1, 0,0,0,2, 0,0,0,1 }, { 0,2,2,2, 1,2,2,2, 0,2,2,2, 1,2,2,2 }, { 0,1,0,1, 2,2,2,2, 2,2,2,2, 2,2,2,2 }, { 0,1,1,1, 2,0,1,1, 2,2,0,1, 2,2,2,0 }
+	};
+
+	// Texels whose index drops its top bit because it is implied zero, subset 0 always anchors at texel 0
+	static constexpr uint8_t ANCHORS_2[64] =
+	{
+		15,15,15,15,15,15,15,15, 15,15,15,15,15,15,15,15, 15, 2, 8, 2, 2, 8, 8,15,  2, 8, 2, 2, 8, 8, 2, 2,
+		15,15, 6, 8, 2, 8,15,15,  2, 8, 2, 2, 2,15,15, 6,  6, 2, 6, 8,15,15, 2, 2, 15,15,15,15,15, 2, 2,15
+	};
+
+	static constexpr uint8_t ANCHORS_3_SECOND[64] =
+	{
+		 3, 3,15,15, 8, 3,15,15,  8, 8, 6, 6, 6, 5, 3, 3,  3, 3, 8,15, 3, 3, 6,10,  5, 8, 8, 6, 8, 5,15,15,
+		 8,15, 3, 5, 6,10, 8,15, 15, 3,15, 5,15,15,15,15,  3,15, 5, 5, 5, 8, 5,10,  5,10, 8,13,15,12, 3, 3
+	};
+
+	static constexpr uint8_t ANCHORS_3_THIRD[64] =
+	{
+		15, 8, 8, 3,15,15, 3, 8, 15,15,15,15,15,15,15, 8, 15, 8,15, 3,15, 8,15, 8,  3,15, 6,10,15,15,10, 8,
+		15, 3,15,10,10, 8, 9,10,  6,15, 8,15, 3, 6, 6, 8, 15, 3,15,15,15,15,15,15, 15,15,15,15, 3,15,15, 8
+	};
+
+	static constexpr uint8_t WEIGHTS_2[4] = { 0, 21, 43, 64 };
+	static constexpr uint8_t WEIGHTS_3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	static constexpr uint8_t WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	struct Bc7Mode
+	{
+		uint8_t subsetCount;
+		uint8_t partitionBits;
+		uint8_t rotationBits;
+		uint8_t indexSelectionBits;
+		uint8_t colorBits;
+		uint8_t alphaBits;
+		uint8_t endpointPBits;
+		uint8_t sharedPBits;
+		uint8_t indexBits;
+		uint8_t secondaryIndexBits;
+	};
+
+	static constexpr Bc7Mode BC7_MODES[8] =
+	{
+		{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+		{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+		{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+		{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+		{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+		{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+		{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+		{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+	};
+
+	// Reads a 128 bit block LSB first
+	class BitReader
+	{
+	public:
+		explicit BitReader(const uint8_t* block)
+		{
+			std::memcpy(&m_Low, block, sizeof(m_Low));
+			std::memcpy(&m_High, block + 8, sizeof(m_High));
+		}
+
+		uint32_t Read(uint32_t count)
+		{
+			uint32_t value = 0;
+			for (uint32_t i = 0; i < count; i++, m_Position++)
+			{
+				uint64_t word = m_Position < 64 ? m_Low >> m_Position : m_High >> (m_Position - 64);
+				value |= static_cast<uint32_t>(word & 1) << i;
+			}
+			return value;
+		}
+	private:
+		uint64_t m_Low = 0;
+		uint64_t m_High = 0;
+		uint32_t m_Position = 0;
+	};
+
+	static uint8_t Interpolate(uint32_t e0, uint32_t e1, uint32_t weight)
+	{
+		return static_cast<uint8_t>(((64 - weight) * e0 + weight * e1 + 32) >> 6);
+	}
+
+	static void Expand565(uint16_t color, uint8_t* rgb)
+	{
+		uint32_t r = (color >> 11) & 31;
+		uint32_t g = (color >> 5) & 63;
+		uint32_t b = color & 31;
+		rgb[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+		rgb[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+		rgb[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+	}
+
+	bool BlockDecoder::IsBlockCompressed(VkFormat format)
+	{
+		return GetBlockSize(format) != 0;
+	}
+
+	uint32_t BlockDecoder::GetBlockSize(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:	return 8;
+		case VK_FORMAT_BC3_UNORM_BLOCK:
+		case VK_FORMAT_BC5_UNORM_BLOCK:
+		case VK_FORMAT_BC7_UNORM_BLOCK:			return 16;
+		default:								return 0;
+		}
+	}
+
+	VkDeviceSize BlockDecoder::GetLevelSize(VkFormat format, uint32_t width, uint32_t height)
+	{
+		uint32_t blockSize = GetBlockSize(format);
+		if (blockSize == 0)
+		{
+			return static_cast<VkDeviceSize>(width) * height * 4;
+		}
+
+		VkDeviceSize blocksX = (width + BLOCK_DIM - 1) / BLOCK_DIM;
+		VkDeviceSize blocksY = (height + BLOCK_DIM - 1) / BLOCK_DIM;
+		return blocksX * blocksY * blockSize;
+	}
+
+	void BlockDecoder::DecodeLevel(VkFormat format, const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dst)
+	{
+		uint32_t blockSize = GetBlockSize(format);
+		if (blockSize == 0)
+		{
+			throw std::runtime_error("Error: Format " + std::to_string(format) + " is not block compressed");
+		}
+
+		uint32_t blocksX = (width + BLOCK_DIM - 1) / BLOCK_DIM;
+		uint32_t blocksY = (height + BLOCK_DIM - 1) / BLOCK_DIM;
+
+		for (uint32_t by = 0; by < blocksY; by++)
+		{
+			for (uint32_t bx = 0; bx < blocksX; bx++)
+			{
+				const uint8_t* block = src + (static_cast<size_t>(by) * blocksX + bx) * blockSize;
+
+				uint8_t texels[16 * 4];
+				switch (format)
+				{
+				case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+					DecodeBC1(block, texels, false, false);
+					break;
+				case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+					DecodeBC1(block, texels, false, true);
+					break;
+				case VK_FORMAT_BC3_UNORM_BLOCK:
+					DecodeBC1(block + 8, texels, true, false);
+					DecodeBC4(block, texels, 3);
+					break;
+				case VK_FORMAT_BC5_UNORM_BLOCK:
+					for (uint32_t i = 0; i < 16; i++)
+					{
+						texels[i * 4 + 2] = 0;
+						texels[i * 4 + 3] = 255;
+					}
+					DecodeBC4(block, texels, 0);
+					DecodeBC4(block + 8, texels, 1);
+					break;
+				default:
+					DecodeBC7(block, texels);
+					break;
+				}
+
+				// Blocks hanging over the right or bottom edge only write the texels inside the level
+				uint32_t columns = std::min(BLOCK_DIM, width - bx * BLOCK_DIM);
+				uint32_t rows = std::min(BLOCK_DIM, height - by * BLOCK_DIM);
+				for (uint32_t y = 0; y < rows; y++)
+				{
+					uint8_t* row = dst + ((static_cast<size_t>(by) * BLOCK_DIM + y) * width + bx * BLOCK_DIM) * 4;
+					std::memcpy(row, texels + y * BLOCK_DIM * 4, columns * 4);
+				}
+			}
+		}
+	}
+
+	void BlockDecoder::DecodeBC1(const uint8_t* block, uint8_t* texels, bool fourColorOnly, bool hasAlpha)
+	{
+		uint16_t color0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+		uint16_t color1 = static_cast<uint16_t>(block[2] | block[3] << 8);
+
+		uint8_t palette[4][4];
+		Expand565(color0, palette[0]);
+		Expand565(color1, palette[1]);
+		palette[0][3] = palette[1][3] = 255;
+
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			if (fourColorOnly || color0 > color1)
+			{
+				palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+				palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+			}
+			else
+			{
+				palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+				palette[3][c] = 0;
+			}
+		}
+		palette[2][3] = 255;
+		// The fourth entry of the three color mode is transparent black, only BC1 RGBA keeps the transparency
+		palette[3][3] = fourColorOnly || color0 > color1 || !hasAlpha ? 255 : 0;
+
+		uint32_t indices = block[4] | block[5] << 8 | block[6] << 16 | static_cast<uint32_t>(block[7]) << 24;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			std::memcpy(texels + i * 4, palette[(indices >> (i * 2)) & 3], 4);
+		}
+	}
+
+	void BlockDecoder::DecodeBC4(const uint8_t* block, uint8_t* texels, uint32_t channel)
+	{
+		uint32_t value0 = block[0];
+		uint32_t value1 = block[1];
+
+		uint8_t palette[8];
+		palette[0] = static_cast<uint8_t>(value0);
+		palette[1] = static_cast<uint8_t>(value1);
+		if (value0 > value1)
+		{
+			for (uint32_t i = 1; i < 7; i++)
+			{
+				palette[i + 1] = static_cast<uint8_t>(((7 - i) * value0 + i * value1) / 7);
+			}
+		}
+		else
+		{
+			for (uint32_t i = 1; i < 5; i++)
+			{
+				palette[i + 1] = static_cast<uint8_t>(((5 - i) * value0 + i * value1) / 5);
+			}
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+
+		uint64_t indices = 0;
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			indices |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+		}
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			texels[i * 4 + channel] = palette[(indices >> (i * 3)) & 7];
+		}
+	}
+
+	void BlockDecoder::DecodeBC7(const uint8_t* block, uint8_t* texels)
+	{
+		BitReader reader(block);
+
+		uint32_t modeIndex = 0;
+		while (modeIndex < 8 && reader.Read(1) == 0)
+		{
+			modeIndex++;
+		}
+		if (modeIndex == 8)
+		{
+			// Reserved mode, decodes to transparent black
+			std::memset(texels, 0, 16 * 4);
+			return;
+		}
+
+		const Bc7Mode& mode = BC7_MODES[modeIndex];
+		uint32_t partition = reader.Read(mode.partitionBits);
+		uint32_t rotation = reader.Read(mode.rotationBits);
+		uint32_t indexSelection = reader.Read(mode.indexSelectionBits);
+
+		// Endpoints are stored channel by channel, each channel lists every subset's pair
+		uint32_t endpoints[3][2][4] = {};
+		uint32_t endpointCount = mode.subsetCount * 2u;
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			for (uint32_t e = 0; e < endpointCount; e++)
+			{
+				endpoints[e / 2][e % 2][c] = reader.Read(mode.colorBits);
+			}
+		}
+		for (uint32_t e = 0; e < endpointCount; e++)
+		{
+			endpoints[e / 2][e % 2][3] = mode.alphaBits ? reader.Read(mode.alphaBits) : 255;
+		}
+
+		uint32_t colorBits = mode.colorBits;
+		uint32_t alphaBits = mode.alphaBits;
+		if (mode.endpointPBits || mode.sharedPBits)
+		{
+			uint32_t pBits[6] = {};
+			for (uint32_t e = 0; e < endpointCount; e++)
+			{
+				pBits[e] = mode.endpointPBits ? reader.Read(1) : (e % 2 == 0 ? reader.Read(1) : pBits[e - 1]);
+			}
+			for (uint32_t e = 0; e < endpointCount; e++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					endpoints[e / 2][e % 2][c] = endpoints[e / 2][e % 2][c] << 1 | pBits[e];
+				}
+				if (mode.alphaBits)
+				{
+					endpoints[e / 2][e % 2][3] = endpoints[e / 2][e % 2][3] << 1 | pBits[e];
+				}
+			}
+			colorBits++;
+			alphaBits += mode.alphaBits ? 1 : 0;
+		}
+
+		// Widen to 8 bits by replicating the top bits into the bottom
+		for (uint32_t e = 0; e < endpointCount; e++)
+		{
+			uint32_t* endpoint = endpoints[e / 2][e % 2];
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				endpoint[c] = endpoint[c] << (8 - colorBits) | endpoint[c] >> (2 * colorBits - 8);
+			}
+			if (mode.alphaBits)
+			{
+				endpoint[3] = endpoint[3] << (8 - alphaBits) | endpoint[3] >> (2 * alphaBits - 8);
+			}
+		}
+
+		uint8_t subsets[16] = {};
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			subsets[i] =	mode.subsetCount == 2 ? static_cast<uint8_t>((PARTITIONS_2[partition] >> i) & 1) :
+							mode.subsetCount == 3 ? PARTITIONS_3[partition][i] : 0;
+		}
+
+		auto isAnchor = [&](uint32_t texel)
+		{
+			if (texel == 0)
+			{
+				return true;
+			}
+			if (mode.subsetCount == 2)
+			{
+				return texel == ANCHORS_2[partition];
+			}
+			if (mode.subsetCount == 3)
+			{
+				return texel == ANCHORS_3_SECOND[partition] || texel == ANCHORS_3_THIRD[partition];
+			}
+			return false;
+		};
+
+		uint32_t indices[16];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			indices[i] = reader.Read(isAnchor(i) ? mode.indexBits - 1u : mode.indexBits);
+		}
+
+		uint32_t secondaryIndices[16] = {};
+		if (mode.secondaryIndexBits)
+		{
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				secondaryIndices[i] = reader.Read(i == 0 ? mode.secondaryIndexBits - 1u : mode.secondaryIndexBits);
+			}
+		}
+
+		auto weight = [](uint32_t bits, uint32_t index)
+		{
+			return bits == 2 ? WEIGHTS_2[index] : bits == 3 ? WEIGHTS_3[index] : WEIGHTS_4[index];
+		};
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			const uint32_t* e0 = endpoints[subsets[i]][0];
+			const uint32_t* e1 = endpoints[subsets[i]][1];
+
+			uint32_t colorWeight = weight(mode.indexBits, indices[i]);
+			uint32_t alphaWeight = colorWeight;
+			if (mode.secondaryIndexBits)
+			{
+				// Mode 4 may swap which index set drives color and which drives alpha
+				uint32_t secondaryWeight = weight(mode.secondaryIndexBits, secondaryIndices[i]);
+				alphaWeight = indexSelection ? colorWeight : secondaryWeight;
+				colorWeight = indexSelection ? secondaryWeight : colorWeight;
+			}
+
+			uint8_t* texel = texels + i * 4;
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				texel[c] = Interpolate(e0[c], e1[c], colorWeight);
+			}
+			texel[3] = Interpolate(e0[3], e1[3], alphaWeight);
+
+			if (rotation != 0)
+			{
+				std::swap(texel[3], texel[rotation - 1]);
+			}
+		}
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+namespace VE
+{
+	// CPU decoder for the BC formats KTX2 textures may hold, used when the device can't sample them.
+	// Every 4x4 block is expanded to RGBA8, BC5 fills blue with 0 and alpha with 255.
+	class BlockDecoder
+	{
+	public:
+		static inline constexpr uint32_t BLOCK_DIM = 4;
+	public:
+		static bool IsBlockCompressed(VkFormat format);
+		// Bytes per 4x4 block, 8 for BC1 and 16 for the others
+		static uint32_t GetBlockSize(VkFormat format);
+		static VkDeviceSize GetLevelSize(VkFormat format, uint32_t width, uint32_t height);
+		// dst receives width * height tightly packed RGBA8 texels, partial edge blocks are clipped
+		static void DecodeLevel(VkFormat format, const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dst);
+	private:
+		static void DecodeBC1(const uint8_t* block, uint8_t* texels, bool fourColorOnly, bool hasAlpha);
+		static void DecodeBC4(const uint8_t* block, uint8_t* texels, uint32_t channel);
+		static void DecodeBC7(const uint8_t* block, uint8_t* texels);
+	};
+}
@@ -0,0 +1,156 @@
+#include "Ktx2Loader.hpp"
+
+#include "BlockDecoder.hpp"
+
+#include "Mesh/MappedFile.hpp"
+
+#include "stb/stb_image.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+namespace VE
+{
+	bool Ktx2Loader::CanLoad(std::string_view filepath)
+	{
+		std::string extension = std::filesystem::path(filepath).extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return extension == ".ktx2";
+	}
+
+	TextureData Ktx2Loader::Load(std::string_view filepath)
+	{
+		std::string path(filepath);
+
+		MappedFile file;
+		if (!file.Open(path))
+		{
+			throw std::runtime_error("Error: Failed to open " + path);
+		}
+
+		Header header{};
+		if (file.GetSize() < sizeof(header))
+		{
+			throw std::runtime_error("Error: " + path + " is too small to be a KTX2 file");
+		}
+		std::memcpy(&header, file.GetData(), sizeof(header));
+
+		if (std::memcmp(header.identifier, IDENTIFIER, sizeof(IDENTIFIER)) != 0)
+		{
+			throw std::runtime_error("Error: " + path + " is not a KTX2 file");
+		}
+		// Basis Universal and Zstd would need the basisu and zstd libraries, which aren't part of the engine
+		if (header.supercompressionScheme == SUPERCOMPRESSION_BASIS_LZ || header.vkFormat == VK_FORMAT_UNDEFINED)
+		{
+			throw std::runtime_error("Error: Basis Universal textures aren't supported, " + path + " has to be stored as BC1/BC3/BC5/BC7 or RGBA8");
+		}
+		if (header.supercompressionScheme == SUPERCOMPRESSION_ZSTD)
+		{
+			throw std::runtime_error("Error: Zstd supercompression isn't supported, " + path + " has to be stored uncompressed or with zlib");
+		}
+		if (header.supercompressionScheme != SUPERCOMPRESSION_NONE && header.supercompressionScheme != SUPERCOMPRESSION_ZLIB)
+		{
+			throw std::runtime_error("Error: Unknown KTX2 supercompression scheme " + std::to_string(header.supercompressionScheme) + " in " + path);
+		}
+		if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1)
+		{
+			throw std::runtime_error("Error: " + path + " is not a 2D texture");
+		}
+
+		TextureData data;
+		data.path = path;
+		data.width = header.pixelWidth;
+		data.height = header.pixelHeight;
+		data.channels = 4;
+		data.format = ResolveFormat(header.vkFormat, path);
+
+		// A level count of 0 asks the loader to generate the chain, which is what happens to single level textures anyway
+		data.mipLevels = std::max(header.levelCount, 1u);
+		if (data.mipLevels > Texture::MipLevelCount(data.width, data.height))
+		{
+			throw std::runtime_error("Error: " + path + " has more mip levels than its size allows");
+		}
+
+		uint64_t indexOffset = sizeof(Header);
+		if (indexOffset + data.mipLevels * sizeof(LevelIndex) > file.GetSize())
+		{
+			throw std::runtime_error("Error: Truncated KTX2 level index in " + path);
+		}
+
+		VkDeviceSize chainSize = 0;
+		for (uint32_t i = 1; i < data.mipLevels; i++)
+		{
+			chainSize += data.GetLevelSize(i);
+		}
+
+		data.pixels = { static_cast<uint8_t*>(std::malloc(static_cast<size_t>(data.GetDataSize()))), std::free };
+		data.mipChain.resize(static_cast<size_t>(chainSize));
+		if (!data.pixels)
+		{
+			throw std::runtime_error("Error: Out of memory loading " + path);
+		}
+
+		uint8_t* chain = data.mipChain.data();
+		for (uint32_t i = 0; i < data.mipLevels; i++)
+		{
+			LevelIndex level{};
+			std::memcpy(&level, file.GetData() + indexOffset + i * sizeof(LevelIndex), sizeof(level));
+
+			VkDeviceSize levelSize = data.GetLevelSize(i);
+			uint64_t storedSize = header.supercompressionScheme == SUPERCOMPRESSION_NONE ? levelSize : level.byteLength;
+			if (level.uncompressedByteLength != levelSize || level.byteLength != storedSize ||
+				level.byteOffset > file.GetSize() || storedSize > file.GetSize() - level.byteOffset || storedSize > INT32_MAX)
+			{
+				throw std::runtime_error("Error: Invalid KTX2 level " + std::to_string(i) + " in " + path);
+			}
+
+			uint8_t* dst = i == 0 ? data.pixels.get() : chain;
+			const uint8_t* src = file.GetData() + level.byteOffset;
+
+			if (header.supercompressionScheme == SUPERCOMPRESSION_ZLIB)
+			{
+				int written = stbi_zlib_decode_buffer(reinterpret_cast<char*>(dst), static_cast<int>(levelSize),
+					reinterpret_cast<const char*>(src), static_cast<int>(storedSize));
+				if (written != static_cast<int>(levelSize))
+				{
+					throw std::runtime_error("Error: Failed to inflate KTX2 level " + std::to_string(i) + " in " + path);
+				}
+			}
+			else
+			{
+				std::memcpy(dst, src, static_cast<size_t>(levelSize));
+			}
+
+			if (i > 0)
+			{
+				chain += levelSize;
+			}
+		}
+
+		return data;
+	}
+
+	VkFormat Ktx2Loader::ResolveFormat(uint32_t vkFormat, std::string_view filepath)
+	{
+		switch (static_cast<VkFormat>(vkFormat))
+		{
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:			return VK_FORMAT_R8G8B8A8_UNORM;
+		case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGB_SRGB_BLOCK:		return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+		case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:		return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+		case VK_FORMAT_BC3_UNORM_BLOCK:
+		case VK_FORMAT_BC3_SRGB_BLOCK:			return VK_FORMAT_BC3_UNORM_BLOCK;
+		case VK_FORMAT_BC5_UNORM_BLOCK:			return VK_FORMAT_BC5_UNORM_BLOCK;
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+		case VK_FORMAT_BC7_SRGB_BLOCK:			return VK_FORMAT_BC7_UNORM_BLOCK;
+		default:
+			throw std::runtime_error("Error: Unsupported KTX2 format " + std::to_string(vkFormat) + " in " + std::string(filepath));
+		}
+	}
+}
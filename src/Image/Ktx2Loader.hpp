@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Texture.hpp"
+
+#include <string_view>
+
+namespace VE
+{
+	// Reads 2D KTX2 textures holding BC1, BC3, BC5, BC7 or RGBA8 levels, uncompressed or zlib supercompressed.
+	// sRGB formats load as their UNORM twin because the renderer works on gamma encoded colors end to end.
+	// Basis Universal payloads (BasisLZ, UASTC) and Zstd supercompression aren't supported, such files throw.
+	class Ktx2Loader
+	{
+	public:
+		static inline constexpr uint8_t IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+		static inline constexpr uint32_t SUPERCOMPRESSION_NONE = 0;
+		static inline constexpr uint32_t SUPERCOMPRESSION_BASIS_LZ = 1;
+		static inline constexpr uint32_t SUPERCOMPRESSION_ZSTD = 2;
+		static inline constexpr uint32_t SUPERCOMPRESSION_ZLIB = 3;
+	public:
+		static bool CanLoad(std::string_view filepath);
+		// Levels are returned as stored, TextureData::pixels holds mip 0 and mipChain the rest
+		static TextureData Load(std::string_view filepath);
+	private:
+		struct Header
+		{
+			uint8_t		identifier[12];
+			uint32_t	vkFormat;
+			uint32_t	typeSize;
+			uint32_t	pixelWidth;
+			uint32_t	pixelHeight;
+			uint32_t	pixelDepth;
+			uint32_t	layerCount;
+			uint32_t	faceCount;
+			uint32_t	levelCount;
+			uint32_t	supercompressionScheme;
+			uint32_t	dfdByteOffset;
+			uint32_t	dfdByteLength;
+			uint32_t	kvdByteOffset;
+			uint32_t	kvdByteLength;
+			uint64_t	sgdByteOffset;
+			uint64_t	sgdByteLength;
+		};
+
+		struct LevelIndex
+		{
+			uint64_t	byteOffset;
+			uint64_t	byteLength;
+			uint64_t	uncompressedByteLength;
+		};
+	private:
+		static VkFormat ResolveFormat(uint32_t vkFormat, std::string_view filepath);
+	};
+}
@@ -0,0 +1,249 @@
+#include "Allocator.hpp"
+
+#include "Utilities.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <iostream>
+
+namespace VE
+{
+	Allocator::Allocator(VkPhysicalDevice physicalDevice, VkDevice device, const VkPhysicalDeviceLimits& limits)
+		:	m_PhysicalDevice(physicalDevice), m_Device(device), m_MemoryProperties{},
+			m_BufferImageGranularity(1), m_MaxAllocationCount(0), m_AllocationCount(0)
+	{
+		vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
+
+		m_BufferImageGranularity = limits.bufferImageGranularity;
+		m_MaxAllocationCount = limits.maxMemoryAllocationCount;
+
+		// Two pools per memory type, buffers and optimal images never share a block
+		m_Pools.resize(m_MemoryProperties.memoryTypeCount * 2);
+	}
+
+	Allocator::~Allocator()
+	{
+		for (auto& pool : m_Pools)
+		{
+			for (auto& block : pool)
+			{
+				if (block->GetMappedData())
+				{
+					vkUnmapMemory(m_Device, block->GetVkDeviceMemory());
+				}
+				vkFreeMemory(m_Device, block->GetVkDeviceMemory(), nullptr);
+			}
+		}
+	}
+
+	Allocation Allocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, AllocationType type)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		uint32_t memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, properties);
+		uint32_t poolIndex = PoolIndex(memoryTypeIndex, type);
+		auto& pool = m_Pools[poolIndex];
+
+		Allocation allocation{};
+		allocation.size = requirements.size;
+
+		for (auto& block : pool)
+		{
+			uint32_t range = block->Allocate(requirements.size, requirements.alignment, &allocation.offset);
+			if (range != MemoryBlock::INVALID_RANGE)
+			{
+				allocation.block = block.get();
+				allocation.range = range;
+				break;
+			}
+		}
+
+		if (!allocation.block)
+		{
+			// Large resources get a block of their own so they don't pin a mostly empty shared block,
+			// it starts at offset 0 which satisfies any alignment
+			VkDeviceSize blockSize = PreferredBlockSize(memoryTypeIndex);
+			if (requirements.size > blockSize / 2)
+			{
+				blockSize = requirements.size;
+			}
+
+			allocation.block = CreateBlock(memoryTypeIndex, poolIndex, blockSize);
+			allocation.range = allocation.block->Allocate(requirements.size, requirements.alignment, &allocation.offset);
+			if (allocation.range == MemoryBlock::INVALID_RANGE)
+			{
+				throw std::runtime_error("Error: Allocation doesn't fit into a newly created memory block!");
+			}
+		}
+
+		allocation.memory = allocation.block->GetVkDeviceMemory();
+		if (allocation.block->GetMappedData())
+		{
+			allocation.mappedData = static_cast<char*>(allocation.block->GetMappedData()) + allocation.offset;
+		}
+
+		return allocation;
+	}
+
+	Allocation Allocator::AllocateBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties)
+	{
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(m_Device, buffer, &memRequirements);
+
+		Allocation allocation = Allocate(memRequirements, properties, AllocationType::Buffer);
+		VK_CHECK(vkBindBufferMemory(m_Device, buffer, allocation.memory, allocation.offset))
+
+		return allocation;
+	}
+
+	Allocation Allocator::AllocateImage(VkImage image, VkMemoryPropertyFlags properties)
+	{
+		VkMemoryRequirements memRequirements;
+		vkGetImageMemoryRequirements(m_Device, image, &memRequirements);
+
+		Allocation allocation = Allocate(memRequirements, properties, AllocationType::Image);
+		VK_CHECK(vkBindImageMemory(m_Device, image, allocation.memory, allocation.offset))
+
+		return allocation;
+	}
+
+	void Allocator::Free(Allocation& allocation)
+	{
+		if (!allocation.block)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		MemoryBlock* block = allocation.block;
+		block->Free(allocation.range);
+
+		if (block->IsEmpty())
+		{
+			// Keep one empty block around per pool to avoid thrashing vkAllocateMemory
+			const auto& pool = m_Pools[block->GetPoolIndex()];
+			bool isDedicated = block->GetSize() != PreferredBlockSize(block->GetMemoryTypeIndex());
+			bool hasOtherEmpty = std::any_of(pool.begin(), pool.end(), [block](const auto& other)
+			{
+				return other.get() != block && other->IsEmpty();
+			});
+
+			if (isDedicated || hasOtherEmpty)
+			{
+				DestroyBlock(block);
+			}
+		}
+
+		allocation = Allocation{};
+	}
+
+	std::vector<BlockStats> Allocator::GetStats() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		std::vector<BlockStats> stats;
+		for (const auto& pool : m_Pools)
+		{
+			for (const auto& block : pool)
+			{
+				stats.push_back(block->GetStats());
+			}
+		}
+
+		return stats;
+	}
+
+	void Allocator::PrintStats() const
+	{
+		std::vector<BlockStats> stats = GetStats();
+
+		std::cout << "Device memory: " << stats.size() << " blocks" << std::endl;
+		for (const auto& block : stats)
+		{
+			std::cout	<< "  type " << block.memoryTypeIndex
+						<< " size " << block.blockSize
+						<< " used " << block.usedBytes
+						<< " allocations " << block.allocationCount
+						<< " free ranges " << block.freeRangeCount
+						<< " largest free " << block.largestFreeRange
+						<< " fragmentation " << block.fragmentation << std::endl;
+		}
+	}
+
+	uint32_t Allocator::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+	{
+		for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; i++)
+		{
+			if ((typeFilter & (1 << i)) && (m_MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+			{
+				return i;
+			}
+		}
+
+		throw std::runtime_error("Error: Failed to find suitable memory type!");
+	}
+
+	uint32_t Allocator::PoolIndex(uint32_t memoryTypeIndex, AllocationType type) const
+	{
+		// With a granularity of 1 buffers and images may be placed next to each other freely
+		bool separateImages = m_BufferImageGranularity > 1 && type == AllocationType::Image;
+		return memoryTypeIndex * 2 + (separateImages ? 1 : 0);
+	}
+
+	VkDeviceSize Allocator::PreferredBlockSize(uint32_t memoryTypeIndex) const
+	{
+		uint32_t heapIndex = m_MemoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+		VkDeviceSize heapSize = m_MemoryProperties.memoryHeaps[heapIndex].size;
+
+		// Small heaps (e.g. the 256MB BAR heap) get proportionally smaller blocks
+		return std::min(DEFAULT_BLOCK_SIZE, heapSize / 8);
+	}
+
+	MemoryBlock* Allocator::CreateBlock(uint32_t memoryTypeIndex, uint32_t poolIndex, VkDeviceSize size)
+	{
+		if (m_AllocationCount >= m_MaxAllocationCount)
+		{
+			throw std::runtime_error("Error: Exceeded maxMemoryAllocationCount!");
+		}
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = size;
+		allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+		VkDeviceMemory memory;
+		if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Error: Failed to allocate device memory block!");
+		}
+		m_AllocationCount++;
+
+		void* mapped = nullptr;
+		if (m_MemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		{
+			// Host visible blocks stay mapped for their whole lifetime
+			VK_CHECK(vkMapMemory(m_Device, memory, 0, VK_WHOLE_SIZE, 0, &mapped))
+		}
+
+		m_Pools[poolIndex].push_back(std::make_unique<MemoryBlock>(memory, size, memoryTypeIndex, poolIndex, mapped));
+		return m_Pools[poolIndex].back().get();
+	}
+
+	void Allocator::DestroyBlock(MemoryBlock* block)
+	{
+		auto& pool = m_Pools[block->GetPoolIndex()];
+
+		if (block->GetMappedData())
+		{
+			vkUnmapMemory(m_Device, block->GetVkDeviceMemory());
+		}
+		vkFreeMemory(m_Device, block->GetVkDeviceMemory(), nullptr);
+		m_AllocationCount--;
+
+		pool.erase(std::remove_if(pool.begin(), pool.end(), [block](const auto& other)
+		{
+			return other.get() == block;
+		}), pool.end());
+	}
+}
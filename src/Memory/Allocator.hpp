@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "MemoryBlock.hpp"
+
+#include <vector>
+#include <memory>
+#include <mutex>
+
+namespace VE
+{
+	enum class AllocationType
+	{
+		Buffer,
+		Image
+	};
+
+	struct Allocation
+	{
+		VkDeviceMemory	memory = VK_NULL_HANDLE;
+		VkDeviceSize	offset = 0;
+		VkDeviceSize	size = 0;
+		void*			mappedData = nullptr;
+		MemoryBlock*	block = nullptr;
+		uint32_t		range = MemoryBlock::INVALID_RANGE;
+	};
+
+	class Allocator
+	{
+	public:
+		Allocator(VkPhysicalDevice physicalDevice, VkDevice device, const VkPhysicalDeviceLimits& limits);
+		~Allocator();
+
+		Allocator(const Allocator& otherAllocator) = delete;
+		Allocator& operator=(const Allocator& otherAllocator) = delete;
+	public:
+		static inline constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+	public:
+		Allocation Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, AllocationType type);
+		Allocation AllocateBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties);
+		Allocation AllocateImage(VkImage image, VkMemoryPropertyFlags properties);
+		void Free(Allocation& allocation);
+		std::vector<BlockStats> GetStats() const;
+		void PrintStats() const;
+	private:
+		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+		uint32_t PoolIndex(uint32_t memoryTypeIndex, AllocationType type) const;
+		VkDeviceSize PreferredBlockSize(uint32_t memoryTypeIndex) const;
+		MemoryBlock* CreateBlock(uint32_t memoryTypeIndex, uint32_t poolIndex, VkDeviceSize size);
+		void DestroyBlock(MemoryBlock* block);
+	private:
+		VkPhysicalDevice									m_PhysicalDevice;
+		VkDevice											m_Device;
+		VkPhysicalDeviceMemoryProperties					m_MemoryProperties;
+		VkDeviceSize										m_BufferImageGranularity;
+		uint32_t											m_MaxAllocationCount;
+		uint32_t											m_AllocationCount;
+		std::vector<std::vector<std::unique_ptr<MemoryBlock>>>	m_Pools;
+		mutable std::mutex									m_Mutex;
+	};
+}
@@ -0,0 +1,306 @@
+#include "MemoryBlock.hpp"
+
+#include <bit>
+#include <cassert>
+#include <algorithm>
+
+namespace VE
+{
+	// Free tails smaller than this stay attached to the allocation instead of becoming a new range
+	static constexpr VkDeviceSize MIN_SPLIT_SIZE = 64;
+
+	MemoryBlock::MemoryBlock(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, uint32_t poolIndex, void* mapped)
+		:	m_Memory(memory), m_Size(size), m_MemoryTypeIndex(memoryTypeIndex),
+			m_PoolIndex(poolIndex), m_Mapped(mapped), m_AllocationCount(0), m_FlBitmap(0)
+	{
+		m_SlBitmaps.fill(0);
+		for (auto& heads : m_FreeHeads)
+		{
+			heads.fill(INVALID_RANGE);
+		}
+
+		uint32_t range = NewRange();
+		m_Ranges[range].offset = 0;
+		m_Ranges[range].size = size;
+		InsertFree(range);
+	}
+
+	uint32_t MemoryBlock::Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize* outOffset)
+	{
+		assert(size > 0 && alignment > 0);
+
+		if (size > m_Size)
+		{
+			return INVALID_RANGE;
+		}
+
+		// Searching for the worst case padding keeps the common path O(1), ranges it skips are checked one by one
+		VkDeviceSize searchSize = size + alignment - 1;
+		uint32_t range = FindFreeRange(searchSize);
+		if (range == INVALID_RANGE)
+		{
+			range = FindFittingRange(size, alignment);
+		}
+		if (range == INVALID_RANGE)
+		{
+			return INVALID_RANGE;
+		}
+
+		RemoveFree(range);
+
+		VkDeviceSize alignedOffset = (m_Ranges[range].offset + alignment - 1) / alignment * alignment;
+		VkDeviceSize padding = alignedOffset - m_Ranges[range].offset;
+
+		if (padding > 0)
+		{
+			uint32_t front = NewRange();
+			m_Ranges[front].offset = m_Ranges[range].offset;
+			m_Ranges[front].size = padding;
+			m_Ranges[front].prevPhysical = m_Ranges[range].prevPhysical;
+			m_Ranges[front].nextPhysical = range;
+			if (m_Ranges[range].prevPhysical != INVALID_RANGE)
+			{
+				m_Ranges[m_Ranges[range].prevPhysical].nextPhysical = front;
+			}
+			m_Ranges[range].prevPhysical = front;
+			m_Ranges[range].offset = alignedOffset;
+			m_Ranges[range].size -= padding;
+			InsertFree(front);
+		}
+
+		if (m_Ranges[range].size - size >= MIN_SPLIT_SIZE)
+		{
+			uint32_t back = NewRange();
+			m_Ranges[back].offset = m_Ranges[range].offset + size;
+			m_Ranges[back].size = m_Ranges[range].size - size;
+			m_Ranges[back].prevPhysical = range;
+			m_Ranges[back].nextPhysical = m_Ranges[range].nextPhysical;
+			if (m_Ranges[range].nextPhysical != INVALID_RANGE)
+			{
+				m_Ranges[m_Ranges[range].nextPhysical].prevPhysical = back;
+			}
+			m_Ranges[range].nextPhysical = back;
+			m_Ranges[range].size = size;
+			InsertFree(back);
+		}
+
+		m_Ranges[range].isFree = false;
+		m_AllocationCount++;
+
+		*outOffset = m_Ranges[range].offset;
+		return range;
+	}
+
+	void MemoryBlock::Free(uint32_t range)
+	{
+		assert(range < m_Ranges.size() && !m_Ranges[range].isFree);
+
+		m_AllocationCount--;
+
+		uint32_t next = m_Ranges[range].nextPhysical;
+		if (next != INVALID_RANGE && m_Ranges[next].isFree)
+		{
+			RemoveFree(next);
+			m_Ranges[range].size += m_Ranges[next].size;
+			m_Ranges[range].nextPhysical = m_Ranges[next].nextPhysical;
+			if (m_Ranges[next].nextPhysical != INVALID_RANGE)
+			{
+				m_Ranges[m_Ranges[next].nextPhysical].prevPhysical = range;
+			}
+			ReleaseRange(next);
+		}
+
+		uint32_t prev = m_Ranges[range].prevPhysical;
+		if (prev != INVALID_RANGE && m_Ranges[prev].isFree)
+		{
+			RemoveFree(prev);
+			m_Ranges[prev].size += m_Ranges[range].size;
+			m_Ranges[prev].nextPhysical = m_Ranges[range].nextPhysical;
+			if (m_Ranges[range].nextPhysical != INVALID_RANGE)
+			{
+				m_Ranges[m_Ranges[range].nextPhysical].prevPhysical = prev;
+			}
+			ReleaseRange(range);
+			range = prev;
+		}
+
+		InsertFree(range);
+	}
+
+	BlockStats MemoryBlock::GetStats() const
+	{
+		BlockStats stats{};
+		stats.memoryTypeIndex = m_MemoryTypeIndex;
+		stats.blockSize = m_Size;
+		stats.allocationCount = m_AllocationCount;
+
+		for (const auto& heads : m_FreeHeads)
+		{
+			for (uint32_t head : heads)
+			{
+				for (uint32_t range = head; range != INVALID_RANGE; range = m_Ranges[range].nextFree)
+				{
+					stats.freeBytes += m_Ranges[range].size;
+					stats.largestFreeRange = std::max(stats.largestFreeRange, m_Ranges[range].size);
+					stats.freeRangeCount++;
+				}
+			}
+		}
+
+		stats.usedBytes = m_Size - stats.freeBytes;
+		stats.fragmentation = stats.freeBytes > 0 ? 1.0f - static_cast<float>(stats.largestFreeRange) / static_cast<float>(stats.freeBytes) : 0.0f;
+
+		return stats;
+	}
+
+	void MemoryBlock::Mapping(VkDeviceSize size, uint32_t* fl, uint32_t* sl) const
+	{
+		if (size < SL_COUNT)
+		{
+			*fl = 0;
+			*sl = static_cast<uint32_t>(size);
+			return;
+		}
+
+		uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+		*fl = msb - SL_BITS + 1;
+		*sl = static_cast<uint32_t>(size >> (msb - SL_BITS)) - SL_COUNT;
+	}
+
+	uint32_t MemoryBlock::FindFreeRange(VkDeviceSize size) const
+	{
+		// Round up to the next list so any range found is guaranteed to be large enough
+		if (size >= SL_COUNT)
+		{
+			uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+			size += (VkDeviceSize(1) << (msb - SL_BITS)) - 1;
+		}
+
+		uint32_t fl, sl;
+		Mapping(size, &fl, &sl);
+
+		if (fl >= FL_COUNT)
+		{
+			return INVALID_RANGE;
+		}
+
+		uint32_t slMap = m_SlBitmaps[fl] & (~0u << sl);
+		if (slMap == 0)
+		{
+			uint64_t flMap = fl + 1 < 64 ? m_FlBitmap & (~uint64_t(0) << (fl + 1)) : 0;
+			if (flMap == 0)
+			{
+				return INVALID_RANGE;
+			}
+
+			fl = static_cast<uint32_t>(std::countr_zero(flMap));
+			slMap = m_SlBitmaps[fl];
+		}
+
+		sl = static_cast<uint32_t>(std::countr_zero(slMap));
+		return m_FreeHeads[fl][sl];
+	}
+
+	uint32_t MemoryBlock::FindFittingRange(VkDeviceSize size, VkDeviceSize alignment) const
+	{
+		// Only the lists between the exact size and the rounded up padded size can hold ranges FindFreeRange skipped,
+		// such as the single range of a dedicated block sized exactly to its resource
+		uint32_t fl, sl, lastFl, lastSl;
+		Mapping(size, &fl, &sl);
+		Mapping(size + alignment - 1, &lastFl, &lastSl);
+		lastFl = std::min(lastFl + 1, FL_COUNT);
+
+		for (; fl < lastFl; fl++, sl = 0)
+		{
+			for (; sl < SL_COUNT; sl++)
+			{
+				for (uint32_t range = m_FreeHeads[fl][sl]; range != INVALID_RANGE; range = m_Ranges[range].nextFree)
+				{
+					VkDeviceSize alignedOffset = (m_Ranges[range].offset + alignment - 1) / alignment * alignment;
+					if (alignedOffset + size <= m_Ranges[range].offset + m_Ranges[range].size)
+					{
+						return range;
+					}
+				}
+			}
+		}
+
+		return INVALID_RANGE;
+	}
+
+	void MemoryBlock::InsertFree(uint32_t range)
+	{
+		uint32_t fl, sl;
+		Mapping(m_Ranges[range].size, &fl, &sl);
+
+		uint32_t head = m_FreeHeads[fl][sl];
+		m_Ranges[range].isFree = true;
+		m_Ranges[range].prevFree = INVALID_RANGE;
+		m_Ranges[range].nextFree = head;
+		if (head != INVALID_RANGE)
+		{
+			m_Ranges[head].prevFree = range;
+		}
+
+		m_FreeHeads[fl][sl] = range;
+		m_FlBitmap |= uint64_t(1) << fl;
+		m_SlBitmaps[fl] |= 1u << sl;
+	}
+
+	void MemoryBlock::RemoveFree(uint32_t range)
+	{
+		uint32_t fl, sl;
+		Mapping(m_Ranges[range].size, &fl, &sl);
+
+		uint32_t prev = m_Ranges[range].prevFree;
+		uint32_t next = m_Ranges[range].nextFree;
+		if (prev != INVALID_RANGE)
+		{
+			m_Ranges[prev].nextFree = next;
+		}
+		if (next != INVALID_RANGE)
+		{
+			m_Ranges[next].prevFree = prev;
+		}
+
+		if (m_FreeHeads[fl][sl] == range)
+		{
+			m_FreeHeads[fl][sl] = next;
+			if (next == INVALID_RANGE)
+			{
+				m_SlBitmaps[fl] &= ~(1u << sl);
+				if (m_SlBitmaps[fl] == 0)
+				{
+					m_FlBitmap &= ~(uint64_t(1) << fl);
+				}
+			}
+		}
+
+		m_Ranges[range].isFree = false;
+		m_Ranges[range].prevFree = INVALID_RANGE;
+		m_Ranges[range].nextFree = INVALID_RANGE;
+	}
+
+	uint32_t MemoryBlock::NewRange()
+	{
+		uint32_t range;
+		if (!m_UnusedRanges.empty())
+		{
+			range = m_UnusedRanges.back();
+			m_UnusedRanges.pop_back();
+		}
+		else
+		{
+			range = static_cast<uint32_t>(m_Ranges.size());
+			m_Ranges.emplace_back();
+		}
+
+		m_Ranges[range] = { 0, 0, INVALID_RANGE, INVALID_RANGE, INVALID_RANGE, INVALID_RANGE, false };
+		return range;
+	}
+
+	void MemoryBlock::ReleaseRange(uint32_t range)
+	{
+		m_UnusedRanges.push_back(range);
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace VE
+{
+	struct BlockStats
+	{
+		uint32_t		memoryTypeIndex;
+		VkDeviceSize	blockSize;
+		VkDeviceSize	usedBytes;
+		VkDeviceSize	freeBytes;
+		VkDeviceSize	largestFreeRange;
+		uint32_t		allocationCount;
+		uint32_t		freeRangeCount;
+		float			fragmentation; // 0 = all free space is contiguous, close to 1 = free space is scattered
+	};
+
+	// Two-level segregated fit (TLSF) bookkeeping for a single VkDeviceMemory block.
+	// Only offsets are tracked here, the memory itself is owned by the Allocator.
+	class MemoryBlock
+	{
+	public:
+		static inline constexpr uint32_t INVALID_RANGE = UINT32_MAX;
+	public:
+		MemoryBlock(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, uint32_t poolIndex, void* mapped);
+		~MemoryBlock() = default;
+
+		MemoryBlock(const MemoryBlock& otherBlock) = delete;
+		MemoryBlock& operator=(const MemoryBlock& otherBlock) = delete;
+	public:
+		inline VkDeviceMemory GetVkDeviceMemory() const { return m_Memory; }
+		inline VkDeviceSize GetSize() const { return m_Size; }
+		inline uint32_t GetMemoryTypeIndex() const { return m_MemoryTypeIndex; }
+		inline uint32_t GetPoolIndex() const { return m_PoolIndex; }
+		inline void* GetMappedData() const { return m_Mapped; }
+		inline bool IsEmpty() const { return m_AllocationCount == 0; }
+	public:
+		// Returns the range handle or INVALID_RANGE when the block can not hold the request
+		uint32_t Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize* outOffset);
+		void Free(uint32_t range);
+		BlockStats GetStats() const;
+	private:
+		struct Range
+		{
+			VkDeviceSize	offset;
+			VkDeviceSize	size;
+			uint32_t		prevPhysical;
+			uint32_t		nextPhysical;
+			uint32_t		prevFree;
+			uint32_t		nextFree;
+			bool			isFree;
+		};
+	private:
+		static inline constexpr uint32_t SL_BITS = 4;
+		static inline constexpr uint32_t SL_COUNT = 1u << SL_BITS;
+		static inline constexpr uint32_t FL_COUNT = 64 - SL_BITS + 1;
+	private:
+		void Mapping(VkDeviceSize size, uint32_t* fl, uint32_t* sl) const;
+		uint32_t FindFreeRange(VkDeviceSize size) const;
+		// Linear fallback for FindFreeRange, returns the first range the aligned request fits into
+		uint32_t FindFittingRange(VkDeviceSize size, VkDeviceSize alignment) const;
+		void InsertFree(uint32_t range);
+		void RemoveFree(uint32_t range);
+		uint32_t NewRange();
+		void ReleaseRange(uint32_t range);
+	private:
+		VkDeviceMemory								m_Memory;
+		VkDeviceSize								m_Size;
+		uint32_t									m_MemoryTypeIndex;
+		uint32_t									m_PoolIndex;
+		void*										m_Mapped;
+		uint32_t									m_AllocationCount;
+		std::vector<Range>							m_Ranges;
+		std::vector<uint32_t>						m_UnusedRanges;
+		uint64_t									m_FlBitmap;
+		std::array<uint32_t, FL_COUNT>				m_SlBitmaps;
+		std::array<std::array<uint32_t, SL_COUNT>, FL_COUNT> m_FreeHeads;
+	};
+}
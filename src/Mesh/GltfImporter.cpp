@@ -0,0 +1,533 @@
+#include "GltfImporter.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+namespace VE
+{
+	static constexpr uint32_t COMPONENT_BYTE = 5120;
+	static constexpr uint32_t COMPONENT_UNSIGNED_BYTE = 5121;
+	static constexpr uint32_t COMPONENT_SHORT = 5122;
+	static constexpr uint32_t COMPONENT_UNSIGNED_SHORT = 5123;
+	static constexpr uint32_t COMPONENT_UNSIGNED_INT = 5125;
+	static constexpr uint32_t COMPONENT_FLOAT = 5126;
+	static constexpr uint32_t MODE_TRIANGLES = 4;
+	static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+	static uint32_t ComponentSize(uint32_t componentType)
+	{
+		switch (componentType)
+		{
+		case COMPONENT_BYTE:
+		case COMPONENT_UNSIGNED_BYTE:	return 1;
+		case COMPONENT_SHORT:
+		case COMPONENT_UNSIGNED_SHORT:	return 2;
+		case COMPONENT_UNSIGNED_INT:
+		case COMPONENT_FLOAT:			return 4;
+		default:						throw std::runtime_error("Error: Unsupported glTF component type " + std::to_string(componentType));
+		}
+	}
+
+	static uint32_t ComponentCount(const std::string& type)
+	{
+		if (type == "SCALAR")	return 1;
+		if (type == "VEC2")		return 2;
+		if (type == "VEC3")		return 3;
+		if (type == "VEC4")		return 4;
+		throw std::runtime_error("Error: Unsupported glTF accessor type " + type);
+	}
+
+	// Relative URIs may be percent encoded, e.g. spaces as %20
+	static std::string DecodeUri(const std::string& uri)
+	{
+		std::string result;
+		for (size_t i = 0; i < uri.size(); i++)
+		{
+			if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit(static_cast<unsigned char>(uri[i + 1])) && std::isxdigit(static_cast<unsigned char>(uri[i + 2])))
+			{
+				result.push_back(static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16)));
+				i += 2;
+			}
+			else
+			{
+				result.push_back(uri[i]);
+			}
+		}
+		return result;
+	}
+
+	static std::string ResolveUri(std::string_view filepath, const std::string& uri)
+	{
+		return (std::filesystem::path(filepath).parent_path() / std::filesystem::path(DecodeUri(uri))).string();
+	}
+
+	static glm::mat4 NodeTransform(const JsonValue& node)
+	{
+		const JsonValue& matrix = node["matrix"];
+		if (matrix.Size() == 16)
+		{
+			// Column major, like glm
+			glm::mat4 result(1.0f);
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				result[i / 4][i % 4] = static_cast<float>(matrix[i].AsNumber());
+			}
+			return result;
+		}
+
+		const JsonValue& t = node["translation"];
+		const JsonValue& r = node["rotation"];
+		const JsonValue& s = node["scale"];
+
+		glm::vec3 translation(t[0].AsNumber(0.0), t[1].AsNumber(0.0), t[2].AsNumber(0.0));
+		glm::quat rotation(static_cast<float>(r[3].AsNumber(1.0)), static_cast<float>(r[0].AsNumber(0.0)), static_cast<float>(r[1].AsNumber(0.0)), static_cast<float>(r[2].AsNumber(0.0)));
+		glm::vec3 scale(s[0].AsNumber(1.0), s[1].AsNumber(1.0), s[2].AsNumber(1.0));
+
+		return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+	}
+
+	bool GltfImporter::CanImport(std::string_view filepath)
+	{
+		std::string extension = std::filesystem::path(filepath).extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return extension == ".glb" || extension == ".gltf";
+	}
+
+	void GltfImporter::Open(std::string_view filepath, Document& document)
+	{
+		std::string path(filepath);
+		if (!document.file.Open(path))
+		{
+			throw std::runtime_error("Error: Failed to open " + path);
+		}
+
+		const uint8_t* data = document.file.GetData();
+		size_t size = document.file.GetSize();
+
+		uint32_t magic = 0;
+		if (size >= sizeof(uint32_t))
+		{
+			std::memcpy(&magic, data, sizeof(magic));
+		}
+
+		std::string_view jsonText(reinterpret_cast<const char*>(data), size);
+		std::span<const uint8_t> binChunk;
+		bool isBinary = magic == GLB_MAGIC;
+
+		if (isBinary)
+		{
+			uint32_t header[3] = {};
+			if (size < sizeof(header))
+			{
+				throw std::runtime_error("Error: Truncated GLB header in " + path);
+			}
+			std::memcpy(header, data, sizeof(header));
+
+			if (header[1] != 2 || header[2] > size)
+			{
+				throw std::runtime_error("Error: Unsupported GLB version or truncated file " + path);
+			}
+
+			jsonText = {};
+			size_t offset = sizeof(header);
+			while (offset + 2 * sizeof(uint32_t) <= header[2])
+			{
+				uint32_t chunk[2];
+				std::memcpy(chunk, data + offset, sizeof(chunk));
+				offset += sizeof(chunk);
+
+				if (chunk[0] > header[2] - offset)
+				{
+					throw std::runtime_error("Error: Truncated GLB chunk in " + path);
+				}
+
+				// The JSON chunk comes first, the BIN chunk, if any, second. Unknown chunks are skipped
+				if (chunk[1] == GLB_CHUNK_JSON && jsonText.empty())
+				{
+					jsonText = std::string_view(reinterpret_cast<const char*>(data + offset), chunk[0]);
+				}
+				else if (chunk[1] == GLB_CHUNK_BIN && binChunk.empty())
+				{
+					binChunk = std::span<const uint8_t>(data + offset, chunk[0]);
+				}
+				offset += chunk[0];
+			}
+
+			if (jsonText.empty())
+			{
+				throw std::runtime_error("Error: Missing JSON chunk in " + path);
+			}
+		}
+
+		document.json = JsonValue::Parse(jsonText);
+
+		if (document.json["asset"]["version"].AsString().rfind("2.", 0) != 0)
+		{
+			throw std::runtime_error("Error: Only glTF 2.x is supported, " + path);
+		}
+
+		const JsonValue& buffers = document.json["buffers"];
+		for (size_t i = 0; i < buffers.Size(); i++)
+		{
+			const JsonValue& buffer = buffers[i];
+			const std::string& uri = buffer["uri"].AsString();
+			std::span<const uint8_t> contents;
+
+			if (uri.empty() && i == 0 && isBinary)
+			{
+				contents = binChunk;
+			}
+			else if (!uri.empty() && uri.rfind("data:", 0) != 0)
+			{
+				auto bufferFile = std::make_unique<MappedFile>();
+				std::string bufferPath = ResolveUri(filepath, uri);
+				if (!bufferFile->Open(bufferPath))
+				{
+					throw std::runtime_error("Error: Failed to open glTF buffer " + bufferPath);
+				}
+				contents = std::span<const uint8_t>(bufferFile->GetData(), bufferFile->GetSize());
+				document.externalBuffers.push_back(std::move(bufferFile));
+			}
+			else
+			{
+				throw std::runtime_error("Error: Unsupported glTF buffer " + std::to_string(i) + " in " + path);
+			}
+
+			// The BIN chunk may be padded past byteLength
+			size_t byteLength = buffer["byteLength"].AsUint(0);
+			if (byteLength > contents.size())
+			{
+				throw std::runtime_error("Error: glTF buffer " + std::to_string(i) + " is shorter than its byteLength in " + path);
+			}
+			document.buffers.push_back(contents.first(byteLength));
+		}
+	}
+
+	std::span<const uint8_t> GltfImporter::GetBufferView(const Document& document, uint32_t index)
+	{
+		const JsonValue& view = document.json["bufferViews"][index];
+		uint32_t buffer = view["buffer"].AsUint(INVALID_INDEX);
+		uint64_t offset = view["byteOffset"].AsUint(0);
+		uint64_t length = view["byteLength"].AsUint(0);
+
+		if (buffer >= document.buffers.size() || offset + length > document.buffers[buffer].size())
+		{
+			throw std::runtime_error("Error: Invalid glTF buffer view " + std::to_string(index));
+		}
+
+		return document.buffers[buffer].subspan(offset, length);
+	}
+
+	GltfImporter::Accessor GltfImporter::GetAccessor(const Document& document, uint32_t index)
+	{
+		const JsonValue& accessor = document.json["accessors"][index];
+		if (!accessor.IsObject() || accessor.Has("sparse") || !accessor.Has("bufferView"))
+		{
+			throw std::runtime_error("Error: Missing or unsupported glTF accessor " + std::to_string(index));
+		}
+
+		uint32_t viewIndex = accessor["bufferView"].AsUint(INVALID_INDEX);
+		std::span<const uint8_t> view = GetBufferView(document, viewIndex);
+
+		Accessor result{};
+		result.count = accessor["count"].AsUint(0);
+		result.componentType = accessor["componentType"].AsUint(0);
+		result.componentCount = ComponentCount(accessor["type"].AsString());
+		result.elementSize = ComponentSize(result.componentType) * result.componentCount;
+		result.stride = document.json["bufferViews"][viewIndex]["byteStride"].AsUint(result.elementSize);
+		result.normalized = accessor["normalized"].AsBool(false);
+
+		uint64_t offset = accessor["byteOffset"].AsUint(0);
+		uint64_t end = offset + (result.count > 0 ? static_cast<uint64_t>(result.count - 1) * result.stride + result.elementSize : 0);
+		if (end > view.size())
+		{
+			throw std::runtime_error("Error: glTF accessor " + std::to_string(index) + " exceeds its buffer view");
+		}
+
+		result.data = view.data() + offset;
+		return result;
+	}
+
+	void GltfImporter::ImportPrimitive(const Document& document, const JsonValue& primitive, const glm::mat4& transform, MeshData& mesh)
+	{
+		const JsonValue& attributes = primitive["attributes"];
+
+		// Points, lines and strips are skipped, as are primitives without positions
+		if (primitive["mode"].AsUint(MODE_TRIANGLES) != MODE_TRIANGLES || !attributes.Has("POSITION"))
+		{
+			return;
+		}
+
+		Accessor positions = GetAccessor(document, attributes["POSITION"].AsUint(INVALID_INDEX));
+		if (positions.componentType != COMPONENT_FLOAT || positions.componentCount != 3)
+		{
+			throw std::runtime_error("Error: glTF positions have to be float3");
+		}
+
+		uint32_t baseVertex = static_cast<uint32_t>(mesh.vertices.size());
+		uint32_t vertexCount = positions.count;
+		mesh.vertices.resize(static_cast<size_t>(baseVertex) + vertexCount);
+		Vertex* vertices = mesh.vertices.data() + baseVertex;
+
+		bool isIdentity = transform == glm::mat4(1.0f);
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			glm::vec3 position;
+			std::memcpy(&position, positions.data + static_cast<size_t>(i) * positions.stride, sizeof(position));
+
+			vertices[i].position = isIdentity ? position : glm::vec3(transform * glm::vec4(position, 1.0f));
+			vertices[i].color = glm::vec3(1.0f);
+		}
+
+		if (attributes.Has("NORMAL"))
+		{
+			Accessor normals = GetAccessor(document, attributes["NORMAL"].AsUint(INVALID_INDEX));
+			if (normals.componentType != COMPONENT_FLOAT || normals.componentCount != 3 || normals.count != vertexCount)
+			{
+				throw std::runtime_error("Error: glTF normals have to be float3 and match the position count");
+			}
+
+			// Earlier primitives without normals are padded with zero, which Finalize replaces by derived ones
+			mesh.normals.resize(static_cast<size_t>(baseVertex) + vertexCount, glm::vec3(0.0f));
+			glm::mat3 normalTransform = glm::transpose(glm::inverse(glm::mat3(transform)));
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				glm::vec3 normal;
+				std::memcpy(&normal, normals.data + static_cast<size_t>(i) * normals.stride, sizeof(normal));
+
+				normal = isIdentity ? normal : normalTransform * normal;
+				mesh.normals[baseVertex + i] = glm::length(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0f);
+			}
+		}
+		else if (!mesh.normals.empty())
+		{
+			mesh.normals.resize(static_cast<size_t>(baseVertex) + vertexCount, glm::vec3(0.0f));
+		}
+
+		if (attributes.Has("TEXCOORD_0"))
+		{
+			// glTF's UV origin is the top left like Vulkan's, unlike OBJ no flip is needed
+			Accessor texCoords = GetAccessor(document, attributes["TEXCOORD_0"].AsUint(INVALID_INDEX));
+			if (texCoords.componentCount != 2 || texCoords.count != vertexCount)
+			{
+				throw std::runtime_error("Error: glTF texture coordinates have to be 2 component and match the position count");
+			}
+
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				const uint8_t* element = texCoords.data + static_cast<size_t>(i) * texCoords.stride;
+				switch (texCoords.componentType)
+				{
+				case COMPONENT_FLOAT:
+					std::memcpy(&vertices[i].texCoords, element, sizeof(glm::vec2));
+					break;
+				case COMPONENT_UNSIGNED_BYTE:
+					vertices[i].texCoords = glm::vec2(element[0], element[1]) / 255.0f;
+					break;
+				case COMPONENT_UNSIGNED_SHORT:
+				{
+					uint16_t uv[2];
+					std::memcpy(uv, element, sizeof(uv));
+					vertices[i].texCoords = glm::vec2(uv[0], uv[1]) / 65535.0f;
+					break;
+				}
+				default:
+					throw std::runtime_error("Error: Unsupported glTF texture coordinate type");
+				}
+			}
+		}
+
+		uint32_t firstIndex = static_cast<uint32_t>(mesh.indices.size());
+		uint32_t indexCount = vertexCount;
+
+		if (primitive.Has("indices"))
+		{
+			Accessor indices = GetAccessor(document, primitive["indices"].AsUint(INVALID_INDEX));
+			if (indices.componentCount != 1)
+			{
+				throw std::runtime_error("Error: glTF indices have to be scalars");
+			}
+
+			indexCount = indices.count;
+			mesh.indices.resize(static_cast<size_t>(firstIndex) + indexCount);
+			uint32_t* dst = mesh.indices.data() + firstIndex;
+
+			// Tightly packed 32 bit indices are copied as a block, narrower or strided ones are widened
+			if (indices.componentType == COMPONENT_UNSIGNED_INT && indices.stride == sizeof(uint32_t))
+			{
+				std::memcpy(dst, indices.data, static_cast<size_t>(indexCount) * sizeof(uint32_t));
+			}
+			else
+			{
+				for (uint32_t i = 0; i < indexCount; i++)
+				{
+					const uint8_t* element = indices.data + static_cast<size_t>(i) * indices.stride;
+					switch (indices.componentType)
+					{
+					case COMPONENT_UNSIGNED_BYTE:	dst[i] = element[0]; break;
+					case COMPONENT_UNSIGNED_SHORT:	{ uint16_t index; std::memcpy(&index, element, sizeof(index)); dst[i] = index; break; }
+					case COMPONENT_UNSIGNED_INT:	std::memcpy(&dst[i], element, sizeof(uint32_t)); break;
+					default:						throw std::runtime_error("Error: Unsupported glTF index type");
+					}
+				}
+			}
+
+			for (uint32_t i = 0; i < indexCount; i++)
+			{
+				if (dst[i] >= vertexCount)
+				{
+					throw std::runtime_error("Error: glTF index out of range");
+				}
+				dst[i] += baseVertex;
+			}
+		}
+		else
+		{
+			mesh.indices.resize(static_cast<size_t>(firstIndex) + indexCount);
+			for (uint32_t i = 0; i < indexCount; i++)
+			{
+				mesh.indices[firstIndex + i] = baseVertex + i;
+			}
+		}
+
+		// A trailing partial triangle is dropped
+		uint32_t partial = indexCount % 3;
+		mesh.indices.resize(mesh.indices.size() - partial);
+		indexCount -= partial;
+
+		// Mirroring transforms turn the triangles inside out, swapping two corners restores the authored winding
+		if (glm::determinant(transform) < 0.0f)
+		{
+			for (uint32_t i = firstIndex; i < firstIndex + indexCount; i += 3)
+			{
+				std::swap(mesh.indices[i + 1], mesh.indices[i + 2]);
+			}
+		}
+
+		if (indexCount > 0)
+		{
+			mesh.submeshes.push_back({ firstIndex, indexCount, primitive["material"].AsUint(INVALID_INDEX) });
+		}
+	}
+
+	MeshData GltfImporter::Import(std::string_view filepath, const ImportSettings& settings)
+	{
+		Document document;
+		Open(filepath, document);
+
+		MeshData mesh;
+		const JsonValue& json = document.json;
+		const JsonValue& scene = json["scenes"][json["scene"].AsUint(0)];
+
+		if (scene.IsObject())
+		{
+			struct PendingNode
+			{
+				uint32_t	index;
+				glm::mat4	parentTransform;
+				uint32_t	depth;
+			};
+
+			std::vector<PendingNode> stack;
+			for (size_t i = 0; i < scene["nodes"].Size(); i++)
+			{
+				stack.push_back({ scene["nodes"][i].AsUint(INVALID_INDEX), glm::mat4(1.0f), 0 });
+			}
+
+			while (!stack.empty())
+			{
+				PendingNode pending = stack.back();
+				stack.pop_back();
+
+				// Node graphs are required to be acyclic, the depth limit guards against files that aren't
+				const JsonValue& node = json["nodes"][pending.index];
+				if (!node.IsObject() || pending.depth >= MAX_NODE_DEPTH)
+				{
+					throw std::runtime_error("Error: Invalid glTF node hierarchy in " + std::string(filepath));
+				}
+
+				glm::mat4 transform = pending.parentTransform * NodeTransform(node);
+
+				if (node.Has("mesh"))
+				{
+					const JsonValue& primitives = json["meshes"][node["mesh"].AsUint(INVALID_INDEX)]["primitives"];
+					for (size_t i = 0; i < primitives.Size(); i++)
+					{
+						ImportPrimitive(document, primitives[i], transform, mesh);
+					}
+				}
+
+				const JsonValue& children = node["children"];
+				for (size_t i = 0; i < children.Size(); i++)
+				{
+					stack.push_back({ children[i].AsUint(INVALID_INDEX), transform, pending.depth + 1 });
+				}
+			}
+		}
+		else
+		{
+			// Files without scenes are libraries of meshes, every mesh is imported untransformed
+			const JsonValue& meshes = json["meshes"];
+			for (size_t i = 0; i < meshes.Size(); i++)
+			{
+				const JsonValue& primitives = meshes[i]["primitives"];
+				for (size_t j = 0; j < primitives.Size(); j++)
+				{
+					ImportPrimitive(document, primitives[j], glm::mat4(1.0f), mesh);
+				}
+			}
+		}
+
+		if (mesh.indices.empty())
+		{
+			throw std::runtime_error("Error: No triangles in " + std::string(filepath));
+		}
+
+		return mesh;
+	}
+
+	std::vector<MeshMaterial> GltfImporter::ImportMaterials(std::string_view filepath)
+	{
+		Document document;
+		Open(filepath, document);
+
+		const JsonValue& json = document.json;
+		const JsonValue& materials = json["materials"];
+		std::vector<MeshMaterial> result(materials.Size());
+
+		for (size_t i = 0; i < materials.Size(); i++)
+		{
+			uint32_t texture = materials[i]["pbrMetallicRoughness"]["baseColorTexture"]["index"].AsUint(INVALID_INDEX);
+			if (texture == INVALID_INDEX)
+			{
+				continue;
+			}
+
+			const JsonValue& image = json["images"][json["textures"][texture]["source"].AsUint(INVALID_INDEX)];
+			const std::string& uri = image["uri"].AsString();
+
+			if (image.Has("bufferView"))
+			{
+				std::span<const uint8_t> encoded = GetBufferView(document, image["bufferView"].AsUint(INVALID_INDEX));
+				result[i].baseColorData.assign(encoded.begin(), encoded.end());
+			}
+			else if (!uri.empty() && uri.rfind("data:", 0) != 0)
+			{
+				result[i].baseColorPath = ResolveUri(filepath, uri);
+			}
+			else
+			{
+				std::cerr << "Warning: Unsupported base color image of material " << i << " in " << filepath << std::endl;
+			}
+		}
+
+		return result;
+	}
+}
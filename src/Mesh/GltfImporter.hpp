@@ -0,0 +1,54 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include "MappedFile.hpp"
+#include "Json.hpp"
+
+#include <string_view>
+#include <vector>
+#include <memory>
+
+namespace VE
+{
+	// Imports the triangle primitives of a glTF 2.0 file's default scene with node transforms baked in,
+	// one submesh per primitive. Binary .glb files are mapped and their BIN chunk read in place, external
+	// buffers of .gltf files are mapped as well. Sparse accessors and data URIs are not supported.
+	class GltfImporter
+	{
+	public:
+		static inline constexpr uint32_t GLB_MAGIC = 0x46546C67; // "glTF"
+		static inline constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+		static inline constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;
+		static inline constexpr uint32_t MAX_NODE_DEPTH = 64;
+	public:
+		static bool CanImport(std::string_view filepath);
+		// Returns the mesh with 32 bit indices, MeshData::Finalize is left to the caller
+		static MeshData Import(std::string_view filepath, const ImportSettings& settings);
+		// Indexed by SubMesh::material, only reads the JSON and embedded images so it is cheap next to a cooked mesh
+		static std::vector<MeshMaterial> ImportMaterials(std::string_view filepath);
+	private:
+		struct Document
+		{
+			MappedFile								file;
+			JsonValue								json;
+			std::vector<std::unique_ptr<MappedFile>>	externalBuffers;
+			std::vector<std::span<const uint8_t>>	buffers;
+		};
+
+		struct Accessor
+		{
+			const uint8_t*	data;
+			uint32_t		count;
+			uint32_t		componentType;
+			uint32_t		componentCount;
+			uint32_t		elementSize;
+			uint32_t		stride;
+			bool			normalized;
+		};
+	private:
+		static void Open(std::string_view filepath, Document& document);
+		static Accessor GetAccessor(const Document& document, uint32_t index);
+		static std::span<const uint8_t> GetBufferView(const Document& document, uint32_t index);
+		static void ImportPrimitive(const Document& document, const JsonValue& primitive, const glm::mat4& transform, MeshData& mesh);
+	};
+}
@@ -0,0 +1,340 @@
+#include "Json.hpp"
+
+#include <charconv>
+#include <stdexcept>
+
+namespace VE
+{
+	static const JsonValue NULL_VALUE{};
+	static const std::string EMPTY_STRING{};
+
+	class JsonValue::Parser
+	{
+	public:
+		explicit Parser(std::string_view text)
+			:	m_Text(text), m_Position(0)
+		{
+		}
+
+		JsonValue ParseDocument()
+		{
+			JsonValue value = ParseValue(0);
+			SkipWhitespace();
+			if (m_Position != m_Text.size())
+			{
+				Fail("unexpected trailing characters");
+			}
+			return value;
+		}
+	private:
+		[[noreturn]] void Fail(const char* message) const
+		{
+			throw std::runtime_error("Error: Invalid JSON at offset " + std::to_string(m_Position) + ": " + message);
+		}
+
+		void SkipWhitespace()
+		{
+			while (m_Position < m_Text.size())
+			{
+				char c = m_Text[m_Position];
+				if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+				{
+					break;
+				}
+				m_Position++;
+			}
+		}
+
+		char Peek()
+		{
+			SkipWhitespace();
+			if (m_Position >= m_Text.size())
+			{
+				Fail("unexpected end of input");
+			}
+			return m_Text[m_Position];
+		}
+
+		void Expect(char c)
+		{
+			if (Peek() != c)
+			{
+				Fail("unexpected character");
+			}
+			m_Position++;
+		}
+
+		bool ConsumeLiteral(std::string_view literal)
+		{
+			if (m_Text.substr(m_Position, literal.size()) != literal)
+			{
+				return false;
+			}
+			m_Position += literal.size();
+			return true;
+		}
+
+		JsonValue ParseValue(uint32_t depth)
+		{
+			if (depth > MAX_DEPTH)
+			{
+				Fail("nesting too deep");
+			}
+
+			JsonValue value;
+			char c = Peek();
+
+			if (c == '{')
+			{
+				m_Position++;
+				value.m_Type = Type::Object;
+				if (Peek() == '}')
+				{
+					m_Position++;
+					return value;
+				}
+				while (true)
+				{
+					if (Peek() != '"')
+					{
+						Fail("expected object key");
+					}
+					std::string key = ParseString();
+					Expect(':');
+					value.m_Object.emplace_back(std::move(key), ParseValue(depth + 1));
+
+					c = Peek();
+					m_Position++;
+					if (c == '}')
+					{
+						return value;
+					}
+					if (c != ',')
+					{
+						Fail("expected ',' or '}'");
+					}
+				}
+			}
+
+			if (c == '[')
+			{
+				m_Position++;
+				value.m_Type = Type::Array;
+				if (Peek() == ']')
+				{
+					m_Position++;
+					return value;
+				}
+				while (true)
+				{
+					value.m_Array.push_back(ParseValue(depth + 1));
+
+					c = Peek();
+					m_Position++;
+					if (c == ']')
+					{
+						return value;
+					}
+					if (c != ',')
+					{
+						Fail("expected ',' or ']'");
+					}
+				}
+			}
+
+			if (c == '"')
+			{
+				value.m_Type = Type::String;
+				value.m_String = ParseString();
+				return value;
+			}
+
+			if (ConsumeLiteral("true"))
+			{
+				value.m_Type = Type::Bool;
+				value.m_Bool = true;
+				return value;
+			}
+
+			if (ConsumeLiteral("false"))
+			{
+				value.m_Type = Type::Bool;
+				return value;
+			}
+
+			if (ConsumeLiteral("null"))
+			{
+				return value;
+			}
+
+			const char* begin = m_Text.data() + m_Position;
+			const char* end = m_Text.data() + m_Text.size();
+			auto [next, error] = std::from_chars(begin, end, value.m_Number);
+			if (error != std::errc() || next == begin)
+			{
+				Fail("unexpected character");
+			}
+			value.m_Type = Type::Number;
+			m_Position += next - begin;
+			return value;
+		}
+
+		std::string ParseString()
+		{
+			// Opening quote was checked by the caller
+			m_Position++;
+
+			std::string result;
+			while (true)
+			{
+				if (m_Position >= m_Text.size())
+				{
+					Fail("unterminated string");
+				}
+
+				char c = m_Text[m_Position++];
+				if (c == '"')
+				{
+					return result;
+				}
+				if (c != '\\')
+				{
+					result.push_back(c);
+					continue;
+				}
+
+				if (m_Position >= m_Text.size())
+				{
+					Fail("unterminated string");
+				}
+
+				char escape = m_Text[m_Position++];
+				switch (escape)
+				{
+				case '"':	result.push_back('"'); break;
+				case '\\':	result.push_back('\\'); break;
+				case '/':	result.push_back('/'); break;
+				case 'b':	result.push_back('\b'); break;
+				case 'f':	result.push_back('\f'); break;
+				case 'n':	result.push_back('\n'); break;
+				case 'r':	result.push_back('\r'); break;
+				case 't':	result.push_back('\t'); break;
+				case 'u':	AppendCodePoint(result, ParseCodePoint()); break;
+				default:	Fail("invalid escape");
+				}
+			}
+		}
+
+		uint32_t ParseHex4()
+		{
+			if (m_Position + 4 > m_Text.size())
+			{
+				Fail("truncated unicode escape");
+			}
+
+			uint32_t value = 0;
+			auto [next, error] = std::from_chars(m_Text.data() + m_Position, m_Text.data() + m_Position + 4, value, 16);
+			if (error != std::errc() || next != m_Text.data() + m_Position + 4)
+			{
+				Fail("invalid unicode escape");
+			}
+			m_Position += 4;
+			return value;
+		}
+
+		uint32_t ParseCodePoint()
+		{
+			uint32_t codePoint = ParseHex4();
+
+			// Characters outside the BMP are escaped as a surrogate pair
+			if (codePoint >= 0xD800 && codePoint <= 0xDBFF && ConsumeLiteral("\\u"))
+			{
+				uint32_t low = ParseHex4();
+				if (low < 0xDC00 || low > 0xDFFF)
+				{
+					Fail("invalid surrogate pair");
+				}
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+			}
+			return codePoint;
+		}
+
+		static void AppendCodePoint(std::string& result, uint32_t codePoint)
+		{
+			if (codePoint < 0x80)
+			{
+				result.push_back(static_cast<char>(codePoint));
+			}
+			else if (codePoint < 0x800)
+			{
+				result.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+				result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+			else if (codePoint < 0x10000)
+			{
+				result.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+				result.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+				result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+			else
+			{
+				result.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+				result.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+				result.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+				result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+		}
+	private:
+		std::string_view	m_Text;
+		size_t				m_Position;
+	};
+
+	JsonValue JsonValue::Parse(std::string_view text)
+	{
+		return Parser(text).ParseDocument();
+	}
+
+	const JsonValue& JsonValue::operator[](std::string_view key) const
+	{
+		for (const auto& [name, value] : m_Object)
+		{
+			if (name == key)
+			{
+				return value;
+			}
+		}
+		return NULL_VALUE;
+	}
+
+	const JsonValue& JsonValue::operator[](size_t index) const
+	{
+		return index < m_Array.size() ? m_Array[index] : NULL_VALUE;
+	}
+
+	bool JsonValue::Has(std::string_view key) const
+	{
+		return !(*this)[key].IsNull();
+	}
+
+	double JsonValue::AsNumber(double fallback) const
+	{
+		return m_Type == Type::Number ? m_Number : fallback;
+	}
+
+	uint32_t JsonValue::AsUint(uint32_t fallback) const
+	{
+		// Negative, fractional or oversized values are treated as absent
+		bool isUint = m_Type == Type::Number && m_Number >= 0.0 && m_Number <= 4294967295.0 && m_Number == static_cast<double>(static_cast<uint32_t>(m_Number));
+		return isUint ? static_cast<uint32_t>(m_Number) : fallback;
+	}
+
+	bool JsonValue::AsBool(bool fallback) const
+	{
+		return m_Type == Type::Bool ? m_Bool : fallback;
+	}
+
+	const std::string& JsonValue::AsString() const
+	{
+		return m_Type == Type::String ? m_String : EMPTY_STRING;
+	}
+}
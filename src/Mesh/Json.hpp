@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+namespace VE
+{
+	// Minimal read-only JSON document, enough for glTF. Lookups of missing keys or out of range
+	// elements return a null value so optional properties can be read without checks.
+	class JsonValue
+	{
+	public:
+		enum class Type
+		{
+			Null,
+			Bool,
+			Number,
+			String,
+			Array,
+			Object
+		};
+	public:
+		JsonValue() = default;
+	public:
+		static inline constexpr uint32_t MAX_DEPTH = 128;
+	public:
+		// Throws on malformed input
+		static JsonValue Parse(std::string_view text);
+	public:
+		inline Type GetType() const { return m_Type; }
+		inline bool IsNull() const { return m_Type == Type::Null; }
+		inline bool IsNumber() const { return m_Type == Type::Number; }
+		inline bool IsString() const { return m_Type == Type::String; }
+		inline bool IsArray() const { return m_Type == Type::Array; }
+		inline bool IsObject() const { return m_Type == Type::Object; }
+		inline size_t Size() const { return m_Type == Type::Array ? m_Array.size() : m_Type == Type::Object ? m_Object.size() : 0; }
+
+		const JsonValue& operator[](std::string_view key) const;
+		const JsonValue& operator[](size_t index) const;
+		bool Has(std::string_view key) const;
+
+		double AsNumber(double fallback = 0.0) const;
+		uint32_t AsUint(uint32_t fallback = 0) const;
+		bool AsBool(bool fallback = false) const;
+		const std::string& AsString() const;
+	private:
+		class Parser;
+	private:
+		Type											m_Type = Type::Null;
+		bool											m_Bool = false;
+		double											m_Number = 0.0;
+		std::string										m_String;
+		std::vector<JsonValue>							m_Array;
+		std::vector<std::pair<std::string, JsonValue>>	m_Object;
+	};
+}
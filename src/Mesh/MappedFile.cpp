@@ -0,0 +1,124 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace VE
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(const std::string& filepath)
+	{
+		Close();
+
+		HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		m_File = file;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+
+		m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_Mapping)
+		{
+			Close();
+			return false;
+		}
+
+		m_Data = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!m_Data)
+		{
+			Close();
+			return false;
+		}
+
+		m_Size = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data)
+		{
+			UnmapViewOfFile(m_Data);
+		}
+		if (m_Mapping)
+		{
+			CloseHandle(m_Mapping);
+		}
+		if (m_File)
+		{
+			CloseHandle(m_File);
+		}
+
+		m_Data = nullptr;
+		m_Size = 0;
+		m_Mapping = nullptr;
+		m_File = nullptr;
+	}
+#else
+	bool MappedFile::Open(const std::string& filepath)
+	{
+		Close();
+
+		m_File = open(filepath.c_str(), O_RDONLY);
+		if (m_File < 0)
+		{
+			return false;
+		}
+
+		struct stat info{};
+		if (fstat(m_File, &info) != 0 || info.st_size == 0)
+		{
+			Close();
+			return false;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_File, 0);
+		if (data == MAP_FAILED)
+		{
+			Close();
+			return false;
+		}
+
+		m_Data = static_cast<const uint8_t*>(data);
+		m_Size = static_cast<size_t>(info.st_size);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data)
+		{
+			munmap(const_cast<uint8_t*>(m_Data), m_Size);
+		}
+		if (m_File >= 0)
+		{
+			close(m_File);
+		}
+
+		m_Data = nullptr;
+		m_Size = 0;
+		m_File = -1;
+	}
+#endif
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace VE
+{
+	// Read-only memory mapping of a whole file, the view stays valid for the lifetime of the object
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile& otherFile) = delete;
+		MappedFile& operator=(const MappedFile& otherFile) = delete;
+	public:
+		inline const uint8_t* GetData() const { return m_Data; }
+		inline size_t GetSize() const { return m_Size; }
+		inline bool IsOpen() const { return m_Data != nullptr; }
+	public:
+		bool Open(const std::string& filepath);
+		void Close();
+	private:
+		const uint8_t*	m_Data = nullptr;
+		size_t			m_Size = 0;
+	#ifdef _WIN32
+		void*			m_File = nullptr;
+		void*			m_Mapping = nullptr;
+	#else
+		int				m_File = -1;
+	#endif
+	};
+}
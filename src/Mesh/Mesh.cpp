@@ -0,0 +1,123 @@
+#include "Mesh.hpp"
+
+#include "MeshCache.hpp"
+#include "ObjImporter.hpp"
+#include "GltfImporter.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "MeshletBuilder.hpp"
+
+#include <string>
+#include <algorithm>
+
+namespace VE
+{
+	Mesh::Mesh(Device* device)
+		:	m_Device(device), m_Bounds{}, m_VertexTransform(glm::mat4(1.0f)), m_MeshletCount(0), m_MaterialCount(0), m_UploadToken(0), m_IsUploaded(false)
+	{
+	}
+
+	Mesh::~Mesh()
+	{
+		// Destination buffers must outlive the copies writing to them
+		m_Device->GetUploadContext().Wait(m_UploadToken);
+		m_Device->GetGeometryPool().Free(m_Geometry);
+	}
+
+	std::unique_ptr<MeshSource> Mesh::Decode(std::string_view filePath, const ImportSettings& importSettings)
+	{
+		auto source = std::make_unique<MeshSource>();
+		std::string path(filePath);
+		bool isGltf = GltfImporter::CanImport(path);
+
+		if (!MeshCache::Load(path, importSettings, source->cookedFile, source->view))
+		{
+			MeshData& mesh = source->mesh;
+			mesh = isGltf ? GltfImporter::Import(path, importSettings) : ObjImporter::Import(path, importSettings);
+			if (importSettings.optimize)
+			{
+				MeshOptimizer::Optimize(mesh);
+			}
+			if (importSettings.lodCount > 1)
+			{
+				MeshSimplifier::GenerateLods(mesh, importSettings.lodCount);
+			}
+			if (importSettings.buildMeshlets)
+			{
+				MeshletBuilder::Build(mesh);
+			}
+			mesh.Finalize(importSettings.vertexFormat);
+
+			MeshCache::Write(path, importSettings, mesh);
+			source->view = mesh.View();
+		}
+
+		// Materials aren't cooked, reading them only touches the JSON and embedded images
+		if (isGltf)
+		{
+			source->materials = GltfImporter::ImportMaterials(path);
+		}
+
+		return source;
+	}
+
+	void Mesh::Upload(const MeshSource& source)
+	{
+		const MeshView& view = source.view;
+
+		// A valid cook is copied from the mapping straight into staging without touching individual vertices
+		m_Geometry = m_Device->GetGeometryPool().Allocate(view.vertices, view.vertexCount, view.vertexFormat, view.indices, view.indexCount, view.indexType);
+		m_Bounds = view.bounds;
+		if (view.vertexFormat == VertexFormat::Compact)
+		{
+			m_VertexTransform = DequantizationTransform(view.bounds);
+		}
+		m_SubMeshes.assign(view.submeshes.begin(), view.submeshes.end());
+		m_Lods.assign(view.lods.begin(), view.lods.end());
+		m_MaterialCount = static_cast<uint32_t>(source.materials.size());
+
+		if (!view.meshlets.empty())
+		{
+			// Cooked meshlets are relative to the mesh, the culling shader writes draws against the shared pool
+			// and looks their texture up per material, with one extra slot for meshlets without a material
+			std::vector<Meshlet> meshlets(view.meshlets.begin(), view.meshlets.end());
+			for (auto& meshlet : meshlets)
+			{
+				meshlet.firstIndex += m_Geometry.firstIndex;
+				meshlet.vertexOffset = m_Geometry.vertexOffset;
+				meshlet.material = std::min(meshlet.material, m_MaterialCount);
+			}
+
+			VkDeviceSize meshletBytes = meshlets.size() * sizeof(Meshlet);
+			m_MeshletBuffer = std::make_unique<StorageBuffer>(m_Device, meshletBytes);
+			m_Device->GetUploadContext().UploadBuffer(m_MeshletBuffer->GetVkBuffer(), 0, meshlets.data(), meshletBytes);
+			m_MeshletCount = static_cast<uint32_t>(meshlets.size());
+		}
+	}
+
+	const std::shared_ptr<Texture>& Mesh::GetBaseColor(uint32_t material) const
+	{
+		static const std::shared_ptr<Texture> none;
+		return material < m_BaseColors.size() ? m_BaseColors[material] : none;
+	}
+
+	void Mesh::SetUploadToken(UploadToken token)
+	{
+		m_UploadToken = token;
+		m_IsUploaded = true;
+	}
+
+	bool Mesh::IsReady() const
+	{
+		return m_IsUploaded && m_Device->GetUploadContext().IsComplete(m_UploadToken);
+	}
+
+	VkDeviceSize Mesh::GetMemorySize() const
+	{
+		VkDeviceSize indexSize = m_Geometry.indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+		VkDeviceSize meshletBytes = m_MeshletBuffer ? m_MeshletBuffer->GetDataSize() : 0;
+
+		return	static_cast<VkDeviceSize>(m_Geometry.vertexCount) * VertexStride(m_Geometry.vertexFormat) +
+				static_cast<VkDeviceSize>(m_Geometry.indexCount) * indexSize + meshletBytes;
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "Device.hpp"
+#include "Texture.hpp"
+#include "UploadContext.hpp"
+
+#include "Buffer/GeometryPool.hpp"
+#include "Buffer/StorageBuffer.hpp"
+
+#include "MeshData.hpp"
+#include "MappedFile.hpp"
+
+#include <string_view>
+#include <vector>
+#include <memory>
+
+namespace VE
+{
+	// A mesh as read from disk, decoded without touching the device so it can be produced on a worker thread
+	struct MeshSource
+	{
+		MappedFile					cookedFile;
+		MeshData					mesh;
+		MeshView					view{}; // Points into either cookedFile or mesh
+		std::vector<MeshMaterial>	materials;
+	};
+
+	// Geometry of one source file in the shared geometry pool. Shared by every model drawing it, see ResourceCache
+	class Mesh
+	{
+	public:
+		explicit Mesh(Device* device);
+		~Mesh();
+
+		Mesh(const Mesh& otherMesh) = delete;
+		Mesh& operator=(const Mesh& otherMesh) = delete;
+	public:
+		// Reads the cook or imports the source (.obj, .gltf or .glb), safe to call from any thread
+		static std::unique_ptr<MeshSource> Decode(std::string_view filePath, const ImportSettings& importSettings);
+		// Records the copies into the upload context, the caller submits them and hands back the token
+		void Upload(const MeshSource& source);
+		void SetUploadToken(UploadToken token);
+		// Textures referenced by the source's materials, indexed like them and empty for materials without one.
+		// Models fall back to their own texture for those and for submeshes without a material
+		inline void SetBaseColors(std::vector<std::shared_ptr<Texture>> textures) { m_BaseColors = std::move(textures); }
+		// True once the data has been uploaded and the copies have completed
+		bool IsReady() const;
+		VkDeviceSize GetMemorySize() const;
+	public:
+		inline const GeometryHandle& GetGeometry() const { return m_Geometry; }
+		inline const MeshBounds& GetBounds() const { return m_Bounds; }
+		inline const std::vector<SubMesh>& GetSubMeshes() const { return m_SubMeshes; }
+		inline const std::vector<MeshLod>& GetLods() const { return m_Lods; }
+		// Empty for materials without a base color and for submeshes without a material
+		const std::shared_ptr<Texture>& GetBaseColor(uint32_t material) const;
+		inline const std::vector<std::shared_ptr<Texture>>& GetBaseColors() const { return m_BaseColors; }
+		// Meshlets of submeshes without a material use this index, see MeshletCuller
+		inline uint32_t GetMaterialCount() const { return m_MaterialCount; }
+		inline const glm::mat4& GetVertexTransform() const { return m_VertexTransform; }
+		inline uint32_t GetMeshletCount() const { return m_MeshletCount; }
+		inline VkBuffer GetMeshletBuffer() const { return m_MeshletBuffer ? m_MeshletBuffer->GetVkBuffer() : VK_NULL_HANDLE; }
+		inline UploadToken GetUploadToken() const { return m_UploadToken; }
+	private:
+		Device*									m_Device;
+		GeometryHandle							m_Geometry;
+		MeshBounds								m_Bounds;
+		std::vector<SubMesh>					m_SubMeshes;
+		std::vector<MeshLod>					m_Lods;
+		glm::mat4								m_VertexTransform; // Dequantization of compact positions, identity otherwise
+		std::unique_ptr<StorageBuffer>			m_MeshletBuffer; // Meshlets with pool offsets applied, read by MeshletCuller
+		uint32_t								m_MeshletCount;
+		uint32_t								m_MaterialCount;
+		std::vector<std::shared_ptr<Texture>>	m_BaseColors;
+		UploadToken								m_UploadToken;
+		bool									m_IsUploaded;
+	};
+}
@@ -0,0 +1,220 @@
+#include "MeshCache.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+namespace VE
+{
+	// Every section starts 16 byte aligned so the mapped data can be read in place
+	static constexpr uint64_t SECTION_ALIGNMENT = 16;
+
+	static uint64_t AlignSection(uint64_t offset)
+	{
+		return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+	}
+
+	std::string MeshCache::CookedPath(std::string_view sourcePath, const ImportSettings& settings)
+	{
+		char flags[16];
+		std::snprintf(flags, sizeof(flags), ".%x", settings.CookFlags());
+		return std::string(sourcePath) + flags + ".vemesh";
+	}
+
+	bool MeshCache::Load(std::string_view sourcePath, const ImportSettings& settings, MappedFile& file, MeshView& view)
+	{
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		if (!QuerySource(sourcePath, &sourceSize, &sourceTime) || !file.Open(CookedPath(sourcePath, settings)))
+		{
+			return false;
+		}
+
+		FileHeader header{};
+		if (file.GetSize() < sizeof(header))
+		{
+			file.Close();
+			return false;
+		}
+		std::memcpy(&header, file.GetData(), sizeof(header));
+
+		uint32_t indexSize = header.indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+		uint64_t vertexBytes = static_cast<uint64_t>(header.vertexCount) * header.vertexStride;
+		uint64_t indexBytes = static_cast<uint64_t>(header.indexCount) * indexSize;
+		uint64_t submeshBytes = static_cast<uint64_t>(header.submeshCount) * sizeof(SubMesh);
+		uint64_t lodBytes = static_cast<uint64_t>(header.lodCount) * sizeof(MeshLod);
+		uint64_t meshletBytes = static_cast<uint64_t>(header.meshletCount) * sizeof(Meshlet);
+
+		bool isValid =	header.magic == MAGIC && header.version == VERSION &&
+						header.vertexStride == VertexStride(settings.vertexFormat) && header.cookFlags == settings.CookFlags() &&
+						header.sourceSize == sourceSize && header.sourceTime == sourceTime &&
+						(header.indexType == VK_INDEX_TYPE_UINT16 || header.indexType == VK_INDEX_TYPE_UINT32) &&
+						header.vertexOffset + vertexBytes <= file.GetSize() &&
+						header.indexOffset + indexBytes <= file.GetSize() &&
+						header.submeshOffset + submeshBytes <= file.GetSize() &&
+						header.lodCount > 0 && header.lodOffset + lodBytes <= file.GetSize() &&
+						header.meshletOffset + meshletBytes <= file.GetSize();
+		if (!isValid)
+		{
+			file.Close();
+			return false;
+		}
+
+		const uint8_t* data = file.GetData();
+		view.vertices = data + header.vertexOffset;
+		view.vertexCount = header.vertexCount;
+		view.vertexFormat = settings.vertexFormat;
+		view.indices = data + header.indexOffset;
+		view.indexCount = header.indexCount;
+		view.indexType = static_cast<VkIndexType>(header.indexType);
+		view.bounds.min = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+		view.bounds.max = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+		view.submeshes = std::span<const SubMesh>(reinterpret_cast<const SubMesh*>(data + header.submeshOffset), header.submeshCount);
+		view.lods = std::span<const MeshLod>(reinterpret_cast<const MeshLod*>(data + header.lodOffset), header.lodCount);
+		view.meshlets = std::span<const Meshlet>(reinterpret_cast<const Meshlet*>(data + header.meshletOffset), header.meshletCount);
+
+		// A damaged cook with an intact header would otherwise feed out of range draws to the GPU
+		if (!AreRangesValid(view))
+		{
+			std::cerr << "Warning: Ignoring corrupt mesh cache " << CookedPath(sourcePath, settings) << std::endl;
+			view = MeshView{};
+			file.Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool MeshCache::Write(std::string_view sourcePath, const ImportSettings& settings, const MeshData& mesh)
+	{
+		MeshView view = mesh.View();
+
+		FileHeader header{};
+		header.magic = MAGIC;
+		header.version = VERSION;
+		header.vertexStride = VertexStride(view.vertexFormat);
+		header.cookFlags = settings.CookFlags();
+		header.vertexCount = view.vertexCount;
+		header.indexType = static_cast<uint32_t>(view.indexType);
+		header.indexCount = view.indexCount;
+		header.submeshCount = static_cast<uint32_t>(view.submeshes.size());
+		header.lodCount = static_cast<uint32_t>(view.lods.size());
+		header.meshletCount = static_cast<uint32_t>(view.meshlets.size());
+		std::memcpy(header.boundsMin, &view.bounds.min, sizeof(header.boundsMin));
+		std::memcpy(header.boundsMax, &view.bounds.max, sizeof(header.boundsMax));
+
+		if (!QuerySource(sourcePath, &header.sourceSize, &header.sourceTime))
+		{
+			return false;
+		}
+
+		uint32_t indexSize = view.indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+		uint64_t vertexBytes = static_cast<uint64_t>(view.vertexCount) * header.vertexStride;
+		uint64_t indexBytes = static_cast<uint64_t>(view.indexCount) * indexSize;
+		uint64_t submeshBytes = view.submeshes.size_bytes();
+		uint64_t lodBytes = view.lods.size_bytes();
+		uint64_t meshletBytes = view.meshlets.size_bytes();
+
+		header.vertexOffset = AlignSection(sizeof(header));
+		header.indexOffset = AlignSection(header.vertexOffset + vertexBytes);
+		header.submeshOffset = AlignSection(header.indexOffset + indexBytes);
+		header.lodOffset = AlignSection(header.submeshOffset + submeshBytes);
+
+		header.meshletOffset = AlignSection(header.lodOffset + lodBytes);
+
+		std::vector<char> contents(header.meshletOffset + meshletBytes, 0);
+		std::memcpy(contents.data(), &header, sizeof(header));
+		std::memcpy(contents.data() + header.vertexOffset, view.vertices, vertexBytes);
+		std::memcpy(contents.data() + header.indexOffset, view.indices, indexBytes);
+		std::memcpy(contents.data() + header.submeshOffset, view.submeshes.data(), submeshBytes);
+		std::memcpy(contents.data() + header.lodOffset, view.lods.data(), lodBytes);
+		std::memcpy(contents.data() + header.meshletOffset, view.meshlets.data(), meshletBytes);
+
+		// Write to a temporary first so an interrupted write never leaves a truncated cook behind. Its name is
+		// unique, so another process cooking the same file never writes into it
+		std::string cookedPath = CookedPath(sourcePath, settings);
+		std::string tempPath = cookedPath + "." + std::to_string(std::random_device{}()) + ".tmp";
+		{
+			std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+			if (!stream || !stream.write(contents.data(), contents.size()))
+			{
+				std::cerr << "Warning: Failed to write mesh cache " << tempPath << std::endl;
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, cookedPath, error);
+		if (error)
+		{
+			std::cerr << "Warning: Failed to write mesh cache " << cookedPath << ": " << error.message() << std::endl;
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool MeshCache::QuerySource(std::string_view sourcePath, uint64_t* size, int64_t* time)
+	{
+		std::error_code error;
+		std::filesystem::path path(sourcePath);
+
+		*size = std::filesystem::file_size(path, error);
+		if (error)
+		{
+			return false;
+		}
+
+		*time = static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+		return !error;
+	}
+
+	bool MeshCache::AreRangesValid(const MeshView& view)
+	{
+		auto isInside = [](uint64_t first, uint64_t count, uint64_t size) { return first + count <= size; };
+
+		for (const auto& submesh : view.submeshes)
+		{
+			if (!isInside(submesh.firstIndex, submesh.indexCount, view.indexCount))
+			{
+				return false;
+			}
+		}
+
+		for (const auto& lod : view.lods)
+		{
+			if (!isInside(lod.firstIndex, lod.indexCount, view.indexCount) || !isInside(lod.firstSubMesh, lod.subMeshCount, view.submeshes.size()))
+			{
+				return false;
+			}
+		}
+
+		for (const auto& meshlet : view.meshlets)
+		{
+			if (!isInside(meshlet.firstIndex, meshlet.indexCount, view.indexCount))
+			{
+				return false;
+			}
+		}
+
+		// Reads every index once, the upload copies them right after anyway
+		uint32_t maxIndex = 0;
+		if (view.indexType == VK_INDEX_TYPE_UINT16)
+		{
+			const uint16_t* indices = static_cast<const uint16_t*>(view.indices);
+			maxIndex = view.indexCount > 0 ? *std::max_element(indices, indices + view.indexCount) : 0;
+		}
+		else
+		{
+			const uint32_t* indices = static_cast<const uint32_t*>(view.indices);
+			maxIndex = view.indexCount > 0 ? *std::max_element(indices, indices + view.indexCount) : 0;
+		}
+
+		return view.indexCount == 0 || maxIndex < view.vertexCount;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "MeshData.hpp"
+#include "MappedFile.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace VE
+{
+	// Cooked binary copy of an imported mesh stored next to its source as <source>.<cook flags>.vemesh, so every
+	// set of import settings has a cook of its own. A cook is only used while the source file size and write time
+	// still match the ones it was built from, and only if all of its ranges lie within its data.
+	class MeshCache
+	{
+	public:
+		static inline constexpr uint32_t MAGIC = 0x48534D56; // "VMSH"
+		static inline constexpr uint32_t VERSION = 8;
+	public:
+		static std::string CookedPath(std::string_view sourcePath, const ImportSettings& settings);
+		// On success the view points into the mapped file, which has to stay open while the view is used
+		static bool Load(std::string_view sourcePath, const ImportSettings& settings, MappedFile& file, MeshView& view);
+		static bool Write(std::string_view sourcePath, const ImportSettings& settings, const MeshData& mesh);
+	private:
+		struct FileHeader
+		{
+			uint32_t	magic;
+			uint32_t	version;
+			uint64_t	sourceSize;
+			int64_t		sourceTime;
+			uint32_t	vertexStride;
+			uint32_t	vertexCount;
+			uint32_t	indexType;
+			uint32_t	indexCount;
+			uint32_t	submeshCount;
+			uint32_t	lodCount;
+			uint32_t	cookFlags;
+			uint32_t	meshletCount;
+			float		boundsMin[3];
+			float		boundsMax[3];
+			uint64_t	vertexOffset;
+			uint64_t	indexOffset;
+			uint64_t	submeshOffset;
+			uint64_t	lodOffset;
+			uint64_t	meshletOffset;
+		};
+	private:
+		static bool QuerySource(std::string_view sourcePath, uint64_t* size, int64_t* time);
+		// Submesh, LOD and meshlet ranges within the indices and every index within the vertices
+		static bool AreRangesValid(const MeshView& view);
+	};
+}
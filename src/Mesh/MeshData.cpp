@@ -0,0 +1,149 @@
+#include "MeshData.hpp"
+
+#include "glm/gtx/transform.hpp"
+#include <glm/gtc/packing.hpp>
+
+#include <limits>
+#include <cmath>
+
+namespace VE
+{
+	// Flat or degenerate axes still need a non zero range to quantize against
+	static glm::vec3 QuantizationExtent(const MeshBounds& bounds)
+	{
+		return glm::max(bounds.max - bounds.min, glm::vec3(1e-6f));
+	}
+
+	static uint32_t PackNormal(const glm::vec3& normal)
+	{
+		glm::vec3 unorm = glm::clamp(normal * 0.5f + 0.5f, 0.0f, 1.0f);
+		uint32_t x = static_cast<uint32_t>(std::round(unorm.x * 1023.0f));
+		uint32_t y = static_cast<uint32_t>(std::round(unorm.y * 1023.0f));
+		uint32_t z = static_cast<uint32_t>(std::round(unorm.z * 1023.0f));
+		return x | (y << 10) | (z << 20);
+	}
+
+	glm::mat4 DequantizationTransform(const MeshBounds& bounds)
+	{
+		return glm::translate(bounds.min) * glm::scale(QuantizationExtent(bounds));
+	}
+
+	void MeshData::Finalize(VertexFormat format)
+	{
+		bounds.min = glm::vec3(std::numeric_limits<float>::max());
+		bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
+		for (const auto& vertex : vertices)
+		{
+			bounds.min = glm::min(bounds.min, vertex.position);
+			bounds.max = glm::max(bounds.max, vertex.position);
+		}
+
+		if (vertices.empty())
+		{
+			bounds = { glm::vec3(0.0f), glm::vec3(0.0f) };
+		}
+
+		if (lods.empty())
+		{
+			lods.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.0f, 0, static_cast<uint32_t>(submeshes.size()) });
+		}
+
+		vertexFormat = format;
+		if (format == VertexFormat::Compact)
+		{
+			// Area weighted face normals, the cross product's length already is twice the triangle area
+			std::vector<glm::vec3> faceNormals(vertices.size(), glm::vec3(0.0f));
+			for (size_t i = 0; i + 2 < lods[0].indexCount; i += 3)
+			{
+				const glm::vec3& p0 = vertices[indices[i + 0]].position;
+				const glm::vec3& p1 = vertices[indices[i + 1]].position;
+				const glm::vec3& p2 = vertices[indices[i + 2]].position;
+
+				glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+				faceNormals[indices[i + 0]] += faceNormal;
+				faceNormals[indices[i + 1]] += faceNormal;
+				faceNormals[indices[i + 2]] += faceNormal;
+			}
+
+			// Authored normals win, they keep hard edges that averaging over shared vertices would smooth out
+			normals.resize(vertices.size(), glm::vec3(0.0f));
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				if (glm::length(normals[i]) == 0.0f)
+				{
+					normals[i] = faceNormals[i];
+				}
+			}
+
+			glm::vec3 extent = QuantizationExtent(bounds);
+			compactVertices.resize(vertices.size());
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				glm::vec3 normal = glm::length(normals[i]) > 0.0f ? glm::normalize(normals[i]) : glm::vec3(0.0f, 0.0f, 1.0f);
+				glm::vec3 position = glm::clamp((vertices[i].position - bounds.min) / extent, 0.0f, 1.0f);
+				uint32_t texCoords = glm::packHalf2x16(vertices[i].texCoords);
+
+				auto& compact = compactVertices[i];
+				compact.position[0] = static_cast<uint16_t>(std::round(position.x * 65535.0f));
+				compact.position[1] = static_cast<uint16_t>(std::round(position.y * 65535.0f));
+				compact.position[2] = static_cast<uint16_t>(std::round(position.z * 65535.0f));
+				compact.position[3] = 65535;
+				compact.normal = PackNormal(normal);
+				compact.texCoords[0] = static_cast<uint16_t>(texCoords & 0xFFFF);
+				compact.texCoords[1] = static_cast<uint16_t>(texCoords >> 16);
+			}
+
+			vertices.clear();
+			vertices.shrink_to_fit();
+		}
+
+		normals.clear();
+		normals.shrink_to_fit();
+
+		size_t vertexCount = format == VertexFormat::Compact ? compactVertices.size() : vertices.size();
+		if (vertexCount <= std::numeric_limits<uint16_t>::max() + 1)
+		{
+			shortIndices.assign(indices.begin(), indices.end());
+			indices.clear();
+			indices.shrink_to_fit();
+			indexType = VK_INDEX_TYPE_UINT16;
+		}
+		else
+		{
+			indexType = VK_INDEX_TYPE_UINT32;
+		}
+	}
+
+	MeshView MeshData::View() const
+	{
+		MeshView view{};
+		view.vertexFormat = vertexFormat;
+		if (vertexFormat == VertexFormat::Compact)
+		{
+			view.vertices = compactVertices.data();
+			view.vertexCount = static_cast<uint32_t>(compactVertices.size());
+		}
+		else
+		{
+			view.vertices = vertices.data();
+			view.vertexCount = static_cast<uint32_t>(vertices.size());
+		}
+		view.indexType = indexType;
+		if (indexType == VK_INDEX_TYPE_UINT16)
+		{
+			view.indices = shortIndices.data();
+			view.indexCount = static_cast<uint32_t>(shortIndices.size());
+		}
+		else
+		{
+			view.indices = indices.data();
+			view.indexCount = static_cast<uint32_t>(indices.size());
+		}
+		view.bounds = bounds;
+		view.submeshes = submeshes;
+		view.lods = lods;
+		view.meshlets = meshlets;
+
+		return view;
+	}
+}
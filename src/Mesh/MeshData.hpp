@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "Buffer/Buffer.hpp"
+
+#include <string>
+#include <vector>
+#include <span>
+
+namespace VE
+{
+	struct SubMesh
+	{
+		uint32_t	firstIndex;
+		uint32_t	indexCount;
+		uint32_t	material = UINT32_MAX; // Index into the source's materials, see MeshMaterial, out of range for none
+	};
+
+	// Texture references of one source material, images are decoded separately from the geometry
+	struct MeshMaterial
+	{
+		std::string				baseColorPath; // External image resolved against the source's directory
+		std::vector<uint8_t>	baseColorData; // Encoded image embedded in the source
+
+		inline bool HasBaseColor() const { return !baseColorPath.empty() || !baseColorData.empty(); }
+	};
+
+	// Index range of one level of detail, error is the largest surface deviation from LOD 0 in model units.
+	// The level's submeshes split its range by material
+	struct MeshLod
+	{
+		uint32_t	firstIndex;
+		uint32_t	indexCount;
+		float		error;
+		uint32_t	firstSubMesh;
+		uint32_t	subMeshCount;
+	};
+
+	// Cluster of LOD 0 triangles with the bounds used for GPU culling, matches the std430 layout in MeshletCull.comp
+	struct Meshlet
+	{
+		glm::vec3	center;
+		float		radius;
+		glm::vec3	coneAxis;
+		float		coneCutoff; // Sine of the normal cone's half angle, 1 disables back-face culling
+		uint32_t	firstIndex;
+		uint32_t	indexCount;
+		int32_t		vertexOffset; // Set when uploaded, see Mesh::Upload
+		uint32_t	material; // Like SubMesh::material, MeshletCuller looks up the draw's texture index with it
+	};
+
+	struct MeshBounds
+	{
+		glm::vec3	min;
+		glm::vec3	max;
+	};
+
+	// Maps unorm16 positions of a VertexFormat::Compact mesh back into model space
+	glm::mat4 DequantizationTransform(const MeshBounds& bounds);
+
+	struct ImportSettings
+	{
+		uint32_t		threadCount = 0; // 0 = one thread per hardware thread
+		bool			optimize = true; // Vertex cache, overdraw and vertex fetch reordering, see MeshOptimizer
+		VertexFormat	vertexFormat = VertexFormat::Full;
+		uint32_t		lodCount = 4; // Including LOD 0, see MeshSimplifier
+		bool			buildMeshlets = true; // See MeshletBuilder
+
+		// Settings that change the imported data and therefore have to match for a cook to be reused
+		inline uint32_t CookFlags() const
+		{
+			return (optimize ? 1u : 0u) | (vertexFormat == VertexFormat::Compact ? 2u : 0u) | (buildMeshlets ? 4u : 0u) | (lodCount << 8);
+		}
+	};
+
+	// Read-only view of mesh data, either owned by a MeshData or pointing into a mapped cooked file
+	struct MeshView
+	{
+		const void*					vertices = nullptr;
+		uint32_t					vertexCount = 0;
+		VertexFormat				vertexFormat = VertexFormat::Full;
+		const void*					indices = nullptr;
+		uint32_t					indexCount = 0;
+		VkIndexType					indexType = VK_INDEX_TYPE_UINT32;
+		MeshBounds					bounds{};
+		std::span<const SubMesh>	submeshes; // Ranges of every LOD, see MeshLod::firstSubMesh
+		std::span<const MeshLod>	lods;
+		std::span<const Meshlet>	meshlets;
+	};
+
+	// Deduplicated, GPU ready mesh as produced by the importers
+	struct MeshData
+	{
+		std::vector<Vertex>			vertices;
+		std::vector<glm::vec3>		normals; // Authored normals parallel to vertices, empty or zero where they are derived from the triangles
+		std::vector<CompactVertex>	compactVertices;
+		VertexFormat				vertexFormat = VertexFormat::Full;
+		std::vector<uint32_t>		indices;
+		std::vector<uint16_t>		shortIndices;
+		VkIndexType					indexType = VK_INDEX_TYPE_UINT32;
+		MeshBounds					bounds{};
+		std::vector<SubMesh>		submeshes; // The importer's ranges within LOD 0 come first, followed by the ranges of the other LODs
+		std::vector<MeshLod>		lods; // Empty until MeshSimplifier::GenerateLods or Finalize, LOD 0 always starts at index 0
+		std::vector<Meshlet>		meshlets;
+
+		// Computes the bounds, converts the vertices to the requested format and
+		// narrows the indices to 16 bit when every vertex is addressable with them
+		void Finalize(VertexFormat format);
+		MeshView View() const;
+	};
+}
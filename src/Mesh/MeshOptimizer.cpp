@@ -0,0 +1,354 @@
+#include "MeshOptimizer.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <iostream>
+
+namespace VE
+{
+	static constexpr uint32_t INVALID_VERTEX = UINT32_MAX;
+
+	// Simulates a FIFO post-transform cache and returns whether the vertex had to be transformed
+	class FifoCache
+	{
+	public:
+		FifoCache(uint32_t vertexCount, uint32_t cacheSize)
+			: m_Timestamps(vertexCount, 0), m_CacheSize(cacheSize), m_Time(cacheSize + 1)
+		{
+		}
+
+		bool Access(uint32_t vertex)
+		{
+			if (m_Time - m_Timestamps[vertex] > m_CacheSize)
+			{
+				m_Timestamps[vertex] = m_Time++;
+				return true;
+			}
+			return false;
+		}
+	private:
+		std::vector<uint32_t>	m_Timestamps;
+		uint32_t				m_CacheSize;
+		uint32_t				m_Time;
+	};
+
+	void MeshOptimizer::Optimize(MeshData& mesh)
+	{
+		uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+		VertexCacheStats before = Analyze(mesh.indices, vertexCount);
+
+		// Every submesh is optimized in a compact local vertex space so the per vertex scratch stays small
+		std::vector<uint32_t> globalToLocal(vertexCount, INVALID_VERTEX);
+		std::vector<uint32_t> localToGlobal;
+		std::vector<uint32_t> localIndices;
+		std::vector<glm::vec3> localPositions;
+
+		for (const auto& submesh : mesh.submeshes)
+		{
+			std::span<uint32_t> indices(mesh.indices.data() + submesh.firstIndex, submesh.indexCount);
+
+			localToGlobal.clear();
+			localIndices.clear();
+			localPositions.clear();
+			for (uint32_t index : indices)
+			{
+				if (globalToLocal[index] == INVALID_VERTEX)
+				{
+					globalToLocal[index] = static_cast<uint32_t>(localToGlobal.size());
+					localToGlobal.push_back(index);
+					localPositions.push_back(mesh.vertices[index].position);
+				}
+				localIndices.push_back(globalToLocal[index]);
+			}
+
+			OptimizeVertexCache(localIndices, static_cast<uint32_t>(localToGlobal.size()));
+			OptimizeOverdraw(localIndices, localPositions);
+
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				indices[i] = localToGlobal[localIndices[i]];
+			}
+			for (uint32_t global : localToGlobal)
+			{
+				globalToLocal[global] = INVALID_VERTEX;
+			}
+		}
+
+		OptimizeVertexFetch(mesh);
+
+		VertexCacheStats after = Analyze(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+		std::cout	<< "Mesh optimization: ACMR " << before.acmr << " -> " << after.acmr
+					<< ", ATVR " << before.atvr << " -> " << after.atvr << std::endl;
+	}
+
+	VertexCacheStats MeshOptimizer::Analyze(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		FifoCache cache(vertexCount, cacheSize);
+		std::vector<bool> referenced(vertexCount, false);
+
+		uint32_t misses = 0;
+		uint32_t uniqueCount = 0;
+		for (uint32_t index : indices)
+		{
+			misses += cache.Access(index) ? 1 : 0;
+			if (!referenced[index])
+			{
+				referenced[index] = true;
+				uniqueCount++;
+			}
+		}
+
+		VertexCacheStats stats{};
+		stats.acmr = indices.size() >= 3 ? static_cast<float>(misses) / static_cast<float>(indices.size() / 3) : 0.0f;
+		stats.atvr = uniqueCount > 0 ? static_cast<float>(misses) / static_cast<float>(uniqueCount) : 0.0f;
+		return stats;
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		// Vertex to triangle adjacency in CSR form
+		std::vector<uint32_t> liveCount(vertexCount, 0);
+		for (uint32_t index : indices)
+		{
+			liveCount[index]++;
+		}
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		std::inclusive_scan(liveCount.begin(), liveCount.end(), adjacencyOffsets.begin() + 1);
+
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		std::vector<uint32_t> cacheTime(vertexCount, 0);
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<uint32_t> deadEnd;
+		std::vector<uint32_t> candidates;
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+
+		uint32_t time = cacheSize + 1;
+		uint32_t cursor = 0;
+
+		auto skipDeadEnd = [&]() -> uint32_t
+		{
+			while (!deadEnd.empty())
+			{
+				uint32_t vertex = deadEnd.back();
+				deadEnd.pop_back();
+				if (liveCount[vertex] > 0)
+				{
+					return vertex;
+				}
+			}
+
+			while (cursor < vertexCount)
+			{
+				if (liveCount[cursor] > 0)
+				{
+					return cursor;
+				}
+				cursor++;
+			}
+
+			return INVALID_VERTEX;
+		};
+
+		uint32_t fanning = skipDeadEnd();
+		while (fanning != INVALID_VERTEX)
+		{
+			candidates.clear();
+
+			for (uint32_t i = adjacencyOffsets[fanning]; i < adjacencyOffsets[fanning + 1]; i++)
+			{
+				uint32_t triangle = adjacency[i];
+				if (emitted[triangle])
+				{
+					continue;
+				}
+
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t vertex = indices[triangle * 3 + corner];
+					result.push_back(vertex);
+					deadEnd.push_back(vertex);
+					candidates.push_back(vertex);
+					liveCount[vertex]--;
+
+					if (time - cacheTime[vertex] > cacheSize)
+					{
+						cacheTime[vertex] = time++;
+					}
+				}
+
+				emitted[triangle] = true;
+			}
+
+			// Prefer the candidate that stays in cache longest while it still has triangles left to fan
+			uint32_t best = INVALID_VERTEX;
+			int32_t bestPriority = -1;
+			for (uint32_t vertex : candidates)
+			{
+				if (liveCount[vertex] == 0)
+				{
+					continue;
+				}
+
+				int32_t priority = 0;
+				if (time - cacheTime[vertex] + 2 * liveCount[vertex] <= cacheSize)
+				{
+					priority = static_cast<int32_t>(time - cacheTime[vertex]);
+				}
+
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					best = vertex;
+				}
+			}
+
+			fanning = best != INVALID_VERTEX ? best : skipDeadEnd();
+		}
+
+		std::copy(result.begin(), result.end(), indices.begin());
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions, uint32_t cacheSize)
+	{
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount < 2)
+		{
+			return;
+		}
+
+		// Cluster boundaries go where the simulated cache restarts, so reordering whole clusters costs little ACMR
+		std::vector<uint32_t> clusterStarts;
+		{
+			FifoCache cache(static_cast<uint32_t>(positions.size()), cacheSize);
+			uint32_t clusterMisses = 0;
+			size_t clusterStart = 0;
+			float targetAcmr = Analyze(indices, static_cast<uint32_t>(positions.size()), cacheSize).acmr * OVERDRAW_THRESHOLD;
+
+			for (size_t triangle = 0; triangle < triangleCount; triangle++)
+			{
+				uint32_t misses = 0;
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					misses += cache.Access(indices[triangle * 3 + corner]) ? 1 : 0;
+				}
+
+				size_t clusterSize = triangle - clusterStart;
+				bool isRestart = misses == 3;
+				bool isEfficient = clusterSize > 0 && static_cast<float>(clusterMisses) / static_cast<float>(clusterSize) <= targetAcmr;
+				if (triangle == 0 || (isRestart && isEfficient))
+				{
+					clusterStarts.push_back(static_cast<uint32_t>(triangle));
+					clusterStart = triangle;
+					clusterMisses = 0;
+				}
+				clusterMisses += misses;
+			}
+			clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+		}
+
+		size_t clusterCount = clusterStarts.size() - 1;
+		if (clusterCount < 2)
+		{
+			return;
+		}
+
+		glm::vec3 meshCentroid(0.0f);
+		for (const auto& position : positions)
+		{
+			meshCentroid += position;
+		}
+		meshCentroid /= static_cast<float>(positions.size());
+
+		// Clusters facing away from the mesh center tend to occlude the rest, so they are drawn first
+		std::vector<float> sortKeys(clusterCount);
+		for (size_t cluster = 0; cluster < clusterCount; cluster++)
+		{
+			glm::vec3 centroid(0.0f);
+			glm::vec3 normal(0.0f);
+			float area = 0.0f;
+
+			for (uint32_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; triangle++)
+			{
+				const glm::vec3& p0 = positions[indices[triangle * 3 + 0]];
+				const glm::vec3& p1 = positions[indices[triangle * 3 + 1]];
+				const glm::vec3& p2 = positions[indices[triangle * 3 + 2]];
+
+				glm::vec3 areaNormal = glm::cross(p1 - p0, p2 - p0);
+				float triangleArea = glm::length(areaNormal);
+
+				centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+				normal += areaNormal;
+				area += triangleArea;
+			}
+
+			float normalLength = glm::length(normal);
+			if (area > 0.0f && normalLength > 0.0f)
+			{
+				sortKeys[cluster] = glm::dot(centroid / area - meshCentroid, normal / normalLength);
+			}
+			else
+			{
+				sortKeys[cluster] = 0.0f;
+			}
+		}
+
+		std::vector<uint32_t> order(clusterCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+		{
+			return sortKeys[a] > sortKeys[b];
+		});
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		for (uint32_t cluster : order)
+		{
+			result.insert(result.end(), indices.begin() + clusterStarts[cluster] * 3, indices.begin() + clusterStarts[cluster + 1] * 3);
+		}
+
+		std::copy(result.begin(), result.end(), indices.begin());
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(MeshData& mesh)
+	{
+		std::vector<uint32_t> remap(mesh.vertices.size(), INVALID_VERTEX);
+		std::vector<Vertex> vertices;
+		vertices.reserve(mesh.vertices.size());
+		std::vector<glm::vec3> normals;
+		normals.reserve(mesh.normals.size());
+
+		for (auto& index : mesh.indices)
+		{
+			if (remap[index] == INVALID_VERTEX)
+			{
+				remap[index] = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(mesh.vertices[index]);
+				if (!mesh.normals.empty())
+				{
+					normals.push_back(mesh.normals[index]);
+				}
+			}
+			index = remap[index];
+		}
+
+		mesh.vertices = std::move(vertices);
+		mesh.normals = std::move(normals);
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "MeshData.hpp"
+
+#include <span>
+
+namespace VE
+{
+	struct VertexCacheStats
+	{
+		float	acmr; // Average cache miss ratio, transformed vertices per triangle (0.5 ideal, 3 worst)
+		float	atvr; // Average transformed vertex ratio, transformed vertices per vertex (1 ideal)
+	};
+
+	// Import time reordering of triangles and vertices for the post-transform cache, early-Z and vertex fetch.
+	// Triangles never move between submeshes, so the submesh table stays valid.
+	class MeshOptimizer
+	{
+	public:
+		static inline constexpr uint32_t CACHE_SIZE = 16;
+		// Clusters whose ACMR is within this factor of the cache optimized order may be reordered for overdraw
+		static inline constexpr float OVERDRAW_THRESHOLD = 1.05f;
+	public:
+		// Runs every pass below on the 32 bit indices of an imported mesh and prints ACMR/ATVR before and after
+		static void Optimize(MeshData& mesh);
+		static VertexCacheStats Analyze(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = CACHE_SIZE);
+		// Tipsify (Sander, Nehab, Barczak 2007)
+		static void OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = CACHE_SIZE);
+		// Splits a cache optimized order into clusters and draws the outward facing ones first
+		static void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions, uint32_t cacheSize = CACHE_SIZE);
+		// Renumbers vertices in order of first use and drops unreferenced ones
+		static void OptimizeVertexFetch(MeshData& mesh);
+	};
+}
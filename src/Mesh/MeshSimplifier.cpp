@@ -0,0 +1,463 @@
+#include "MeshSimplifier.hpp"
+
+#include "MeshOptimizer.hpp"
+#include "VertexHashMap.hpp"
+
+#include <queue>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <cmath>
+
+namespace VE
+{
+	static constexpr uint32_t INVALID_VERTEX = UINT32_MAX;
+
+	// Symmetric 4x4 matrix stored as its upper triangle, plus the total area of the planes it holds
+	struct Quadric
+	{
+		double a00, a01, a02, a03;
+		double a11, a12, a13;
+		double a22, a23;
+		double a33;
+		double weight;
+
+		void AddPlane(double a, double b, double c, double d, double weight)
+		{
+			a00 += weight * a * a; a01 += weight * a * b; a02 += weight * a * c; a03 += weight * a * d;
+			a11 += weight * b * b; a12 += weight * b * c; a13 += weight * b * d;
+			a22 += weight * c * c; a23 += weight * c * d;
+			a33 += weight * d * d;
+			this->weight += weight;
+		}
+
+		void Add(const Quadric& other)
+		{
+			a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+			a11 += other.a11; a12 += other.a12; a13 += other.a13;
+			a22 += other.a22; a23 += other.a23;
+			a33 += other.a33;
+			weight += other.weight;
+		}
+
+		double Evaluate(const glm::vec3& p) const
+		{
+			double x = p.x, y = p.y, z = p.z;
+			double error =	a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x +
+							a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y +
+							a22 * z * z + 2.0 * a23 * z +
+							a33;
+
+			// Area weighted squared distance, normalized so the result is a squared distance in model units
+			return weight > 0.0 ? std::max(error, 0.0) / weight : 0.0;
+		}
+	};
+
+	struct Collapse
+	{
+		double		cost;
+		uint32_t	from;
+		uint32_t	to;
+		uint32_t	version;
+
+		bool operator>(const Collapse& other) const { return cost > other.cost; }
+	};
+
+	class Simplification
+	{
+	public:
+		Simplification(std::span<const Vertex> vertices, std::span<const uint32_t> indices)
+			:	m_Vertices(vertices), m_Indices(indices.begin(), indices.end()),
+				m_TriangleAlive(indices.size() / 3, true), m_VertexTriangles(vertices.size()),
+				m_Quadrics(vertices.size(), Quadric{}), m_Locked(vertices.size(), false),
+				m_Versions(vertices.size(), 0), m_TriangleCount(indices.size() / 3)
+		{
+			for (uint32_t triangle = 0; triangle < m_TriangleCount; triangle++)
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					m_VertexTriangles[m_Indices[triangle * 3 + corner]].push_back(triangle);
+				}
+				AddTriangleQuadric(triangle);
+			}
+
+			LockBordersAndSeams();
+		}
+
+		void Run(size_t targetTriangleCount)
+		{
+			for (uint32_t vertex = 0; vertex < m_Vertices.size(); vertex++)
+			{
+				PushBestCollapse(vertex);
+			}
+
+			while (m_TriangleCount > targetTriangleCount && !m_Queue.empty())
+			{
+				Collapse collapse = m_Queue.top();
+				m_Queue.pop();
+
+				if (collapse.version != m_Versions[collapse.from] || !IsCollapseValid(collapse.from, collapse.to))
+				{
+					continue;
+				}
+
+				m_MaxError = std::max(m_MaxError, collapse.cost);
+				Apply(collapse.from, collapse.to);
+			}
+		}
+
+		std::vector<uint32_t> GetIndices() const
+		{
+			std::vector<uint32_t> result;
+			result.reserve(m_TriangleCount * 3);
+			for (uint32_t triangle = 0; triangle < m_TriangleAlive.size(); triangle++)
+			{
+				if (m_TriangleAlive[triangle])
+				{
+					result.insert(result.end(), m_Indices.begin() + triangle * 3, m_Indices.begin() + triangle * 3 + 3);
+				}
+			}
+			return result;
+		}
+
+		// Surviving triangles whose LOD 0 triangle belongs to the group, in their original order
+		std::vector<uint32_t> GetIndices(std::span<const uint32_t> triangleGroups, uint32_t group) const
+		{
+			std::vector<uint32_t> result;
+			for (uint32_t triangle = 0; triangle < m_TriangleAlive.size(); triangle++)
+			{
+				if (m_TriangleAlive[triangle] && triangleGroups[triangle] == group)
+				{
+					result.insert(result.end(), m_Indices.begin() + triangle * 3, m_Indices.begin() + triangle * 3 + 3);
+				}
+			}
+			return result;
+		}
+
+		// Has to be called before Run
+		inline void Lock(uint32_t vertex) { m_Locked[vertex] = true; }
+		inline size_t GetTriangleCount() const { return m_TriangleCount; }
+		inline float GetError() const { return static_cast<float>(std::sqrt(m_MaxError)); }
+	private:
+		void AddTriangleQuadric(uint32_t triangle)
+		{
+			const glm::vec3& p0 = m_Vertices[m_Indices[triangle * 3 + 0]].position;
+			const glm::vec3& p1 = m_Vertices[m_Indices[triangle * 3 + 1]].position;
+			const glm::vec3& p2 = m_Vertices[m_Indices[triangle * 3 + 2]].position;
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(normal);
+			if (area <= 0.0f)
+			{
+				return;
+			}
+
+			normal /= area;
+			double d = -static_cast<double>(glm::dot(normal, p0));
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				m_Quadrics[m_Indices[triangle * 3 + corner]].AddPlane(normal.x, normal.y, normal.z, d, area * 0.5);
+			}
+		}
+
+		void LockBordersAndSeams()
+		{
+			// Vertices split by UV seams share a position, moving one of them would tear the surface
+			std::vector<uint32_t> positionGroup(m_Vertices.size());
+			std::vector<uint32_t> groupSize(m_Vertices.size(), 0);
+			{
+				VertexHashMap positions(m_Vertices.size());
+				for (uint32_t vertex = 0; vertex < m_Vertices.size(); vertex++)
+				{
+					Vertex key{};
+					key.position = m_Vertices[vertex].position;
+					positionGroup[vertex] = positions.TryEmplace(key, vertex).first;
+					groupSize[positionGroup[vertex]]++;
+				}
+			}
+
+			for (uint32_t vertex = 0; vertex < m_Vertices.size(); vertex++)
+			{
+				if (groupSize[positionGroup[vertex]] > 1)
+				{
+					m_Locked[vertex] = true;
+				}
+			}
+
+			// An edge used by exactly one triangle lies on an open border
+			std::unordered_map<uint64_t, uint32_t> edgeUses;
+			edgeUses.reserve(m_Indices.size());
+			auto edgeKey = [&](uint32_t a, uint32_t b)
+			{
+				a = positionGroup[a];
+				b = positionGroup[b];
+				return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+			};
+
+			for (size_t i = 0; i < m_Indices.size(); i += 3)
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					edgeUses[edgeKey(m_Indices[i + corner], m_Indices[i + (corner + 1) % 3])]++;
+				}
+			}
+
+			for (size_t i = 0; i < m_Indices.size(); i += 3)
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t a = m_Indices[i + corner];
+					uint32_t b = m_Indices[i + (corner + 1) % 3];
+					if (edgeUses[edgeKey(a, b)] == 1)
+					{
+						m_Locked[a] = true;
+						m_Locked[b] = true;
+					}
+				}
+			}
+		}
+
+		void PushBestCollapse(uint32_t from)
+		{
+			if (m_Locked[from])
+			{
+				return;
+			}
+
+			Collapse best{ std::numeric_limits<double>::max(), from, INVALID_VERTEX, m_Versions[from] };
+			for (uint32_t triangle : m_VertexTriangles[from])
+			{
+				if (!m_TriangleAlive[triangle])
+				{
+					continue;
+				}
+
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t to = m_Indices[triangle * 3 + corner];
+					if (to == from)
+					{
+						continue;
+					}
+
+					Quadric quadric = m_Quadrics[from];
+					quadric.Add(m_Quadrics[to]);
+					double cost = quadric.Evaluate(m_Vertices[to].position);
+					if (cost < best.cost)
+					{
+						best.cost = cost;
+						best.to = to;
+					}
+				}
+			}
+
+			if (best.to != INVALID_VERTEX)
+			{
+				m_Queue.push(best);
+			}
+		}
+
+		bool IsCollapseValid(uint32_t from, uint32_t to) const
+		{
+			bool isConnected = false;
+			const glm::vec3& target = m_Vertices[to].position;
+
+			for (uint32_t triangle : m_VertexTriangles[from])
+			{
+				if (!m_TriangleAlive[triangle])
+				{
+					continue;
+				}
+
+				const uint32_t* corners = &m_Indices[triangle * 3];
+				if (corners[0] == to || corners[1] == to || corners[2] == to)
+				{
+					isConnected = true;
+					continue;
+				}
+
+				// Triangles that stay must not flip when their corner moves onto the target
+				glm::vec3 p[3];
+				glm::vec3 moved[3];
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					p[corner] = m_Vertices[corners[corner]].position;
+					moved[corner] = corners[corner] == from ? target : p[corner];
+				}
+
+				glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+				glm::vec3 after = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+				if (glm::dot(before, after) <= 0.0f)
+				{
+					return false;
+				}
+			}
+
+			return isConnected;
+		}
+
+		void Apply(uint32_t from, uint32_t to)
+		{
+			for (uint32_t triangle : m_VertexTriangles[from])
+			{
+				if (!m_TriangleAlive[triangle])
+				{
+					continue;
+				}
+
+				uint32_t* corners = &m_Indices[triangle * 3];
+				if (corners[0] == to || corners[1] == to || corners[2] == to)
+				{
+					m_TriangleAlive[triangle] = false;
+					m_TriangleCount--;
+					continue;
+				}
+
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					if (corners[corner] == from)
+					{
+						corners[corner] = to;
+					}
+				}
+				m_VertexTriangles[to].push_back(triangle);
+			}
+
+			m_VertexTriangles[from].clear();
+			m_Quadrics[to].Add(m_Quadrics[from]);
+			m_Locked[from] = true; // No longer referenced, keeps stale entries from collapsing it again
+
+			// Costs around the target changed, requeue it and its neighbours
+			CompactTriangles(to);
+			std::vector<uint32_t> neighbours{ to };
+			for (uint32_t triangle : m_VertexTriangles[to])
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					neighbours.push_back(m_Indices[triangle * 3 + corner]);
+				}
+			}
+			std::sort(neighbours.begin(), neighbours.end());
+			neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+			for (uint32_t vertex : neighbours)
+			{
+				m_Versions[vertex]++;
+				PushBestCollapse(vertex);
+			}
+		}
+
+		void CompactTriangles(uint32_t vertex)
+		{
+			auto& triangles = m_VertexTriangles[vertex];
+			triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [this](uint32_t triangle)
+			{
+				return !m_TriangleAlive[triangle];
+			}), triangles.end());
+			std::sort(triangles.begin(), triangles.end());
+			triangles.erase(std::unique(triangles.begin(), triangles.end()), triangles.end());
+		}
+	private:
+		std::span<const Vertex>					m_Vertices;
+		std::vector<uint32_t>					m_Indices;
+		std::vector<bool>						m_TriangleAlive;
+		std::vector<std::vector<uint32_t>>		m_VertexTriangles;
+		std::vector<Quadric>					m_Quadrics;
+		std::vector<bool>						m_Locked;
+		std::vector<uint32_t>					m_Versions;
+		size_t									m_TriangleCount;
+		double									m_MaxError = 0.0;
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> m_Queue;
+	};
+
+	std::vector<uint32_t> MeshSimplifier::Simplify(std::span<const Vertex> vertices, std::span<const uint32_t> indices, size_t targetIndexCount, float* resultError)
+	{
+		Simplification simplification(vertices, indices);
+		simplification.Run(targetIndexCount / 3);
+
+		if (resultError)
+		{
+			*resultError = simplification.GetError();
+		}
+		return simplification.GetIndices();
+	}
+
+	void MeshSimplifier::GenerateLods(MeshData& mesh, uint32_t lodCount)
+	{
+		uint32_t baseIndexCount = static_cast<uint32_t>(mesh.indices.size());
+		mesh.lods.assign(1, { 0, baseIndexCount, 0.0f, 0, static_cast<uint32_t>(mesh.submeshes.size()) });
+
+		// Triangles are grouped by material, every LOD draws one range per group
+		std::vector<uint32_t> groupMaterials;
+		std::vector<uint32_t> triangleGroups(baseIndexCount / 3, 0);
+		for (const auto& submesh : mesh.submeshes)
+		{
+			auto group = std::find(groupMaterials.begin(), groupMaterials.end(), submesh.material);
+			uint32_t groupIndex = static_cast<uint32_t>(group - groupMaterials.begin());
+			if (group == groupMaterials.end())
+			{
+				groupMaterials.push_back(submesh.material);
+			}
+			std::fill_n(triangleGroups.begin() + submesh.firstIndex / 3, submesh.indexCount / 3, groupIndex);
+		}
+
+		// Vertices used by two materials stay where they are, so collapses never move triangles across the material border
+		std::vector<uint32_t> vertexGroups(mesh.vertices.size(), UINT32_MAX);
+		std::vector<uint32_t> borderVertices;
+		for (uint32_t i = 0; i < baseIndexCount; i++)
+		{
+			uint32_t& vertexGroup = vertexGroups[mesh.indices[i]];
+			if (vertexGroup == UINT32_MAX)
+			{
+				vertexGroup = triangleGroups[i / 3];
+			}
+			else if (vertexGroup != triangleGroups[i / 3])
+			{
+				borderVertices.push_back(mesh.indices[i]);
+			}
+		}
+
+		size_t previousTriangles = baseIndexCount / 3;
+		for (uint32_t lod = 1; lod < lodCount; lod++)
+		{
+			size_t targetTriangles = static_cast<size_t>(previousTriangles * LOD_REDUCTION);
+
+			// Every level starts from LOD 0 so errors don't compound through intermediate levels
+			Simplification simplification(mesh.vertices, std::span<const uint32_t>(mesh.indices.data(), baseIndexCount));
+			for (uint32_t vertex : borderVertices)
+			{
+				simplification.Lock(vertex);
+			}
+			simplification.Run(targetTriangles);
+
+			size_t triangles = simplification.GetTriangleCount();
+			if (triangles == 0 || triangles > previousTriangles * (1.0f - LOD_MIN_GAIN))
+			{
+				break;
+			}
+
+			MeshLod meshLod{};
+			meshLod.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+			meshLod.indexCount = static_cast<uint32_t>(triangles * 3);
+			meshLod.error = std::max(simplification.GetError(), mesh.lods.back().error); // Selection relies on errors growing with the level
+			meshLod.firstSubMesh = static_cast<uint32_t>(mesh.submeshes.size());
+
+			for (uint32_t group = 0; group < groupMaterials.size(); group++)
+			{
+				std::vector<uint32_t> indices = simplification.GetIndices(triangleGroups, group);
+				if (indices.empty())
+				{
+					continue;
+				}
+
+				MeshOptimizer::OptimizeVertexCache(indices, static_cast<uint32_t>(mesh.vertices.size()));
+				mesh.submeshes.push_back({ static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(indices.size()), groupMaterials[group] });
+				mesh.indices.insert(mesh.indices.end(), indices.begin(), indices.end());
+			}
+
+			meshLod.subMeshCount = static_cast<uint32_t>(mesh.submeshes.size()) - meshLod.firstSubMesh;
+			mesh.lods.push_back(meshLod);
+			previousTriangles = triangles;
+		}
+	}
+}
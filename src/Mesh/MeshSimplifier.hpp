@@ -0,0 +1,25 @@
+#pragma once
+
+#include "MeshData.hpp"
+
+#include <span>
+
+namespace VE
+{
+	// Quadric error metric edge collapse (Garland and Heckbert 1997) that only rewrites indices,
+	// so every LOD shares the vertices of LOD 0. Vertices on open borders and UV seams never move.
+	class MeshSimplifier
+	{
+	public:
+		// Each LOD targets this fraction of the previous LOD's triangles
+		static inline constexpr float LOD_REDUCTION = 0.5f;
+		// A LOD that removes less than this fraction of the previous LOD's triangles is not worth storing
+		static inline constexpr float LOD_MIN_GAIN = 0.1f;
+	public:
+		// Returns the simplified indices and writes the largest collapse error in model units to resultError
+		static std::vector<uint32_t> Simplify(std::span<const Vertex> vertices, std::span<const uint32_t> indices, size_t targetIndexCount, float* resultError);
+		// Appends up to lodCount - 1 LODs after the indices of LOD 0 and fills MeshData::lods. Each LOD gets one
+		// submesh per material and vertices shared between materials never move
+		static void GenerateLods(MeshData& mesh, uint32_t lodCount);
+	};
+}
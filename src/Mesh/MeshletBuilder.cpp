@@ -0,0 +1,124 @@
+#include "MeshletBuilder.hpp"
+
+#include <span>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+namespace VE
+{
+	void MeshletBuilder::Build(MeshData& mesh)
+	{
+		mesh.meshlets.clear();
+
+		// Remembers which meshlet last counted a vertex so the unique vertex count needs no set
+		std::vector<uint32_t> lastMeshlet(mesh.vertices.size(), UINT32_MAX);
+		uint32_t meshletId = 0;
+
+		// Submeshes of the other LODs follow the ones of LOD 0
+		size_t submeshCount = mesh.lods.empty() ? mesh.submeshes.size() : mesh.lods[0].subMeshCount;
+		for (const auto& submesh : std::span<const SubMesh>(mesh.submeshes.data(), submeshCount))
+		{
+			uint32_t end = submesh.firstIndex + submesh.indexCount;
+			uint32_t first = submesh.firstIndex;
+			uint32_t vertexCount = 0;
+
+			for (uint32_t i = submesh.firstIndex; i < end; i += 3)
+			{
+				uint32_t newVertices = 0;
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					newVertices += lastMeshlet[mesh.indices[i + corner]] != meshletId ? 1 : 0;
+				}
+
+				uint32_t triangleCount = (i - first) / 3;
+				if (vertexCount + newVertices > MAX_VERTICES || triangleCount + 1 > MAX_TRIANGLES)
+				{
+					mesh.meshlets.push_back(ComputeBounds(mesh, first, i - first, submesh.material));
+					meshletId++;
+					first = i;
+					vertexCount = 0;
+				}
+
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t vertex = mesh.indices[i + corner];
+					if (lastMeshlet[vertex] != meshletId)
+					{
+						lastMeshlet[vertex] = meshletId;
+						vertexCount++;
+					}
+				}
+			}
+
+			if (end > first)
+			{
+				mesh.meshlets.push_back(ComputeBounds(mesh, first, end - first, submesh.material));
+				meshletId++;
+			}
+		}
+	}
+
+	Meshlet MeshletBuilder::ComputeBounds(const MeshData& mesh, uint32_t firstIndex, uint32_t indexCount, uint32_t material)
+	{
+		Meshlet meshlet{};
+		meshlet.firstIndex = firstIndex;
+		meshlet.indexCount = indexCount;
+		meshlet.material = material;
+
+		glm::vec3 min(std::numeric_limits<float>::max());
+		glm::vec3 max(std::numeric_limits<float>::lowest());
+		for (uint32_t i = firstIndex; i < firstIndex + indexCount; i++)
+		{
+			min = glm::min(min, mesh.vertices[mesh.indices[i]].position);
+			max = glm::max(max, mesh.vertices[mesh.indices[i]].position);
+		}
+
+		meshlet.center = (min + max) * 0.5f;
+		for (uint32_t i = firstIndex; i < firstIndex + indexCount; i++)
+		{
+			meshlet.radius = std::max(meshlet.radius, glm::length(mesh.vertices[mesh.indices[i]].position - meshlet.center));
+		}
+
+		// The cone axis averages the triangle normals, its spread decides whether the cluster can ever be fully back-facing
+		std::vector<glm::vec3> normals;
+		normals.reserve(indexCount / 3);
+		glm::vec3 axis(0.0f);
+		for (uint32_t i = firstIndex; i < firstIndex + indexCount; i += 3)
+		{
+			const glm::vec3& p0 = mesh.vertices[mesh.indices[i + 0]].position;
+			const glm::vec3& p1 = mesh.vertices[mesh.indices[i + 1]].position;
+			const glm::vec3& p2 = mesh.vertices[mesh.indices[i + 2]].position;
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float length = glm::length(normal);
+			if (length > 0.0f)
+			{
+				normals.push_back(normal / length);
+				axis += normal / length;
+			}
+		}
+
+		float axisLength = glm::length(axis);
+		meshlet.coneCutoff = 1.0f;
+		meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+		if (axisLength > 0.0f)
+		{
+			meshlet.coneAxis = axis / axisLength;
+
+			float minDot = 1.0f;
+			for (const auto& normal : normals)
+			{
+				minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+			}
+
+			// Cones of 90 degrees or wider always have a front-facing triangle
+			if (minDot > 0.0f)
+			{
+				meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+			}
+		}
+
+		return meshlet;
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "MeshData.hpp"
+
+namespace VE
+{
+	// Splits LOD 0 into contiguous index ranges small enough to cull individually, a meshlet never spans two submeshes.
+	// Runs after MeshOptimizer so the cache friendly triangle order also keeps meshlets spatially tight.
+	class MeshletBuilder
+	{
+	public:
+		static inline constexpr uint32_t MAX_VERTICES = 64;
+		static inline constexpr uint32_t MAX_TRIANGLES = 124;
+	public:
+		static void Build(MeshData& mesh);
+	private:
+		static Meshlet ComputeBounds(const MeshData& mesh, uint32_t firstIndex, uint32_t indexCount, uint32_t material);
+	};
+}
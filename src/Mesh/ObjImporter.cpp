@@ -0,0 +1,159 @@
+#include "ObjImporter.hpp"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tinyobjloader/tiny_obj_loader.h"
+
+#include "VertexHashMap.hpp"
+
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+
+namespace VE
+{
+	// Below this many indices per thread the cost of spawning threads outweighs the work
+	static constexpr size_t MIN_INDICES_PER_THREAD = 64 * 1024;
+
+	struct DedupChunk
+	{
+		std::vector<Vertex>		vertices; // Unique within the chunk, in first occurrence order
+		std::vector<uint32_t>	indices; // Into the chunk's vertices until remapped
+	};
+
+	static void DedupRange(const tinyobj::attrib_t& attrib, const std::vector<tinyobj::index_t>& objIndices, size_t begin, size_t end, DedupChunk& chunk)
+	{
+		VertexHashMap uniqueVertices((end - begin) / 4);
+		chunk.indices.reserve(end - begin);
+
+		for (size_t i = begin; i < end; i++)
+		{
+			const auto& index = objIndices[i];
+			Vertex vertex{};
+
+			vertex.position =
+			{
+				attrib.vertices[3 * index.vertex_index + 0],
+				attrib.vertices[3 * index.vertex_index + 1],
+				attrib.vertices[3 * index.vertex_index + 2]
+			};
+
+			if (index.texcoord_index >= 0)
+			{
+				vertex.texCoords =
+				{
+					attrib.texcoords[2 * index.texcoord_index + 0],
+					1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
+				};
+			}
+
+			vertex.color =
+			{
+				1.0f, 1.0f, 1.0f
+			};
+
+			auto [uniqueIndex, inserted] = uniqueVertices.TryEmplace(vertex, static_cast<uint32_t>(chunk.vertices.size()));
+			if (inserted)
+			{
+				chunk.vertices.push_back(vertex);
+			}
+
+			chunk.indices.push_back(uniqueIndex);
+		}
+	}
+
+	MeshData ObjImporter::Import(std::string_view filepath, const ImportSettings& settings)
+	{
+		tinyobj::attrib_t attrib;
+		std::vector<tinyobj::shape_t> shapes;
+		std::vector<tinyobj::material_t> materials;
+		std::string warn, err;
+
+		std::string path(filepath);
+		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str()))
+		{
+			throw std::runtime_error(warn + err);
+		}
+
+		MeshData mesh;
+
+		// Shapes are concatenated so the index stream can be split evenly regardless of shape sizes
+		std::vector<tinyobj::index_t> objIndices;
+		for (const auto& shape : shapes)
+		{
+			mesh.submeshes.push_back({ static_cast<uint32_t>(objIndices.size()), static_cast<uint32_t>(shape.mesh.indices.size()) });
+			objIndices.insert(objIndices.end(), shape.mesh.indices.begin(), shape.mesh.indices.end());
+		}
+
+		size_t threadCount = settings.threadCount ? settings.threadCount : std::max(1u, std::thread::hardware_concurrency());
+		threadCount = std::clamp<size_t>(objIndices.size() / MIN_INDICES_PER_THREAD, 1, threadCount);
+
+		std::vector<DedupChunk> chunks(threadCount);
+		size_t chunkSize = (objIndices.size() + threadCount - 1) / threadCount;
+		auto chunkBegin = [&](size_t chunk) { return std::min(chunk * chunkSize, objIndices.size()); };
+
+		{
+			std::vector<std::thread> workers;
+			for (size_t i = 1; i < threadCount; i++)
+			{
+				workers.emplace_back(DedupRange, std::cref(attrib), std::cref(objIndices), chunkBegin(i), chunkBegin(i + 1), std::ref(chunks[i]));
+			}
+			DedupRange(attrib, objIndices, chunkBegin(0), chunkBegin(1), chunks[0]);
+
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+		// Merging chunks in order keeps the first occurrence order, the result matches a single threaded import
+		size_t chunkVertexCount = 0;
+		for (const auto& chunk : chunks)
+		{
+			chunkVertexCount += chunk.vertices.size();
+		}
+
+		VertexHashMap uniqueVertices(chunkVertexCount);
+		std::vector<std::vector<uint32_t>> remaps(threadCount);
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			remaps[i].reserve(chunks[i].vertices.size());
+			for (const auto& vertex : chunks[i].vertices)
+			{
+				auto [uniqueIndex, inserted] = uniqueVertices.TryEmplace(vertex, static_cast<uint32_t>(mesh.vertices.size()));
+				if (inserted)
+				{
+					mesh.vertices.push_back(vertex);
+				}
+				remaps[i].push_back(uniqueIndex);
+			}
+		}
+
+		mesh.indices.resize(objIndices.size());
+		{
+			auto remapChunk = [&](size_t chunk)
+			{
+				const auto& remap = remaps[chunk];
+				const auto& local = chunks[chunk].indices;
+				uint32_t* dst = mesh.indices.data() + chunkBegin(chunk);
+				for (size_t i = 0; i < local.size(); i++)
+				{
+					dst[i] = remap[local[i]];
+				}
+			};
+
+			std::vector<std::thread> workers;
+			for (size_t i = 1; i < threadCount; i++)
+			{
+				workers.emplace_back(remapChunk, i);
+			}
+			remapChunk(0);
+
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+		return mesh;
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "MeshData.hpp"
+
+#include <string_view>
+
+namespace VE
+{
+	class ObjImporter
+	{
+	public:
+		// Returns the deduplicated mesh with 32 bit indices, MeshData::Finalize is left to the caller
+		static MeshData Import(std::string_view filepath, const ImportSettings& settings);
+	};
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Buffer/Buffer.hpp"
+
+#include <vector>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define VE_VERTEX_HASH_SSE2
+#endif
+
+namespace VE
+{
+	// Flat open addressing map from Vertex to its index, used to deduplicate vertices during import.
+	// Vertices are hashed and compared bitwise, so -0.0 and 0.0 are distinct keys while identical NaNs match.
+	class VertexHashMap
+	{
+	public:
+		explicit VertexHashMap(size_t expectedCount = 0)
+		{
+			Reserve(expectedCount);
+		}
+	public:
+		static inline constexpr uint32_t EMPTY = 0;
+	public:
+		inline size_t Size() const { return m_Size; }
+
+		void Reserve(size_t count)
+		{
+			size_t capacity = 16;
+			while (capacity * MAX_LOAD_NUM < count * MAX_LOAD_DEN)
+			{
+				capacity *= 2;
+			}
+
+			if (capacity > m_Tags.size())
+			{
+				Rehash(capacity);
+			}
+		}
+
+		// Returns the index stored for the vertex and whether it was inserted by this call
+		std::pair<uint32_t, bool> TryEmplace(const Vertex& vertex, uint32_t value)
+		{
+			if ((m_Size + 1) * MAX_LOAD_DEN > m_Tags.size() * MAX_LOAD_NUM)
+			{
+				Rehash(m_Tags.size() * 2);
+			}
+
+			uint64_t hash = Hash(vertex);
+			uint32_t tag = Tag(hash);
+			size_t mask = m_Tags.size() - 1;
+
+			for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+			{
+				if (m_Tags[slot] == EMPTY)
+				{
+					m_Tags[slot] = tag;
+					m_Keys[slot] = vertex;
+					m_Values[slot] = value;
+					m_Size++;
+					return { value, true };
+				}
+
+				if (m_Tags[slot] == tag && Equal(m_Keys[slot], vertex))
+				{
+					return { m_Values[slot], false };
+				}
+			}
+		}
+	private:
+		static_assert(sizeof(Vertex) == 32, "VertexHashMap hashes and compares Vertex as two 16 byte halves");
+
+		// Keep the table at most 3/4 full so linear probe sequences stay short
+		static inline constexpr size_t MAX_LOAD_NUM = 3;
+		static inline constexpr size_t MAX_LOAD_DEN = 4;
+	private:
+		static inline uint64_t Hash(const Vertex& vertex)
+		{
+			uint64_t words[4];
+			std::memcpy(words, &vertex, sizeof(words));
+
+			uint64_t hash = 0x9E3779B97F4A7C15ull;
+			for (uint64_t word : words)
+			{
+				hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+				hash ^= hash >> 32;
+			}
+
+			// Final avalanche so the low bits used for the slot depend on every input bit
+			hash ^= hash >> 33;
+			hash *= 0xC4CEB9FE1A85EC53ull;
+			hash ^= hash >> 33;
+			return hash;
+		}
+
+		// The upper half of the hash, never EMPTY, rejects most mismatching slots without touching the key
+		static inline uint32_t Tag(uint64_t hash)
+		{
+			return static_cast<uint32_t>(hash >> 32) | 1u;
+		}
+
+		static inline bool Equal(const Vertex& a, const Vertex& b)
+		{
+		#ifdef VE_VERTEX_HASH_SSE2
+			const char* pa = reinterpret_cast<const char*>(&a);
+			const char* pb = reinterpret_cast<const char*>(&b);
+			__m128i lo = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb)));
+			__m128i hi = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + 16)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + 16)));
+			return _mm_movemask_epi8(_mm_and_si128(lo, hi)) == 0xFFFF;
+		#else
+			return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+		#endif
+		}
+
+		void Rehash(size_t capacity)
+		{
+			std::vector<uint32_t> tags(capacity, EMPTY);
+			std::vector<Vertex> keys(capacity);
+			std::vector<uint32_t> values(capacity);
+			size_t mask = capacity - 1;
+
+			for (size_t i = 0; i < m_Tags.size(); i++)
+			{
+				if (m_Tags[i] == EMPTY)
+				{
+					continue;
+				}
+
+				size_t slot = Hash(m_Keys[i]) & mask;
+				while (tags[slot] != EMPTY)
+				{
+					slot = (slot + 1) & mask;
+				}
+
+				tags[slot] = m_Tags[i];
+				keys[slot] = m_Keys[i];
+				values[slot] = m_Values[i];
+			}
+
+			m_Tags = std::move(tags);
+			m_Keys = std::move(keys);
+			m_Values = std::move(values);
+		}
+	private:
+		std::vector<uint32_t>	m_Tags;
+		std::vector<Vertex>		m_Keys;
+		std::vector<uint32_t>	m_Values;
+		size_t					m_Size = 0;
+	};
+}
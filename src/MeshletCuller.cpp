@@ -0,0 +1,248 @@
+#include "MeshletCuller.hpp"
+
+#include "Swapchain.hpp"
+#include "Pipeline.hpp"
+
+#include "Descriptor/DescriptorAllocator.hpp"
+
+#include "Utilities.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <algorithm>
+
+namespace VE
+{
+	MeshletCuller::MeshletCuller(Device* device)
+		:	m_Device(device), m_DescriptorSetLayout(VK_NULL_HANDLE), m_PipelineLayout(VK_NULL_HANDLE),
+			m_Pipeline(VK_NULL_HANDLE), m_MaxDrawIndirectCount(1)
+	{
+		// Without multiDrawIndirect every indirect draw is limited to a single command
+		if (m_Device->GetEnabledFeatures().multiDrawIndirect)
+		{
+			m_MaxDrawIndirectCount = m_Device->GetProperties().limits.maxDrawIndirectCount;
+		}
+
+		CreateDescriptorSetLayout();
+		CreatePipeline();
+		CreateFrameData();
+	}
+
+	MeshletCuller::~MeshletCuller()
+	{
+		vkDestroyPipeline(m_Device->GetVkDevice(), m_Pipeline, nullptr);
+		vkDestroyPipelineLayout(m_Device->GetVkDevice(), m_PipelineLayout, nullptr);
+		vkDestroyDescriptorSetLayout(m_Device->GetVkDevice(), m_DescriptorSetLayout, nullptr);
+	}
+
+	void MeshletCuller::Cull(VkCommandBuffer commandBuffer, uint32_t frame, std::span<Model* const> models)
+	{
+		FrameData& frameData = m_Frames[frame];
+		frameData.culledModels.clear();
+
+		uint32_t drawCount = 0;
+		m_MaterialIndices.clear();
+		for (const Model* model : models)
+		{
+			uint32_t meshletCount = model->GetMeshletCount();
+			uint32_t materialCount = model->GetMesh()->GetMaterialCount();
+			uint32_t materialOffset = static_cast<uint32_t>(m_MaterialIndices.size());
+			bool canCull =	meshletCount > 0 && model->GetCurrentLod() == 0 && model->IsReady() &&
+							frameData.culledModels.size() < MAX_DISPATCHES && drawCount + meshletCount <= MAX_DRAWS &&
+							materialOffset + materialCount + 1 <= MAX_MATERIAL_SLOTS;
+			if (canCull)
+			{
+				frameData.culledModels.push_back({ model, drawCount, meshletCount, materialOffset });
+				drawCount += meshletCount;
+
+				// The slot after the mesh's materials serves meshlets without one, see Mesh::Upload
+				for (uint32_t material = 0; material < materialCount; material++)
+				{
+					m_MaterialIndices.push_back(model->GetMaterialIndex(material));
+				}
+				m_MaterialIndices.push_back(model->GetMaterialIndex(UINT32_MAX));
+			}
+		}
+
+		if (frameData.culledModels.empty())
+		{
+			return;
+		}
+
+		// Slots the compaction doesn't reach have to hold zero index counts so they draw nothing
+		VkDeviceSize drawBytes = static_cast<VkDeviceSize>(drawCount) * sizeof(VkDrawIndexedIndirectCommand);
+		VkDeviceSize counterBytes = static_cast<VkDeviceSize>(frameData.culledModels.size()) * sizeof(uint32_t);
+		vkCmdFillBuffer(commandBuffer, frameData.drawBuffer->GetVkBuffer(), 0, drawBytes, 0);
+		vkCmdFillBuffer(commandBuffer, frameData.counterBuffer->GetVkBuffer(), 0, counterBytes, 0);
+		vkCmdUpdateBuffer(commandBuffer, frameData.materialBuffer->GetVkBuffer(), 0, m_MaterialIndices.size() * sizeof(uint32_t), m_MaterialIndices.data());
+
+		VkMemoryBarrier fillBarrier{};
+		fillBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		fillBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		fillBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &fillBarrier, 0, nullptr, 0, nullptr);
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+
+		for (uint32_t i = 0; i < frameData.culledModels.size(); i++)
+		{
+			const CulledModel& culled = frameData.culledModels[i];
+
+			// Released with the rest of the frame's transient sets once its fence has signaled
+			VkDescriptorSet descriptorSet = m_Device->GetFrameDescriptorAllocator(frame).Allocate(m_DescriptorSetLayout);
+
+			std::array<VkDescriptorBufferInfo, 4> bufferInfos{};
+			bufferInfos[0] = { culled.model->GetMeshletBuffer(), 0, VK_WHOLE_SIZE };
+			bufferInfos[1] = { frameData.drawBuffer->GetVkBuffer(), 0, VK_WHOLE_SIZE };
+			bufferInfos[2] = { frameData.counterBuffer->GetVkBuffer(), 0, VK_WHOLE_SIZE };
+			bufferInfos[3] = { frameData.materialBuffer->GetVkBuffer(), 0, VK_WHOLE_SIZE };
+
+			std::array<VkWriteDescriptorSet, 4> writes{};
+			for (uint32_t binding = 0; binding < writes.size(); binding++)
+			{
+				writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writes[binding].dstSet = descriptorSet;
+				writes[binding].dstBinding = binding;
+				writes[binding].descriptorCount = 1;
+				writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				writes[binding].pBufferInfo = &bufferInfos[binding];
+			}
+			vkUpdateDescriptorSets(m_Device->GetVkDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+			CullParams params = ComputeCullParams(*culled.model);
+			params.meshletCount = culled.drawCount;
+			params.drawOffset = culled.drawOffset;
+			params.counterIndex = i;
+			params.materialOffset = culled.materialOffset;
+
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+			vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+			vkCmdDispatch(commandBuffer, (culled.drawCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+		}
+
+		VkMemoryBarrier cullBarrier{};
+		cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		cullBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &cullBarrier, 0, nullptr, 0, nullptr);
+	}
+
+	bool MeshletCuller::Draw(VkCommandBuffer commandBuffer, uint32_t frame, const Model& model) const
+	{
+		const FrameData& frameData = m_Frames[frame];
+		auto culled = std::find_if(frameData.culledModels.begin(), frameData.culledModels.end(), [&model](const CulledModel& entry)
+		{
+			return entry.model == &model;
+		});
+
+		if (culled == frameData.culledModels.end())
+		{
+			return false;
+		}
+
+		// Survivors sit at the front of the range and the zeroed tail draws nothing, so the whole range can be issued
+		constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+		for (uint32_t first = 0; first < culled->drawCount; first += m_MaxDrawIndirectCount)
+		{
+			uint32_t count = std::min(m_MaxDrawIndirectCount, culled->drawCount - first);
+			VkDeviceSize offset = static_cast<VkDeviceSize>(culled->drawOffset + first) * stride;
+			vkCmdDrawIndexedIndirect(commandBuffer, frameData.drawBuffer->GetVkBuffer(), offset, count, stride);
+		}
+
+		return true;
+	}
+
+	void MeshletCuller::CreateDescriptorSetLayout()
+	{
+		std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+		for (uint32_t i = 0; i < bindings.size(); i++)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VK_CHECK(vkCreateDescriptorSetLayout(m_Device->GetVkDevice(), &layoutInfo, nullptr, &m_DescriptorSetLayout))
+	}
+
+	void MeshletCuller::CreatePipeline()
+	{
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(CullParams);
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		VK_CHECK(vkCreatePipelineLayout(m_Device->GetVkDevice(), &layoutInfo, nullptr, &m_PipelineLayout))
+
+		auto shaderCode = Pipeline::ReadShaderFile("meshletcullcomp.spv");
+		VkShaderModule shaderModule = Pipeline::CreateShaderModule(m_Device, shaderCode);
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(m_Device->GetVkDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline);
+		vkDestroyShaderModule(m_Device->GetVkDevice(), shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			throw std::runtime_error("Error: Failed to create meshlet culling pipeline!");
+		}
+	}
+
+	void MeshletCuller::CreateFrameData()
+	{
+		m_Frames.resize(Swapchain::MAX_FRAMES_IN_FLIGHT);
+
+		for (auto& frame : m_Frames)
+		{
+			frame.drawBuffer = std::make_unique<StorageBuffer>(m_Device, MAX_DRAWS * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+			frame.counterBuffer = std::make_unique<StorageBuffer>(m_Device, MAX_DISPATCHES * sizeof(uint32_t));
+			frame.materialBuffer = std::make_unique<StorageBuffer>(m_Device, MAX_MATERIAL_SLOTS * sizeof(uint32_t));
+		}
+	}
+
+	MeshletCuller::CullParams MeshletCuller::ComputeCullParams(const Model& model) const
+	{
+		const DescriptorSet::GlobalUniform& uniforms = model.m_GUBO;
+
+		// Meshlet bounds are in the model's own space, before any vertex dequantization
+		glm::mat4 modelView = uniforms.view * model.GetModelTransform();
+		glm::mat4 clip = uniforms.proj * modelView;
+
+		auto row = [&clip](int i) { return glm::vec4(clip[0][i], clip[1][i], clip[2][i], clip[3][i]); };
+
+		CullParams params{};
+		params.planes[0] = row(3) + row(0);	// Left
+		params.planes[1] = row(3) - row(0);	// Right
+		params.planes[2] = row(3) + row(1);	// Bottom
+		params.planes[3] = row(3) - row(1);	// Top
+		params.planes[4] = row(2);			// Near, Vulkan clips depth to [0, w]
+		params.planes[5] = row(3) - row(2);	// Far
+
+		for (auto& plane : params.planes)
+		{
+			plane /= glm::length(glm::vec3(plane));
+		}
+
+		params.cameraPosition = glm::inverse(modelView)[3];
+		return params;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "Device.hpp"
+#include "Model.hpp"
+
+#include "Buffer/StorageBuffer.hpp"
+
+#include <vector>
+#include <memory>
+#include <span>
+
+namespace VE
+{
+	// Culls the meshlets of every model drawn at LOD 0 against the frustum and their normal cones on the GPU
+	// and compacts the survivors into an indirect draw buffer, one range per model and frame in flight.
+	// Each draw's first instance is looked up by the meshlet's material in a per frame table of bindless indices.
+	class MeshletCuller
+	{
+	public:
+		explicit MeshletCuller(Device* device);
+		~MeshletCuller();
+
+		MeshletCuller(const MeshletCuller& otherCuller) = delete;
+		MeshletCuller& operator=(const MeshletCuller& otherCuller) = delete;
+	public:
+		static inline constexpr uint32_t MAX_DRAWS = 64 * 1024;
+		static inline constexpr uint32_t MAX_DISPATCHES = 256;
+		static inline constexpr uint32_t WORKGROUP_SIZE = 64;
+		// The table is written with vkCmdUpdateBuffer, which takes at most 64 KB
+		static inline constexpr uint32_t MAX_MATERIAL_SLOTS = 16 * 1024;
+	public:
+		// Records the culling dispatches, has to be called outside of the render pass
+		void Cull(VkCommandBuffer commandBuffer, uint32_t frame, std::span<Model* const> models);
+		// Draws the meshlets of a model culled this frame, returns false if the model has to be drawn without culling
+		bool Draw(VkCommandBuffer commandBuffer, uint32_t frame, const Model& model) const;
+	private:
+		struct CullParams
+		{
+			glm::vec4	planes[6];
+			glm::vec4	cameraPosition;
+			uint32_t	meshletCount;
+			uint32_t	drawOffset;
+			uint32_t	counterIndex;
+			uint32_t	materialOffset;
+		};
+
+		struct CulledModel
+		{
+			const Model*	model;
+			uint32_t		drawOffset;
+			uint32_t		drawCount;
+			uint32_t		materialOffset;
+		};
+
+		struct FrameData
+		{
+			std::unique_ptr<StorageBuffer>	drawBuffer;
+			std::unique_ptr<StorageBuffer>	counterBuffer;
+			std::unique_ptr<StorageBuffer>	materialBuffer;
+			std::vector<CulledModel>		culledModels;
+		};
+	private:
+		void CreateDescriptorSetLayout();
+		void CreatePipeline();
+		void CreateFrameData();
+		CullParams ComputeCullParams(const Model& model) const;
+	private:
+		Device*							m_Device;
+		VkDescriptorSetLayout			m_DescriptorSetLayout;
+		VkPipelineLayout				m_PipelineLayout;
+		VkPipeline						m_Pipeline;
+		uint32_t						m_MaxDrawIndirectCount;
+		std::vector<FrameData>			m_Frames;
+		std::vector<uint32_t>			m_MaterialIndices; // Scratch for the table recorded by Cull
+	};
+}
@@ -1,118 +1,149 @@
 #include "Model.hpp"
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "tinyobjloader/tiny_obj_loader.h"
+#include "Descriptor/BindlessTextureArray.hpp"
+
 #include "glm/gtx/transform.hpp"
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
 
-#include <unordered_map>
 #include <chrono>
-
-namespace std
-{
-	template<> struct hash<VE::Vertex> {
-		size_t operator()(VE::Vertex const& vertex) const
-		{
-			return ((hash<glm::vec3>()(vertex.position) ^
-				(hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^
-				(hash<glm::vec2>()(vertex.texCoords) << 1);
-		}
-	};
-}
+#include <cmath>
 
 namespace VE
 {
-	Model::Model(Device* device, std::string_view modelPath)
-		:	m_Device(device), m_ModelPath(modelPath.data()),
-			m_DescriptorSet(device), m_Transform(glm::mat4(1.0f))
+	Model::Model(Device* device)
+		:	m_Device(device), m_CurrentLod(0), m_DescriptorSet(device), m_Transform(glm::mat4(1.0f))
 	{
 		m_DescriptorSet.Create();
-		m_DescriptorSet.SetTexture(0, 1, "D:\\OpenGL Projects\\VulkanEngine\\Res\\Textures\\viking_room.png");
-		m_DescriptorSet.SetTexture(1, 1, "D:\\OpenGL Projects\\VulkanEngine\\Res\\Textures\\viking_room.png");
+	}
+
+	bool Model::IsReady() const
+	{
+		if (!m_Mesh || !m_Mesh->IsReady())
+		{
+			return false;
+		}
+		if (m_VirtualTexture)
+		{
+			return m_VirtualTexture->IsReady();
+		}
+
+		// Every LOD draws the materials of LOD 0, so its submeshes cover all textures the model samples
+		const MeshLod& lod = m_Mesh->GetLods()[0];
+		for (uint32_t i = lod.firstSubMesh; i < lod.firstSubMesh + lod.subMeshCount; i++)
+		{
+			const std::shared_ptr<Texture>& texture = GetTexture(m_Mesh->GetSubMeshes()[i].material);
+			if (!texture || !texture->IsReady())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
 
-		LoadModel();
+	const std::shared_ptr<Texture>& Model::GetTexture() const
+	{
+		const std::vector<SubMesh>& submeshes = m_Mesh->GetSubMeshes();
+		return GetTexture(submeshes.empty() ? UINT32_MAX : submeshes[0].material);
 	}
 
-	void Model::Bind(VkCommandBuffer commandBuffer) const
+	uint32_t Model::GetMaterialIndex(uint32_t material) const
 	{
-		m_VertexBuffer->BindBuffer(commandBuffer);
-		m_IndexBuffer->BindBuffer(commandBuffer);
+		const std::shared_ptr<Texture>& texture = GetTexture(material);
+		if (m_VirtualTexture || !texture || texture->GetBindlessIndex() == BindlessTextureArray::INVALID_INDEX)
+		{
+			return 0;
+		}
+		return texture->GetBindlessIndex();
 	}
 
 	void Model::Draw(VkCommandBuffer commandBuffer) const
 	{
-		vkCmdDrawIndexed(commandBuffer, m_IndexBuffer->GetDataCount(), 1, 0, 0, 0);
+		// Geometry lives in the shared pool, the renderer binds its page before drawing
+		const MeshLod& lod = m_Mesh->GetLods()[m_CurrentLod];
+		const GeometryHandle& geometry = m_Mesh->GetGeometry();
+
+		// A single texture is bound without bindless textures, so the whole level goes out as one draw
+		if (m_VirtualTexture || !m_Device->HasBindlessTextures())
+		{
+			vkCmdDrawIndexed(commandBuffer, lod.indexCount, 1, geometry.firstIndex + lod.firstIndex, geometry.vertexOffset, 0);
+			return;
+		}
+
+		// One draw per run of adjacent submeshes sharing a texture, each carrying that texture's index
+		const std::vector<SubMesh>& submeshes = m_Mesh->GetSubMeshes();
+		uint32_t end = lod.firstSubMesh + lod.subMeshCount;
+		for (uint32_t i = lod.firstSubMesh; i < end;)
+		{
+			uint32_t materialIndex = GetMaterialIndex(submeshes[i].material);
+			uint32_t firstIndex = submeshes[i].firstIndex;
+			uint32_t indexCount = 0;
+			for (; i < end && submeshes[i].firstIndex == firstIndex + indexCount && GetMaterialIndex(submeshes[i].material) == materialIndex; i++)
+			{
+				indexCount += submeshes[i].indexCount;
+			}
+			vkCmdDrawIndexed(commandBuffer, indexCount, 1, geometry.firstIndex + firstIndex, geometry.vertexOffset, materialIndex);
+		}
 	}
 
-	void Model::LoadModel()
+	void Model::SelectLod(float viewportHeight)
 	{
-		tinyobj::attrib_t attrib;
-		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string warn, err;
+		const MeshBounds& bounds = m_Mesh->GetBounds();
+		const std::vector<MeshLod>& lods = m_Mesh->GetLods();
 
-		std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-		std::vector<Vertex> vertices;
-		std::vector<uint16_t> indices;
+		glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+		float radius = glm::length(bounds.max - bounds.min) * 0.5f;
 
-		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, m_ModelPath))
+		// Distance to the nearest point of the bounding sphere, inside of it the full mesh is drawn
+		glm::vec4 viewCenter = m_GUBO.view * m_Transform * glm::vec4(center, 1.0f);
+		float distance = -viewCenter.z - radius;
+		if (distance <= 0.0f)
 		{
-			throw std::runtime_error(warn + err);
+			m_CurrentLod = 0;
+			return;
 		}
 
-		for (const auto& shape : shapes)
+		// Projected size of one model unit in pixels at that distance
+		float pixelsPerUnit = std::abs(m_GUBO.proj[1][1]) * 0.5f * viewportHeight / distance;
+
+		uint32_t lod = 0;
+		for (uint32_t i = 1; i < lods.size(); i++)
 		{
-			for (const auto& index : shape.mesh.indices)
+			float threshold = i > m_CurrentLod ? LOD_PIXEL_ERROR * LOD_HYSTERESIS : LOD_PIXEL_ERROR;
+			if (lods[i].error * pixelsPerUnit > threshold)
 			{
-				Vertex vertex{};
-
-				vertex.position =
-				{
-					attrib.vertices[3 * index.vertex_index + 0],
-					attrib.vertices[3 * index.vertex_index + 1],
-					attrib.vertices[3 * index.vertex_index + 2]
-				};
-
-				vertex.texCoords = 
-				{
-					attrib.texcoords[2 * index.texcoord_index + 0],
-					1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-				};
-
-				vertex.color = 
-				{
-					1.0f, 1.0f, 1.0f 
-				};
-
-				if (uniqueVertices.count(vertex) == 0)
-				{
-					uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-					vertices.push_back(vertex);
-				}
-
-				indices.push_back(uniqueVertices[vertex]);
+				break;
 			}
+			lod = i;
 		}
 
-		m_VertexBuffer = std::make_unique<VertexBuffer>(m_Device, vertices.size() * sizeof(Vertex), vertices.data());
-		m_IndexBuffer = std::make_unique<IndexBuffer>(m_Device, indices.size() * sizeof(uint16_t), indices.data());
+		m_CurrentLod = lod;
 	}
 
-	void Model::UpdateDescriptors(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, const uint32_t currentFrame)
+	void Model::UpdateDescriptors(const uint32_t currentFrame)
 	{
 		static auto startTime = std::chrono::high_resolution_clock::now();
 
 		auto currentTime = std::chrono::high_resolution_clock::now();
 		float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
 
-		m_GUBO.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+		m_Transform = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+		m_GUBO.model = m_Transform * m_Mesh->GetVertexTransform();
 		m_GUBO.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
 		m_GUBO.proj = glm::perspective(glm::radians(45.0f), 1280.0f / 720.0f, 0.1f, 10.0f);
 		m_GUBO.proj[1][1] *= -1;
 
 		m_DescriptorSet.UpdateBuffer(currentFrame, 0, &m_GUBO, sizeof(m_GUBO));
-		m_DescriptorSet.UpdateImage(currentFrame, 1);
+
+		// Virtually textured models sample through their own set, the regular texture may not even be loaded.
+		// With bindless textures the draws carry the texture's index instead, see GetMaterialIndex
+		if (!m_VirtualTexture && !m_Device->HasBindlessTextures())
+		{
+			m_DescriptorSet.SetTexture(currentFrame, 1, GetTexture());
+			m_DescriptorSet.UpdateImage(currentFrame, 1);
+		}
+	}
+
+	void Model::BindDescriptors(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, const uint32_t currentFrame)
+	{
 		m_DescriptorSet.Bind(commandBuffer, pipelineLayout, currentFrame);
 	}
 }
\ No newline at end of file
@@ -3,43 +3,71 @@
 #include "glm/glm.hpp"
 
 #include "Device.hpp"
+#include "Texture.hpp"
+#include "VirtualTexture.hpp"
 
-#include "Buffer/Buffer.hpp"
-#include "Buffer/VertexBuffer.hpp"
-#include "Buffer/IndexBuffer.hpp"
+#include "Buffer/GeometryPool.hpp"
 
 #include "Descriptor/DescriptorSet.hpp"
 
+#include "Mesh/Mesh.hpp"
+
 #include <vector>
 #include <memory>
 
 namespace VE
 {
+	// One drawable instance of a shared mesh and texture, created empty and filled in by AssetLoader
 	class Model
 	{
 	public:
-		Model(Device* device, std::string_view modelPath);
+		explicit Model(Device* device);
 		~Model() = default;
 
 		Model(const Model& otherModel) = delete;
 		Model& operator=(const Model& otherModel) = delete;
 	public:
-		void Bind(VkCommandBuffer commandBuffer) const;
+		inline void SetMesh(std::shared_ptr<Mesh> mesh) { m_Mesh = std::move(mesh); }
+		// Used for submeshes the mesh doesn't bring a base color texture for
+		inline void SetTexture(std::shared_ptr<Texture> texture) { m_Texture = std::move(texture); }
+		// Takes precedence over both textures, the renderer switches to the virtual texture pipeline for it
+		inline void SetVirtualTexture(std::shared_ptr<VirtualTexture> texture) { m_VirtualTexture = std::move(texture); }
 		void Draw(VkCommandBuffer commandBuffer) const;
-		void UpdateDescriptors(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, const uint32_t currentFrame); // Optimize to not update unless resource change
+		// Picks the coarsest LOD whose error projects to at most LOD_PIXEL_ERROR pixels, uses the last uploaded transforms
+		void SelectLod(float viewportHeight);
+		void UpdateDescriptors(const uint32_t currentFrame);
+		void BindDescriptors(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, const uint32_t currentFrame);
 	public:
 		inline const glm::mat4& GetModelTransform() const { return m_Transform; }
-	private:
-		void LoadModel();
+		inline const std::shared_ptr<Mesh>& GetMesh() const { return m_Mesh; }
+		// Texture of a submesh's material, see SubMesh::material
+		inline const std::shared_ptr<Texture>& GetTexture(uint32_t material) const { return m_Mesh && m_Mesh->GetBaseColor(material) ? m_Mesh->GetBaseColor(material) : m_Texture; }
+		// Without bindless textures a model binds a single texture, the one of its first submesh
+		const std::shared_ptr<Texture>& GetTexture() const;
+		inline const std::shared_ptr<VirtualTexture>& GetVirtualTexture() const { return m_VirtualTexture; }
+		inline const GeometryHandle& GetGeometry() const { return m_Mesh->GetGeometry(); }
+		inline uint32_t GetMeshletCount() const { return m_Mesh->GetMeshletCount(); }
+		inline VkBuffer GetMeshletBuffer() const { return m_Mesh->GetMeshletBuffer(); }
+		inline uint32_t GetCurrentLod() const { return m_CurrentLod; }
+		// Bindless index of a material's texture, passed as the first instance of its draws so draws with different
+		// textures need no state change in between. 0 for virtual textures and without bindless textures
+		uint32_t GetMaterialIndex(uint32_t material) const;
+		// True once the mesh and the textures of all its submeshes have been uploaded and the copies have completed,
+		// a virtual texture only needs its top mip resident
+		bool IsReady() const;
+	public:
+		static inline constexpr float LOD_PIXEL_ERROR = 1.0f;
+		// Switching to a coarser LOD requires its error to drop this far below the threshold, so LODs don't flicker at the boundary
+		static inline constexpr float LOD_HYSTERESIS = 0.75f;
 	private:
 		Device*							m_Device;
-		const char*						m_ModelPath;
-		std::unique_ptr<VertexBuffer>	m_VertexBuffer;
-		std::unique_ptr<IndexBuffer>	m_IndexBuffer;
+		std::shared_ptr<Mesh>			m_Mesh;
+		std::shared_ptr<Texture>		m_Texture;
+		std::shared_ptr<VirtualTexture>	m_VirtualTexture;
+		uint32_t						m_CurrentLod;
 		DescriptorSet					m_DescriptorSet;
 		glm::mat4						m_Transform;
 	public:
 		DescriptorSet::GlobalUniform	m_GUBO;
 	};
 }
-
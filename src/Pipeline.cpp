@@ -18,7 +18,7 @@ namespace VE
         Clean();
     }
 
-    std::vector<char> Pipeline::ReadShaderFile(std::string_view filename) const
+    std::vector<char> Pipeline::ReadShaderFile(std::string_view filename)
     {
         std::string fullPath = "D:\\OpenGL Projects\\VulkanEngine\\Res\\Shaders\\" + std::string(filename.data());
         std::ifstream shaderFile(fullPath, std::ios::ate | std::ios::binary);
@@ -38,7 +38,7 @@ namespace VE
         return buffer;
     }
 
-    VkShaderModule Pipeline::CreateShaderModule(std::span<char> shaderCode) const
+    VkShaderModule Pipeline::CreateShaderModule(Device* device, std::span<char> shaderCode)
     {
         VkShaderModuleCreateInfo moduleCreateInfo{};
         moduleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -47,7 +47,7 @@ namespace VE
 
         VkShaderModule shaderModule;
 
-        VK_CHECK(vkCreateShaderModule(m_Device->GetVkDevice(), &moduleCreateInfo, nullptr, &shaderModule))
+        VK_CHECK(vkCreateShaderModule(device->GetVkDevice(), &moduleCreateInfo, nullptr, &shaderModule))
 
         return shaderModule;
     }
@@ -62,11 +62,11 @@ namespace VE
             configInfo.renderPass != VK_NULL_HANDLE &&
             "Cannot create graphics pipeline: no renderPass provided in configInfo");
 
-        auto vertexShaderCode = ReadShaderFile("basicshadervert.spv");
-        auto fragmentShaderCode = ReadShaderFile("basicshaderfrag.spv");
+        auto vertexShaderCode = ReadShaderFile(configInfo.vertexShaderFile);
+        auto fragmentShaderCode = ReadShaderFile(configInfo.fragmentShaderFile);
 
-        VkShaderModule vertexShaderModule = CreateShaderModule(vertexShaderCode);
-        VkShaderModule fragmentShaderModule = CreateShaderModule(fragmentShaderCode);
+        VkShaderModule vertexShaderModule = CreateShaderModule(m_Device, vertexShaderCode);
+        VkShaderModule fragmentShaderModule = CreateShaderModule(m_Device, fragmentShaderCode);
 
         VkPipelineShaderStageCreateInfo vertexShaderStageInfo{};
         vertexShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -116,6 +116,9 @@ namespace VE
 
     void Pipeline::DefaultPipelineConfig(PipelineConfigInfo& configInfo)
     {
+        configInfo.vertexShaderFile = "basicshadervert.spv";
+        configInfo.fragmentShaderFile = "basicshaderfrag.spv";
+
         configInfo.inputAssemblyInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
         configInfo.inputAssemblyInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
         configInfo.inputAssemblyInfo.primitiveRestartEnable = VK_FALSE;
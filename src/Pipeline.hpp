@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan.h>
 
+#include <string>
 #include <string_view>
 #include <span>
 #include <vector>
@@ -30,6 +31,8 @@ namespace VE
         VkPipelineLayout                                pipelineLayout{};
         VkRenderPass                                    renderPass{};
         uint32_t                                        subpass{};
+        std::string                                     vertexShaderFile{};
+        std::string                                     fragmentShaderFile{};
     };
 
     class Pipeline
@@ -43,9 +46,9 @@ namespace VE
     public:
         inline VkPipeline GetGraphicsPipeline() const { return m_GraphicsPipeline; }
         static void DefaultPipelineConfig(PipelineConfigInfo& configInfo);
+        static std::vector<char> ReadShaderFile(std::string_view filepath);
+        static VkShaderModule CreateShaderModule(Device* device, std::span<char> shaderCode);
     private:
-        std::vector<char> ReadShaderFile(std::string_view filepath) const;
-        VkShaderModule CreateShaderModule(std::span<char> shaderCode) const;
         void CreateGraphicsPipeline(const PipelineConfigInfo& configInfo);
         void Clean();
     private:
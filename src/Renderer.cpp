@@ -3,8 +3,19 @@
 #include "glm/glm.hpp"
 #include "glm/gtx/transform.hpp"
 
+#include "Buffer/UniformRing.hpp"
+#include "Buffer/GeometryPool.hpp"
+
+#include "VirtualTexture.hpp"
+#include "VirtualTextureCache.hpp"
+
+#include "Descriptor/BindlessTextureArray.hpp"
+#include "Descriptor/DescriptorWriter.hpp"
+#include "Descriptor/DescriptorAllocator.hpp"
+
 #include "Utilities.hpp"
 
+#include <array>
 #include <stdexcept>
 #include <cassert>
 #include <chrono>
@@ -13,10 +24,10 @@
 
 namespace VE
 {
-	Renderer::Renderer(Window* window, Device* device)
+	Renderer::Renderer(Window* window, Device* device, VertexFormat vertexFormat)
 		:	m_Window(window), m_Device(device), m_Swapchain(m_Device, m_Window),
-			m_PipelineLayout(VK_NULL_HANDLE), m_Pipeline(nullptr),
-			m_CurrentImageIndex{}
+			m_PipelineLayout(VK_NULL_HANDLE), m_VirtualTexturePipelineLayout(VK_NULL_HANDLE), m_VertexFormat(vertexFormat), m_Pipeline(nullptr),
+			m_MeshletCuller(std::make_unique<MeshletCuller>(device)), m_CurrentImageIndex{}
 	{
 		CreateCommandBuffers();
 		CreatePipelineLayout();
@@ -29,6 +40,10 @@ namespace VE
 		{
 			vkDestroyPipelineLayout(m_Device->GetVkDevice(), m_PipelineLayout, nullptr);
 		}
+		if (m_VirtualTexturePipelineLayout)
+		{
+			vkDestroyPipelineLayout(m_Device->GetVkDevice(), m_VirtualTexturePipelineLayout, nullptr);
+		}
 	}
 
 	void Renderer::CreateCommandBuffers()
@@ -51,7 +66,41 @@ namespace VE
 		layoutCreateInfo.setLayoutCount = static_cast<uint32_t>(m_Device->GetDescriptorSetLayouts().size());
 		layoutCreateInfo.pSetLayouts = m_Device->GetDescriptorSetLayouts().data();
 
+		// Set 1 is the bindless texture array, the texture index arrives as the draw's first instance
+		std::array<VkDescriptorSetLayout, 2> bindlessLayouts{};
+		if (m_Device->HasBindlessTextures())
+		{
+			bindlessLayouts = { m_Device->GetDescriptorSetLayouts()[0], m_Device->GetBindlessTextures().GetDescriptorSetLayout() };
+
+			layoutCreateInfo.setLayoutCount = static_cast<uint32_t>(bindlessLayouts.size());
+			layoutCreateInfo.pSetLayouts = bindlessLayouts.data();
+		}
+
 		VK_CHECK(vkCreatePipelineLayout(m_Device->GetVkDevice(), &layoutCreateInfo, nullptr, &m_PipelineLayout))
+
+		if (!m_Device->HasVirtualTextureCache())
+		{
+			return;
+		}
+
+		// Set 0 is the model's own set, set 1 holds the physical cache, the indirection and the feedback buffer
+		std::array<VkDescriptorSetLayout, 2> virtualTextureLayouts =
+		{
+			m_Device->GetDescriptorSetLayouts()[0],
+			m_Device->GetVirtualTextureCache().GetDescriptorSetLayout()
+		};
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(VirtualTextureCache::DrawParams);
+
+		layoutCreateInfo.setLayoutCount = static_cast<uint32_t>(virtualTextureLayouts.size());
+		layoutCreateInfo.pSetLayouts = virtualTextureLayouts.data();
+		layoutCreateInfo.pushConstantRangeCount = 1;
+		layoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+		VK_CHECK(vkCreatePipelineLayout(m_Device->GetVkDevice(), &layoutCreateInfo, nullptr, &m_VirtualTexturePipelineLayout))
 	}
 
 	void Renderer::CreatePipeline()
@@ -61,42 +110,89 @@ namespace VE
 
 		VkVertexInputBindingDescription bindingDesc{};
 		bindingDesc.binding = 0;
-		bindingDesc.stride = sizeof(Vertex);
+		bindingDesc.stride = VertexStride(m_VertexFormat);
 		bindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 		pipelineConfig.bindingDescriptions.push_back(bindingDesc);
 
+		// The shader reads the same locations for both formats, compact attributes are expanded by the fixed function fetch
+		bool isCompact = m_VertexFormat == VertexFormat::Compact;
+
 		VkVertexInputAttributeDescription posDesc{};
 		posDesc.binding = 0;
 		posDesc.location = 0;
-		posDesc.format = VK_FORMAT_R32G32B32_SFLOAT;
-		posDesc.offset = offsetof(Vertex, position);
+		posDesc.format = isCompact ? VK_FORMAT_R16G16B16A16_UNORM : VK_FORMAT_R32G32B32_SFLOAT;
+		posDesc.offset = isCompact ? offsetof(CompactVertex, position) : offsetof(Vertex, position);
 		pipelineConfig.attributeDescriptions.push_back(posDesc);
 
 		VkVertexInputAttributeDescription colorDesc{};
 		colorDesc.binding = 0;
 		colorDesc.location = 1;
-		colorDesc.format = VK_FORMAT_R32G32B32_SFLOAT;
-		colorDesc.offset = offsetof(Vertex, color);
+		colorDesc.format = isCompact ? VK_FORMAT_A2B10G10R10_UNORM_PACK32 : VK_FORMAT_R32G32B32_SFLOAT;
+		colorDesc.offset = isCompact ? offsetof(CompactVertex, normal) : offsetof(Vertex, color);
 		pipelineConfig.attributeDescriptions.push_back(colorDesc);
 
 		VkVertexInputAttributeDescription texCoordDesc{};
 		texCoordDesc.binding = 0;
 		texCoordDesc.location = 2;
-		texCoordDesc.format = VK_FORMAT_R32G32_SFLOAT;
-		texCoordDesc.offset = offsetof(Vertex, texCoords);
+		texCoordDesc.format = isCompact ? VK_FORMAT_R16G16_SFLOAT : VK_FORMAT_R32G32_SFLOAT;
+		texCoordDesc.offset = isCompact ? offsetof(CompactVertex, texCoords) : offsetof(Vertex, texCoords);
 		pipelineConfig.attributeDescriptions.push_back(texCoordDesc);
 
 		pipelineConfig.renderPass = m_Swapchain.GetRenderPass();
 		pipelineConfig.pipelineLayout = m_PipelineLayout;
 
+		if (m_Device->HasBindlessTextures())
+		{
+			pipelineConfig.vertexShaderFile = "bindlessvert.spv";
+			pipelineConfig.fragmentShaderFile = "bindlessfrag.spv";
+		}
+
 		m_Pipeline = std::make_unique<Pipeline>(m_Device, pipelineConfig);
+
+		if (m_Device->HasVirtualTextureCache())
+		{
+			pipelineConfig.vertexShaderFile = "basicshadervert.spv";
+			pipelineConfig.fragmentShaderFile = "virtualtexturefrag.spv";
+			pipelineConfig.pipelineLayout = m_VirtualTexturePipelineLayout;
+			m_VirtualTexturePipeline = std::make_unique<Pipeline>(m_Device, pipelineConfig);
+		}
 	}
 
-	void Renderer::DrawFrame(Model& model)
+	void Renderer::DrawFrame(std::span<Model* const> models)
 	{
 		VkCommandBuffer currCommandBuffer = GetCurrentCommandBuffer();
 		BeginFrame(currCommandBuffer);
 
+		// Streamed pages and indirection updates land before the models are checked, so a texture whose
+		// top mip arrives this frame is drawn right away
+		if (m_Device->HasVirtualTextureCache())
+		{
+			m_Device->GetVirtualTextureCache().Update(currCommandBuffer, m_Swapchain.GetCurrentFrame());
+		}
+
+		m_VisibleModels.clear();
+		for (Model* model : models)
+		{
+			if (model->IsReady())
+			{
+				m_VisibleModels.push_back(model);
+			}
+		}
+
+		for (Model* model : m_VisibleModels)
+		{
+			model->UpdateDescriptors(m_Swapchain.GetCurrentFrame());
+			model->SelectLod(static_cast<float>(m_Swapchain.GetExtent().height));
+		}
+
+		// Writing a set invalidates command buffers that already bound it, so changed descriptors go out before any bind
+		m_Device->GetDescriptorWriter().Flush();
+
+		// Culling writes the indirect draws, so it has to be recorded before the render pass begins
+		m_MeshletCuller->Cull(currCommandBuffer, m_Swapchain.GetCurrentFrame(), m_VisibleModels);
+
+		BeginRenderPass(currCommandBuffer);
+
 		// Draw Here
 		VkViewport viewport{};
 		viewport.x = 0.0f;
@@ -110,13 +206,52 @@ namespace VE
 		scissor.offset = { 0, 0 };
 		scissor.extent = m_Swapchain.GetExtent();
 
-		vkCmdBindPipeline(currCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline->GetGraphicsPipeline());
+		VkPipeline boundPipeline = m_Pipeline->GetGraphicsPipeline();
+		vkCmdBindPipeline(currCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, boundPipeline);
 		vkCmdSetViewport(currCommandBuffer, 0, 1, &viewport);
 		vkCmdSetScissor(currCommandBuffer, 0, 1, &scissor);
 
-		model.UpdateDescriptors(currCommandBuffer, m_PipelineLayout, m_Swapchain.GetCurrentFrame()); // Optimize to only update if resource change
-		model.Bind(currCommandBuffer);
-		model.Draw(currCommandBuffer);
+		bool isBindless = m_Device->HasBindlessTextures();
+		if (isBindless)
+		{
+			m_Device->GetBindlessTextures().Bind(currCommandBuffer, m_PipelineLayout, 1);
+		}
+
+		// All meshes share the pool's buffers, so only rebind when a draw lives in another page
+		uint32_t boundPage = UINT32_MAX;
+
+		for (Model* model : m_VisibleModels)
+		{
+			const std::shared_ptr<VirtualTexture>& virtualTexture = model->GetVirtualTexture();
+			VkPipelineLayout pipelineLayout = virtualTexture ? m_VirtualTexturePipelineLayout : m_PipelineLayout;
+			VkPipeline pipeline = virtualTexture ? m_VirtualTexturePipeline->GetGraphicsPipeline() : m_Pipeline->GetGraphicsPipeline();
+			if (pipeline != boundPipeline)
+			{
+				boundPipeline = pipeline;
+				vkCmdBindPipeline(currCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, boundPipeline);
+
+				// The virtual texture layout puts its own set at 1, so the array is bound again when switching back
+				if (isBindless && !virtualTexture)
+				{
+					m_Device->GetBindlessTextures().Bind(currCommandBuffer, pipelineLayout, 1);
+				}
+			}
+
+			model->BindDescriptors(currCommandBuffer, pipelineLayout, m_Swapchain.GetCurrentFrame());
+			if (virtualTexture)
+			{
+				m_Device->GetVirtualTextureCache().Bind(currCommandBuffer, pipelineLayout, m_Swapchain.GetCurrentFrame(), *virtualTexture);
+			}
+			if (model->GetGeometry().page != boundPage)
+			{
+				boundPage = model->GetGeometry().page;
+				m_Device->GetGeometryPool().Bind(currCommandBuffer, boundPage);
+			}
+			if (!m_MeshletCuller->Draw(currCommandBuffer, m_Swapchain.GetCurrentFrame(), *model))
+			{
+				model->Draw(currCommandBuffer);
+			}
+		}
 
 		EndFrame(currCommandBuffer);
 	}
@@ -136,6 +271,10 @@ namespace VE
 		}
 
 		vkResetFences(m_Device->GetVkDevice(), 1, &m_Swapchain.GetInFlightFences()[m_Swapchain.GetCurrentFrame()]);
+		m_Device->GetUniformRing().BeginFrame(m_Swapchain.GetCurrentFrame());
+		// AcquireNextImage waited on the frame's fence, so none of its transient sets are in use anymore
+		m_Device->GetFrameDescriptorAllocator(m_Swapchain.GetCurrentFrame()).Reset();
+		m_Device->GetGeometryPool().BeginFrame();
 		vkResetCommandBuffer(commandBuffer, 0);
 
 		VkCommandBufferBeginInfo beginInfo{};
@@ -144,7 +283,10 @@ namespace VE
 		beginInfo.pInheritanceInfo = nullptr;	// Optional
 
 		VK_CHECK(vkBeginCommandBuffer(m_CommandBuffers[m_Swapchain.GetCurrentFrame()], &beginInfo))
+	}
 
+	void Renderer::BeginRenderPass(VkCommandBuffer commandBuffer)
+	{
 		VkRenderPassBeginInfo renderPassInfo {};
 		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 		renderPassInfo.renderPass = m_Swapchain.GetRenderPass();
@@ -165,6 +307,10 @@ namespace VE
 	void Renderer::EndFrame(VkCommandBuffer commandBuffer)
 	{
 		vkCmdEndRenderPass(commandBuffer);
+		if (m_Device->HasVirtualTextureCache())
+		{
+			m_Device->GetVirtualTextureCache().EndFrame(commandBuffer);
+		}
 		VK_CHECK(vkEndCommandBuffer(commandBuffer))
 
 		VkSubmitInfo submitInfo {};
@@ -7,6 +7,7 @@
 #include "Swapchain.hpp"
 #include "Pipeline.hpp"
 #include "Model.hpp"
+#include "MeshletCuller.hpp"
 
 #include "Buffer/UniformBuffer.hpp"
 
@@ -14,24 +15,27 @@
 
 #include <vector>
 #include <memory>
+#include <span>
 
 namespace VE
 {
 	class Renderer
 	{
 	public:
-		Renderer(Window* window, Device* device);
+		Renderer(Window* window, Device* device, VertexFormat vertexFormat);
 		~Renderer();
 
 		Renderer(const Renderer& otherRenderer) = delete;
 		Renderer& operator=(const Renderer& otherRenderer) = delete;
 	public:
-		void DrawFrame(Model& model);
+		// Models that are still loading are skipped
+		void DrawFrame(std::span<Model* const> models);
 	private:
 		void CreateCommandBuffers();
 		void CreatePipelineLayout();
 		void CreatePipeline();
 		void BeginFrame(VkCommandBuffer commandBuffer);
+		void BeginRenderPass(VkCommandBuffer commandBuffer);
 		void EndFrame(VkCommandBuffer commandBuffer);
 	private:
 		inline VkCommandBuffer GetCurrentCommandBuffer() const { return m_CommandBuffers[m_Swapchain.GetCurrentFrame()]; }
@@ -41,7 +45,12 @@ namespace VE
 		Device*								m_Device;
 		Swapchain							m_Swapchain;
 		VkPipelineLayout					m_PipelineLayout;
+		VkPipelineLayout					m_VirtualTexturePipelineLayout; // Only with a virtual texture cache
+		VertexFormat						m_VertexFormat;
 		std::unique_ptr<Pipeline>			m_Pipeline;
+		std::unique_ptr<Pipeline>			m_VirtualTexturePipeline;
+		std::unique_ptr<MeshletCuller>		m_MeshletCuller;
+		std::vector<Model*>					m_VisibleModels;
 		uint32_t							m_CurrentImageIndex;
 
 		DescriptorSet::GlobalUniform		m_GUBO;
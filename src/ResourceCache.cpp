@@ -0,0 +1,105 @@
+#include "ResourceCache.hpp"
+
+#include "Swapchain.hpp"
+
+#include <filesystem>
+#include <cctype>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+
+namespace VE
+{
+	// Frames an entry has to stay unreferenced before it may be evicted, frames in flight may still be using it
+	static constexpr uint64_t EVICTION_DELAY = Swapchain::MAX_FRAMES_IN_FLIGHT + 1;
+
+	ResourceCache::ResourceCache(VkDeviceSize budget)
+		:	m_Budget(budget), m_UseCounter(0), m_Frame(0)
+	{
+	}
+
+	std::string ResourceCache::MakeKey(ResourceType type, std::string_view path, uint64_t parameters)
+	{
+		// Different spellings of the same file, e.g. relative paths or "..", have to map to one entry
+		std::error_code error;
+		std::filesystem::path canonical = std::filesystem::weakly_canonical(std::filesystem::path(path), error);
+		std::string key = error ? std::string(path) : canonical.make_preferred().string();
+
+	#ifdef _WIN32
+		std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	#endif
+
+		char suffix[24];
+		std::snprintf(suffix, sizeof(suffix), "|%016llx", static_cast<unsigned long long>(parameters));
+		static constexpr const char* prefixes[] = { "texture:", "mesh:", "virtualtexture:" };
+		return prefixes[static_cast<size_t>(type)] + key + suffix;
+	}
+
+	void ResourceCache::Trim()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Frame++;
+
+		VkDeviceSize totalSize = 0;
+		std::vector<std::unordered_map<std::string, Entry>::iterator> candidates;
+
+		for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+		{
+			Entry& entry = it->second;
+			totalSize += entry.memorySize();
+
+			// Only the cache holds it
+			if (entry.resource.use_count() == 1)
+			{
+				entry.unreferencedSince = std::min(entry.unreferencedSince, m_Frame);
+				if (m_Frame - entry.unreferencedSince >= EVICTION_DELAY)
+				{
+					candidates.push_back(it);
+				}
+			}
+			else
+			{
+				entry.unreferencedSince = UINT64_MAX;
+			}
+		}
+
+		if (totalSize <= m_Budget)
+		{
+			return;
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+		{
+			return a->second.lastUse < b->second.lastUse;
+		});
+
+		for (auto& it : candidates)
+		{
+			if (totalSize <= m_Budget)
+			{
+				break;
+			}
+
+			totalSize -= it->second.memorySize();
+			m_Entries.erase(it);
+		}
+	}
+
+	VkDeviceSize ResourceCache::GetMemorySize() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		VkDeviceSize totalSize = 0;
+		for (const auto& [key, entry] : m_Entries)
+		{
+			totalSize += entry.memorySize();
+		}
+		return totalSize;
+	}
+
+	size_t ResourceCache::GetEntryCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Entries.size();
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace VE
+{
+	enum class ResourceType
+	{
+		Texture,
+		Mesh,
+		VirtualTexture
+	};
+
+	// Deduplicates loaded resources by canonical path and load parameters and hands out shared handles.
+	// Entries nobody else references are kept around for reuse and evicted least recently used first
+	// once the device memory of all entries exceeds the budget. Lookups are thread safe, eviction and
+	// therefore resource destruction only happen in Trim, which has to be called on the main thread.
+	class ResourceCache
+	{
+	public:
+		explicit ResourceCache(VkDeviceSize budget);
+		~ResourceCache() = default;
+
+		ResourceCache(const ResourceCache& otherCache) = delete;
+		ResourceCache& operator=(const ResourceCache& otherCache) = delete;
+	public:
+		static std::string MakeKey(ResourceType type, std::string_view path, uint64_t parameters = 0);
+
+		// Returns the cached resource or one made by create, inserted reports whether the caller has to load it
+		template<typename T, typename CreateFunc>
+		std::shared_ptr<T> Acquire(const std::string& key, CreateFunc&& create, bool* inserted)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			auto it = m_Entries.find(key);
+			*inserted = it == m_Entries.end();
+			if (*inserted)
+			{
+				std::shared_ptr<T> resource = create();
+				Entry entry{};
+				entry.resource = resource;
+				entry.memorySize = [raw = resource.get()]() { return raw->GetMemorySize(); };
+				it = m_Entries.emplace(key, std::move(entry)).first;
+			}
+
+			it->second.lastUse = ++m_UseCounter;
+			it->second.unreferencedSince = UINT64_MAX;
+			return std::static_pointer_cast<T>(it->second.resource);
+		}
+
+		// Evicts unreferenced entries until the cache fits the budget, call once per frame
+		void Trim();
+		inline VkDeviceSize GetBudget() const { return m_Budget; }
+		VkDeviceSize GetMemorySize() const;
+		size_t GetEntryCount() const;
+	private:
+		struct Entry
+		{
+			std::shared_ptr<void>			resource;
+			std::function<VkDeviceSize()>	memorySize;
+			uint64_t						lastUse;
+			uint64_t						unreferencedSince; // Frame it was first seen unreferenced, UINT64_MAX while in use
+		};
+	private:
+		VkDeviceSize								m_Budget;
+		std::unordered_map<std::string, Entry>		m_Entries;
+		uint64_t									m_UseCounter;
+		uint64_t									m_Frame;
+		mutable std::mutex							m_Mutex;
+	};
+}
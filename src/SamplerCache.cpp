@@ -0,0 +1,100 @@
+#include "SamplerCache.hpp"
+
+#include "Utilities.hpp"
+
+#include <stdexcept>
+#include <cstring>
+
+namespace VE
+{
+	static_assert(sizeof(VkSamplerCreateFlags) == 4 && sizeof(VkFilter) == 4 && sizeof(VkBool32) == 4, "SamplerCache keys are hashed as 32 bit words");
+
+	SamplerCache::SamplerCache(Device* device)
+		:	m_Device(device)
+	{
+	}
+
+	SamplerCache::~SamplerCache()
+	{
+		for (const auto& [key, sampler] : m_Samplers)
+		{
+			vkDestroySampler(m_Device->GetVkDevice(), sampler, nullptr);
+		}
+	}
+
+	VkSampler SamplerCache::Get(const VkSamplerCreateInfo& createInfo)
+	{
+		if (createInfo.pNext)
+		{
+			throw std::runtime_error("Error: Cached samplers can't have chained create infos!");
+		}
+
+		Key key = MakeKey(createInfo);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto it = m_Samplers.find(key);
+		if (it != m_Samplers.end())
+		{
+			return it->second;
+		}
+
+		if (m_Samplers.size() >= m_Device->GetProperties().limits.maxSamplerAllocationCount)
+		{
+			throw std::runtime_error("Error: Exceeded maxSamplerAllocationCount!");
+		}
+
+		VkSampler sampler;
+		VK_CHECK(vkCreateSampler(m_Device->GetVkDevice(), &createInfo, nullptr, &sampler))
+
+		m_Samplers.emplace(key, sampler);
+		return sampler;
+	}
+
+	size_t SamplerCache::GetSamplerCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Samplers.size();
+	}
+
+	bool SamplerCache::Key::operator==(const Key& otherKey) const
+	{
+		return std::memcmp(this, &otherKey, sizeof(Key)) == 0;
+	}
+
+	size_t SamplerCache::KeyHash::operator()(const Key& key) const
+	{
+		uint32_t words[sizeof(Key) / sizeof(uint32_t)];
+		std::memcpy(words, &key, sizeof(Key));
+
+		uint64_t hash = 0x9E3779B97F4A7C15ull;
+		for (uint32_t word : words)
+		{
+			hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+			hash ^= hash >> 32;
+		}
+		return static_cast<size_t>(hash);
+	}
+
+	SamplerCache::Key SamplerCache::MakeKey(const VkSamplerCreateInfo& createInfo)
+	{
+		Key key{};
+		key.flags = createInfo.flags;
+		key.magFilter = createInfo.magFilter;
+		key.minFilter = createInfo.minFilter;
+		key.mipmapMode = createInfo.mipmapMode;
+		key.addressModeU = createInfo.addressModeU;
+		key.addressModeV = createInfo.addressModeV;
+		key.addressModeW = createInfo.addressModeW;
+		key.mipLodBias = createInfo.mipLodBias;
+		key.anisotropyEnable = createInfo.anisotropyEnable;
+		key.maxAnisotropy = createInfo.maxAnisotropy;
+		key.compareEnable = createInfo.compareEnable;
+		key.compareOp = createInfo.compareOp;
+		key.minLod = createInfo.minLod;
+		key.maxLod = createInfo.maxLod;
+		key.borderColor = createInfo.borderColor;
+		key.unnormalizedCoordinates = createInfo.unnormalizedCoordinates;
+		return key;
+	}
+}
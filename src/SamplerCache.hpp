@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "Device.hpp"
+
+#include <unordered_map>
+#include <mutex>
+
+namespace VE
+{
+	// Hands out one shared VkSampler per distinct sampler state instead of one per texture.
+	// Samplers are cheap to keep but limited by maxSamplerAllocationCount, so they live as long as the
+	// cache and are never destroyed by their users. Lookups are thread safe.
+	class SamplerCache
+	{
+	public:
+		explicit SamplerCache(Device* device);
+		~SamplerCache();
+
+		SamplerCache(const SamplerCache& otherCache) = delete;
+		SamplerCache& operator=(const SamplerCache& otherCache) = delete;
+	public:
+		// Every field of the create info is part of the key, chained structures are not supported
+		VkSampler Get(const VkSamplerCreateInfo& createInfo);
+		size_t GetSamplerCount() const;
+	private:
+		// The create info without sType and pNext, all members are 32 bit so the key has no padding
+		struct Key
+		{
+			VkSamplerCreateFlags	flags;
+			VkFilter				magFilter;
+			VkFilter				minFilter;
+			VkSamplerMipmapMode		mipmapMode;
+			VkSamplerAddressMode	addressModeU;
+			VkSamplerAddressMode	addressModeV;
+			VkSamplerAddressMode	addressModeW;
+			float					mipLodBias;
+			VkBool32				anisotropyEnable;
+			float					maxAnisotropy;
+			VkBool32				compareEnable;
+			VkCompareOp				compareOp;
+			float					minLod;
+			float					maxLod;
+			VkBorderColor			borderColor;
+			VkBool32				unnormalizedCoordinates;
+
+			// Floats are compared bitwise, like the vertex deduplication does
+			bool operator==(const Key& otherKey) const;
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const;
+		};
+
+		static Key MakeKey(const VkSamplerCreateInfo& createInfo);
+	private:
+		Device*										m_Device;
+		std::unordered_map<Key, VkSampler, KeyHash>	m_Samplers;
+		mutable std::mutex							m_Mutex;
+	};
+}
@@ -12,7 +12,7 @@ namespace VE
         :   m_Swapchain(VK_NULL_HANDLE), m_Device(device), m_Window(window),
             m_ImageFormat{}, m_ImageExtent{}, m_RenderPass(VK_NULL_HANDLE),
             m_DepthImage(VK_NULL_HANDLE), m_DepthImageView(VK_NULL_HANDLE),
-            m_DepthImageMemory(VK_NULL_HANDLE), 
+            m_DepthImageAllocation{},
             m_CurrentFrame(0)
     {
         CreateSwapchain();
@@ -208,17 +208,7 @@ namespace VE
 
         VK_CHECK(vkCreateImage(m_Device->GetVkDevice(), &imageInfo, nullptr, &m_DepthImage))
 
-        VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(m_Device->GetVkDevice(), m_DepthImage, &memRequirements);
-
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = Device::FindMemoryType(m_Device, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-        VK_CHECK(vkAllocateMemory(m_Device->GetVkDevice(), &allocInfo, nullptr, &m_DepthImageMemory))
-
-        vkBindImageMemory(m_Device->GetVkDevice(), m_DepthImage, m_DepthImageMemory, 0);
+        m_DepthImageAllocation = m_Device->GetAllocator().AllocateImage(m_DepthImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
     }
 
     void Swapchain::CreateDepthImageView()
@@ -359,10 +349,7 @@ namespace VE
         {
             vkDestroyImage(m_Device->GetVkDevice(), m_DepthImage, nullptr);
         }
-        if (m_DepthImageMemory)
-        {
-            vkFreeMemory(m_Device->GetVkDevice(), m_DepthImageMemory, nullptr);
-        }
+        m_Device->GetAllocator().Free(m_DepthImageAllocation);
         if (m_Swapchain != VK_NULL_HANDLE)
         {
             vkDestroySwapchainKHR(m_Device->GetVkDevice(), m_Swapchain, nullptr);
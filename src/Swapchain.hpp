@@ -64,7 +64,7 @@ namespace VE
         std::vector<VkFence>        m_InFlightFences;
         VkImage                     m_DepthImage;
         VkImageView                 m_DepthImageView;
-        VkDeviceMemory              m_DepthImageMemory;
+        Allocation                  m_DepthImageAllocation;
         uint32_t                    m_CurrentFrame;
     };
 }
@@ -3,25 +3,45 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
 
+#include "UploadContext.hpp"
+#include "SamplerCache.hpp"
+#include "Descriptor/BindlessTextureArray.hpp"
+
+#include "Image/Ktx2Loader.hpp"
+#include "Image/BlockDecoder.hpp"
+
 #include "Utilities.hpp"
 
 #include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define VE_TEXTURE_SSE2
+	#include <emmintrin.h>
+#endif
 
 namespace VE
 {
 	Texture::Texture(Device* device)
-		:	m_Device(device), m_StagingBuffer(nullptr), m_Path(), 
-			m_TexWidth(0), m_TexHeight(0), m_TexChannels(0),
+		:	m_Device(device), m_Path(),
+			m_TexWidth(0), m_TexHeight(0), m_TexChannels(0), m_MipLevels(1), m_Format(VK_FORMAT_R8G8B8A8_UNORM),
 			m_Image(VK_NULL_HANDLE), m_ImageView(VK_NULL_HANDLE),
-			m_Sampler(VK_NULL_HANDLE), m_ImageMemory(VK_NULL_HANDLE)
+			m_Sampler(VK_NULL_HANDLE), m_ImageAllocation{}, m_UploadToken(0), m_IsUploaded(false),
+			m_BindlessIndex(BindlessTextureArray::INVALID_INDEX)
 	{
 	}
 
 	Texture::~Texture()
 	{
-		if (m_Sampler)
+		// The image must outlive the copy writing to it
+		m_Device->GetUploadContext().Wait(m_UploadToken);
+
+		if (m_BindlessIndex != BindlessTextureArray::INVALID_INDEX)
 		{
-			vkDestroySampler(m_Device->GetVkDevice(), m_Sampler, nullptr);
+			m_Device->GetBindlessTextures().Unregister(m_BindlessIndex);
 		}
 		if (m_ImageView)
 		{
@@ -31,44 +51,263 @@ namespace VE
 		{
 			vkDestroyImage(m_Device->GetVkDevice(), m_Image, nullptr);
 		}
-		if (m_ImageMemory)
+		m_Device->GetAllocator().Free(m_ImageAllocation);
+	}
+
+	VkDeviceSize TextureData::GetLevelSize(uint32_t level) const
+	{
+		return BlockDecoder::GetLevelSize(format, std::max(width >> level, 1u), std::max(height >> level, 1u));
+	}
+
+	VkDeviceSize TextureData::GetUploadSize() const
+	{
+		VkDeviceSize uploadSize = 0;
+		for (uint32_t i = 0; i < mipLevels; i++)
 		{
-			vkFreeMemory(m_Device->GetVkDevice(), m_ImageMemory, nullptr);
+			uploadSize += GetLevelSize(i);
 		}
+		return uploadSize;
 	}
 
-	void Texture::Create(std::string_view filePath)
+	// Averages 2x2 blocks of RGBA8 texels, odd edges repeat their last row or column
+	static void DownsampleBox(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight, uint8_t* dst, uint32_t dstWidth, uint32_t dstHeight)
 	{
-		m_Path = filePath.data();
+		for (uint32_t y = 0; y < dstHeight; y++)
+		{
+			const uint8_t* row0 = src + static_cast<size_t>(2 * y) * srcWidth * 4;
+			const uint8_t* row1 = src + static_cast<size_t>(std::min(2 * y + 1, srcHeight - 1)) * srcWidth * 4;
+			uint8_t* out = dst + static_cast<size_t>(y) * dstWidth * 4;
+
+			uint32_t x = 0;
+#ifdef VE_TEXTURE_SSE2
+			// Two output texels per iteration, widened to 16 bit so the rounding matches the scalar path
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i bias = _mm_set1_epi16(2);
+			for (; 2 * x + 4 <= srcWidth && x + 2 <= dstWidth; x += 2)
+			{
+				__m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+				__m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
 
-		LoadImage();
-		CreateImageView();
-		CreateSampler();
+				__m128i left = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+				__m128i right = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+				__m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(left, right), _mm_unpackhi_epi64(left, right));
+
+				sum = _mm_srli_epi16(_mm_add_epi16(sum, bias), 2);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(sum, sum));
+			}
+#endif
+			for (; x < dstWidth; x++)
+			{
+				uint32_t x0 = 2 * x * 4;
+				uint32_t x1 = std::min(2 * x + 1, srcWidth - 1) * 4;
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					out[x * 4 + c] = static_cast<uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+				}
+			}
+		}
+	}
+
+	uint32_t Texture::MipLevelCount(uint32_t width, uint32_t height)
+	{
+		return static_cast<uint32_t>(std::bit_width(std::max({ width, height, 1u })));
+	}
+
+	bool Texture::SupportsFormat(Device* device, VkFormat format)
+	{
+		if (BlockDecoder::IsBlockCompressed(format) && !device->GetEnabledFeatures().textureCompressionBC)
+		{
+			return false;
+		}
+		return device->SupportsFormatFeatures(format, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+	}
+
+	void Texture::DecompressBlocks(TextureData& data)
+	{
+		if (!BlockDecoder::IsBlockCompressed(data.format))
+		{
+			return;
+		}
+
+		TextureData decoded;
+		decoded.path = data.path;
+		decoded.width = data.width;
+		decoded.height = data.height;
+		decoded.channels = data.channels;
+		decoded.mipLevels = data.mipLevels;
+
+		VkDeviceSize chainSize = 0;
+		for (uint32_t i = 1; i < decoded.mipLevels; i++)
+		{
+			chainSize += decoded.GetLevelSize(i);
+		}
+
+		decoded.pixels = { static_cast<uint8_t*>(std::malloc(static_cast<size_t>(decoded.GetDataSize()))), std::free };
+		decoded.mipChain.resize(static_cast<size_t>(chainSize));
+		if (!decoded.pixels)
+		{
+			throw std::runtime_error("Error: Out of memory decompressing " + data.path);
+		}
+
+		const uint8_t* src = data.pixels.get();
+		uint8_t* dst = decoded.pixels.get();
+		const uint8_t* srcChain = data.mipChain.data();
+		uint8_t* dstChain = decoded.mipChain.data();
+
+		for (uint32_t i = 0; i < decoded.mipLevels; i++)
+		{
+			if (i > 0)
+			{
+				src = srcChain;
+				dst = dstChain;
+				srcChain += data.GetLevelSize(i);
+				dstChain += decoded.GetLevelSize(i);
+			}
+			BlockDecoder::DecodeLevel(data.format, src, std::max(data.width >> i, 1u), std::max(data.height >> i, 1u), dst);
+		}
+
+		data = std::move(decoded);
+	}
+
+	bool Texture::CanBlitMipmaps(Device* device)
+	{
+		return device->SupportsLinearBlit(VK_FORMAT_R8G8B8A8_UNORM);
+	}
+
+	void Texture::GenerateMipChain(TextureData& data)
+	{
+		// Block compressed textures bring their own chain or stay single level
+		if (data.format != VK_FORMAT_R8G8B8A8_UNORM || data.mipLevels > 1)
+		{
+			return;
+		}
+
+		uint32_t mipLevels = MipLevelCount(data.width, data.height);
+
+		VkDeviceSize chainSize = 0;
+		for (uint32_t i = 1; i < mipLevels; i++)
+		{
+			chainSize += static_cast<VkDeviceSize>(std::max(data.width >> i, 1u)) * std::max(data.height >> i, 1u) * 4;
+		}
+		data.mipChain.resize(static_cast<size_t>(chainSize));
+
+		const uint8_t* src = data.pixels.get();
+		uint8_t* dst = data.mipChain.data();
+		uint32_t width = data.width;
+		uint32_t height = data.height;
+
+		for (uint32_t i = 1; i < mipLevels; i++)
+		{
+			uint32_t mipWidth = std::max(width / 2, 1u);
+			uint32_t mipHeight = std::max(height / 2, 1u);
+			DownsampleBox(src, width, height, dst, mipWidth, mipHeight);
+
+			src = dst;
+			dst += static_cast<size_t>(mipWidth) * mipHeight * 4;
+			width = mipWidth;
+			height = mipHeight;
+		}
+
+		data.mipLevels = mipLevels;
 	}
 
-	void Texture::LoadImage()
+	// Mip 0 followed by the rest of the chain, the layout CopyLevelsToImage expects
+	static void CopyLevels(const TextureData& data, void* dst)
 	{
-		stbi_uc* pixels = stbi_load(m_Path.c_str(), &m_TexWidth, &m_TexHeight, &m_TexChannels, STBI_rgb_alpha);
+		memcpy(dst, data.pixels.get(), static_cast<size_t>(data.GetDataSize()));
+		memcpy(static_cast<uint8_t*>(dst) + data.GetDataSize(), data.mipChain.data(), data.mipChain.size());
+	}
+
+	void Texture::Stage(UploadContext& uploadContext, TextureData& data)
+	{
+		data.staging = uploadContext.ReserveStaging(data.GetUploadSize());
+		CopyLevels(data, data.staging.data);
+
+		// The staged copy is all Create needs, free the decoded one right away
+		data.pixels.reset();
+		data.mipChain = {};
+	}
+
+	TextureData Texture::Decode(std::string_view filePath)
+	{
+		if (Ktx2Loader::CanLoad(filePath))
+		{
+			return Ktx2Loader::Load(filePath);
+		}
+
+		TextureData data;
+		data.path = filePath;
+
+		int width, height;
+		stbi_uc* pixels = stbi_load(data.path.c_str(), &width, &height, &data.channels, STBI_rgb_alpha);
+
+		if (!pixels)
+		{
+			throw std::runtime_error("Error: Failed to load image from " + data.path);
+		}
+
+		data.width = static_cast<uint32_t>(width);
+		data.height = static_cast<uint32_t>(height);
+		data.pixels = { pixels, stbi_image_free };
 
-		VkDeviceSize imageSize = m_TexWidth * m_TexHeight * 4;
+		return data;
+	}
+
+	TextureData Texture::Decode(std::string_view name, std::span<const uint8_t> encoded)
+	{
+		TextureData data;
+		data.path = name;
+
+		int width, height;
+		stbi_uc* pixels = stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &data.channels, STBI_rgb_alpha);
 
 		if (!pixels)
 		{
-			throw std::runtime_error("Error: Failed to load image from " + m_Path);
+			throw std::runtime_error("Error: Failed to decode image " + data.path);
 		}
 
-		m_StagingBuffer = std::make_unique<StagingBuffer>(m_Device, imageSize);
-		m_StagingBuffer->UploadData(pixels, imageSize);
+		data.width = static_cast<uint32_t>(width);
+		data.height = static_cast<uint32_t>(height);
+		data.pixels = { pixels, stbi_image_free };
+
+		return data;
+	}
+
+	void Texture::Create(const TextureData& data)
+	{
+		m_Path = data.path;
+		m_TexWidth = static_cast<int>(data.width);
+		m_TexHeight = static_cast<int>(data.height);
+		m_TexChannels = data.channels;
+
+		m_Format = data.format;
+
+		bool useBlit = data.format == VK_FORMAT_R8G8B8A8_UNORM && data.mipLevels == 1 && CanBlitMipmaps(m_Device);
+		m_MipLevels = useBlit ? MipLevelCount(data.width, data.height) : data.mipLevels;
 
-		stbi_image_free(pixels);
+		CreateImage(useBlit ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+		CopyBufferToImage(data);
+		CreateImageView();
+		CreateSampler();
 
-		CreateImage();
-		TransitionLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-		CopyBufferToImage();
-		TransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		if (m_Device->HasBindlessTextures())
+		{
+			m_BindlessIndex = m_Device->GetBindlessTextures().Register(m_ImageView, m_Sampler);
+		}
 	}
 
-	void Texture::CreateImage()
+	void Texture::SetUploadToken(UploadToken token)
+	{
+		m_UploadToken = token;
+		m_IsUploaded = true;
+	}
+
+	bool Texture::IsReady() const
+	{
+		return m_IsUploaded && m_Device->GetUploadContext().IsComplete(m_UploadToken);
+	}
+
+	void Texture::CreateImage(VkImageUsageFlags extraUsage)
 	{
 		VkImageCreateInfo imageInfo{};
 		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -76,116 +315,73 @@ namespace VE
 		imageInfo.extent.width = static_cast<uint32_t>(m_TexWidth);
 		imageInfo.extent.height = static_cast<uint32_t>(m_TexHeight);
 		imageInfo.extent.depth = 1;
-		imageInfo.mipLevels = 1;
+		imageInfo.mipLevels = m_MipLevels;
 		imageInfo.arrayLayers = 1;
-		imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+		imageInfo.format = m_Format;
 		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
 		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | extraUsage;
 		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 		imageInfo.flags = 0; // Optional
 
 		VK_CHECK(vkCreateImage(m_Device->GetVkDevice(), &imageInfo, nullptr, &m_Image))
 
-		VkMemoryRequirements memRequirements;
-		vkGetImageMemoryRequirements(m_Device->GetVkDevice(), m_Image, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-		if (vkAllocateMemory(m_Device->GetVkDevice(), &allocInfo, nullptr, &m_ImageMemory) != VK_SUCCESS) {
-			throw std::runtime_error("failed to allocate image memory!");
-		}
-
-		vkBindImageMemory(m_Device->GetVkDevice(), m_Image, m_ImageMemory, 0);
+		m_ImageAllocation = m_Device->GetAllocator().AllocateImage(m_Image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 	}
 
-	void Texture::TransitionLayout(VkImageLayout oldLayout, VkImageLayout newLayout)
+	void Texture::CopyBufferToImage(const TextureData& data)
 	{
-		VkCommandBuffer commandBuffer = m_Device->BeginSingleTimeCommands();
+		VkExtent2D extent = { data.width, data.height };
+		UploadContext& uploadContext = m_Device->GetUploadContext();
 
-		VkImageMemoryBarrier barrier{};
-		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-		barrier.oldLayout = oldLayout;
-		barrier.newLayout = newLayout;
-		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.image = m_Image;
-		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		barrier.subresourceRange.baseMipLevel = 0;
-		barrier.subresourceRange.levelCount = 1;
-		barrier.subresourceRange.baseArrayLayer = 0;
-		barrier.subresourceRange.layerCount = 1;
-
-		VkPipelineStageFlags sourceStage;
-		VkPipelineStageFlags destinationStage;
-
-		if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+		// Texels staged by the decode worker are copied in place, anything else is staged here
+		StagingAllocation staging = data.staging;
+		if (!staging.buffer)
 		{
-			barrier.srcAccessMask = 0;
-			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-			sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-			destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			staging = uploadContext.AllocateStaging(data.GetUploadSize());
+			CopyLevels(data, staging.data);
 		}
-		else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-		{
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-			sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-			destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		// Layout transitions are recorded by the upload context around the copy
+		if (data.mipLevels == 1 && m_MipLevels > 1)
+		{
+			uploadContext.CopyBufferToImageWithMipmaps(staging.buffer, staging.offset, m_Image, extent, m_MipLevels);
 		}
-		else {
-			throw std::invalid_argument("Error: This layout transition is unsupported!");
+		else
+		{
+			CopyLevelsToImage(staging, extent);
 		}
 
-		vkCmdPipelineBarrier(
-			commandBuffer,
-			sourceStage, destinationStage,
-			0,
-			0, nullptr,
-			0, nullptr,
-			1, &barrier
-		);
-
-		m_Device->EndSingleTimeCommands(commandBuffer);
+		if (data.staging.buffer)
+		{
+			uploadContext.ReleaseStaging(data.staging);
+		}
 	}
 
-	void Texture::CopyBufferToImage()
+	void Texture::CopyLevelsToImage(const StagingAllocation& staging, VkExtent2D extent)
 	{
-		VkCommandBuffer commandBuffer = m_Device->BeginSingleTimeCommands();
-
-		VkBufferImageCopy region{};
-		region.bufferOffset = 0;
-		region.bufferRowLength = 0;
-		region.bufferImageHeight = 0;
+		std::vector<VkBufferImageCopy> regions(m_MipLevels);
+		VkDeviceSize offset = staging.offset;
+		for (uint32_t i = 0; i < m_MipLevels; i++)
+		{
+			VkBufferImageCopy& region = regions[i];
+			region.bufferOffset = offset;
+			region.bufferRowLength = 0;
+			region.bufferImageHeight = 0;
 
-		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		region.imageSubresource.mipLevel = 0;
-		region.imageSubresource.baseArrayLayer = 0;
-		region.imageSubresource.layerCount = 1;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = i;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
 
-		region.imageOffset = { 0, 0, 0 };
-		region.imageExtent = {
-			static_cast<uint32_t>(m_TexWidth),
-			static_cast<uint32_t>(m_TexHeight),
-			1
-		};
+			region.imageOffset = { 0, 0, 0 };
+			region.imageExtent = { std::max(extent.width >> i, 1u), std::max(extent.height >> i, 1u), 1 };
 
-		vkCmdCopyBufferToImage(
-			commandBuffer,
-			m_StagingBuffer->GetVkBuffer(),
-			m_Image,
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			1,
-			&region
-		);
+			offset += BlockDecoder::GetLevelSize(m_Format, region.imageExtent.width, region.imageExtent.height);
+		}
 
-		m_Device->EndSingleTimeCommands(commandBuffer);
+		m_Device->GetUploadContext().CopyBufferToImage(staging.buffer, m_Image, m_MipLevels, regions);
 	}
 
 	void Texture::CreateImageView()
@@ -194,10 +390,10 @@ namespace VE
 		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 		viewInfo.image = m_Image;
 		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-		viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+		viewInfo.format = m_Format;
 		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		viewInfo.subresourceRange.baseMipLevel = 0;
-		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.levelCount = m_MipLevels;
 		viewInfo.subresourceRange.baseArrayLayer = 0;
 		viewInfo.subresourceRange.layerCount = 1;
 
@@ -214,11 +410,7 @@ namespace VE
 		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
 		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
 		samplerInfo.anisotropyEnable = VK_TRUE;
-
-		VkPhysicalDeviceProperties properties{};
-		vkGetPhysicalDeviceProperties(m_Device->GetPhysicalDevice(), &properties);
-
-		samplerInfo.maxAnisotropy = properties.limits.maxSamplerAnisotropy;
+		samplerInfo.maxAnisotropy = m_Device->GetProperties().limits.maxSamplerAnisotropy;
 		samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
 		samplerInfo.unnormalizedCoordinates = VK_FALSE;
 		samplerInfo.compareEnable = VK_FALSE;
@@ -226,25 +418,9 @@ namespace VE
 		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 		samplerInfo.mipLodBias = 0.0f;
 		samplerInfo.minLod = 0.0f;
-		samplerInfo.maxLod = 0.0f;
-
-		VK_CHECK(vkCreateSampler(m_Device->GetVkDevice(), &samplerInfo, nullptr, &m_Sampler))
-	}
-
-	uint32_t Texture::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
-	{
-		VkPhysicalDeviceMemoryProperties memProperties;
-		vkGetPhysicalDeviceMemoryProperties(m_Device->GetPhysicalDevice(), &memProperties);
-
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
-		{
-			// typeFilter bitwise and checks if this memory type can be used
-			if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-			{
-				return i;
-			}
-		}
+		// The view already limits the mip range, leaving maxLod open lets every texture share one sampler
+		samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
-		throw std::runtime_error("Error: Failed to find suitable memory type!");
+		m_Sampler = m_Device->GetSamplerCache().Get(samplerInfo);
 	}
 }
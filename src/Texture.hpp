@@ -3,13 +3,33 @@
 #include <vulkan/vulkan.h>
 
 #include "Device.hpp"
-#include "Buffer/StagingBuffer.hpp"
+#include "UploadContext.hpp"
 
 #include <string>
+#include <vector>
 #include <memory>
+#include <span>
 
 namespace VE
 {
+	// Decoded RGBA8 pixels or BC blocks, produced without touching the device so it can run on any thread
+	struct TextureData
+	{
+		std::string									path;
+		uint32_t									width = 0;
+		uint32_t									height = 0;
+		int											channels = 0; // Channel count of the source image
+		VkFormat									format = VK_FORMAT_R8G8B8A8_UNORM;
+		std::unique_ptr<uint8_t, void(*)(void*)>	pixels{ nullptr, nullptr }; // Mip 0
+		uint32_t									mipLevels = 1; // Levels held here, 1 until GenerateMipChain runs
+		std::vector<uint8_t>						mipChain; // Levels 1 and up, tightly packed
+		StagingAllocation							staging{}; // Set by Texture::Stage, which frees pixels and mipChain
+
+		VkDeviceSize GetLevelSize(uint32_t level) const;
+		inline VkDeviceSize GetDataSize() const { return GetLevelSize(0); }
+		VkDeviceSize GetUploadSize() const;
+	};
+
 	class Texture
 	{
 	public:
@@ -21,27 +41,54 @@ namespace VE
 	public:
 		inline VkImageView GetImageView() const { return m_ImageView; }
 		inline VkSampler GetSampler() const { return m_Sampler; }
+		inline VkDeviceSize GetMemorySize() const { return m_ImageAllocation.size; }
+		inline const std::string& GetPath() const { return m_Path; }
+		inline uint32_t GetMipLevels() const { return m_MipLevels; }
+		inline VkFormat GetFormat() const { return m_Format; }
+		// Slot in the device's bindless texture array, BindlessTextureArray::INVALID_INDEX without one
+		inline uint32_t GetBindlessIndex() const { return m_BindlessIndex; }
 	public:
-		void Create(std::string_view filePath);
+		static uint32_t MipLevelCount(uint32_t width, uint32_t height);
+		// BC formats also need the textureCompressionBC feature, which is only enabled where supported
+		static bool SupportsFormat(Device* device, VkFormat format);
+		// Expands every BC level to RGBA8 for devices that can't sample the blocks
+		static void DecompressBlocks(TextureData& data);
+		// The GPU path is preferred, devices without linear blits get their chain built on the CPU
+		static bool CanBlitMipmaps(Device* device);
+		// 2x2 box filter down to 1x1, meant to run on the decode thread
+		static void GenerateMipChain(TextureData& data);
+		// .ktx2 files keep their BC blocks, everything else is decoded to RGBA8 by stb_image
+		static TextureData Decode(std::string_view filePath);
+		// Decodes an encoded image held in memory, e.g. one embedded in a glTF file, name is only used for messages
+		static TextureData Decode(std::string_view name, std::span<const uint8_t> encoded);
+		// Copies every level into reserved staging so the main thread only records the copy, safe on any thread
+		static void Stage(UploadContext& uploadContext, TextureData& data);
+		// Records the copy into the upload context, the caller submits it and hands back the token
+		void Create(const TextureData& data);
+		void SetUploadToken(UploadToken token);
+		// True once the image has been created and its copy has completed
+		bool IsReady() const;
 	private:
-		void LoadImage();
-		void CreateImage();
-		void TransitionLayout(VkImageLayout oldLayout, VkImageLayout newLayout);
-		void CopyBufferToImage();
+		void CreateImage(VkImageUsageFlags extraUsage);
+		void CopyBufferToImage(const TextureData& data);
+		void CopyLevelsToImage(const StagingAllocation& staging, VkExtent2D extent);
 		void CreateImageView();
 		void CreateSampler();
-		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
 	private:
 		Device*							m_Device;
-		std::unique_ptr<StagingBuffer>	m_StagingBuffer;
 		std::string						m_Path;
 		int								m_TexWidth;
 		int								m_TexHeight;
 		int								m_TexChannels;
+		uint32_t						m_MipLevels;
+		VkFormat						m_Format;
 		VkImage							m_Image;
 		VkImageView						m_ImageView;
-		VkSampler						m_Sampler;
-		VkDeviceMemory					m_ImageMemory;
+		VkSampler						m_Sampler; // Shared, owned by the device's SamplerCache
+		Allocation						m_ImageAllocation;
+		UploadToken						m_UploadToken;
+		bool							m_IsUploaded;
+		uint32_t						m_BindlessIndex;
 	};
 }
 
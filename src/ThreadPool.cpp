@@ -0,0 +1,67 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace VE
+{
+	ThreadPool::ThreadPool(uint32_t threadCount)
+		:	m_IsStopping(false)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+		}
+
+		m_Workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_IsStopping = true;
+			m_Jobs.clear();
+		}
+		m_Condition.notify_all();
+
+		for (auto& worker : m_Workers)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::Submit(std::function<void()> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Jobs.push_back(std::move(job));
+		}
+		m_Condition.notify_one();
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Condition.wait(lock, [this] { return m_IsStopping || !m_Jobs.empty(); });
+
+				if (m_IsStopping)
+				{
+					return;
+				}
+
+				job = std::move(m_Jobs.front());
+				m_Jobs.pop_front();
+			}
+
+			job();
+		}
+	}
+}
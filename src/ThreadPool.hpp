@@ -0,0 +1,34 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+namespace VE
+{
+	// Fixed set of worker threads draining a FIFO job queue. Jobs still queued on destruction are dropped,
+	// jobs already running are finished before the workers are joined.
+	class ThreadPool
+	{
+	public:
+		explicit ThreadPool(uint32_t threadCount = 0); // 0 = one per hardware thread besides the main thread
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool& otherPool) = delete;
+		ThreadPool& operator=(const ThreadPool& otherPool) = delete;
+	public:
+		void Submit(std::function<void()> job);
+		inline uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+	private:
+		void WorkerLoop();
+	private:
+		std::vector<std::thread>			m_Workers;
+		std::deque<std::function<void()>>	m_Jobs;
+		std::mutex							m_Mutex;
+		std::condition_variable				m_Condition;
+		bool								m_IsStopping;
+	};
+}
@@ -0,0 +1,637 @@
+#include "UploadContext.hpp"
+
+#include "Utilities.hpp"
+
+#include <limits>
+#include <cstring>
+#include <algorithm>
+
+namespace VE
+{
+	UploadContext::UploadContext(Device* device)
+		:	m_Device(device), m_UseTransferQueue(device->HasTransferQueue()), m_TransferFamily(0), m_GraphicsFamily(0),
+			m_TransferQueue(VK_NULL_HANDLE), m_GraphicsQueue(device->GetGraphicsQueue()),
+			m_TransferCommandPool(VK_NULL_HANDLE), m_GraphicsCommandPool(VK_NULL_HANDLE),
+			m_Recording{}, m_IsRecording(false), m_LastSubmitted(0), m_LastCompleted(0),
+			m_CurrentPage(SIZE_MAX)
+	{
+		QueueFamilyIndices indices = device->GetQueueFamilyIndices();
+		m_GraphicsFamily = indices.graphicsFamily.value();
+		m_GraphicsCommandPool = CreateCommandPool(m_GraphicsFamily);
+
+		if (m_UseTransferQueue)
+		{
+			m_TransferFamily = indices.transferFamily.value();
+			m_TransferQueue = device->GetTransferQueue();
+			m_TransferCommandPool = CreateCommandPool(m_TransferFamily);
+		}
+		else
+		{
+			m_TransferFamily = m_GraphicsFamily;
+			m_TransferQueue = m_GraphicsQueue;
+		}
+	}
+
+	UploadContext::~UploadContext()
+	{
+		Wait(m_LastSubmitted);
+
+		for (const auto& batch : m_FreeBatches)
+		{
+			DestroyBatch(batch);
+		}
+		if (m_IsRecording)
+		{
+			DestroyBatch(m_Recording);
+		}
+		if (m_TransferCommandPool)
+		{
+			vkDestroyCommandPool(m_Device->GetVkDevice(), m_TransferCommandPool, nullptr);
+		}
+		if (m_GraphicsCommandPool)
+		{
+			vkDestroyCommandPool(m_Device->GetVkDevice(), m_GraphicsCommandPool, nullptr);
+		}
+	}
+
+	VkCommandPool UploadContext::CreateCommandPool(uint32_t queueFamilyIndex) const
+	{
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		poolInfo.queueFamilyIndex = queueFamilyIndex;
+
+		VkCommandPool commandPool;
+		VK_CHECK(vkCreateCommandPool(m_Device->GetVkDevice(), &poolInfo, nullptr, &commandPool))
+
+		return commandPool;
+	}
+
+	VkCommandBuffer UploadContext::AllocateCommandBuffer(VkCommandPool commandPool) const
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = commandPool;
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer;
+		VK_CHECK(vkAllocateCommandBuffers(m_Device->GetVkDevice(), &allocInfo, &commandBuffer))
+
+		return commandBuffer;
+	}
+
+	void UploadContext::UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize dataSize)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		StagingAllocation staging = AllocateStagingLocked(dataSize);
+		memcpy(staging.data, data, static_cast<size_t>(dataSize));
+
+		VkBufferCopy region{};
+		region.srcOffset = staging.offset;
+		region.dstOffset = dstOffset;
+		region.size = dataSize;
+
+		RecordCopyBuffer(staging.buffer, dstBuffer, region);
+	}
+
+	void UploadContext::UploadImage(VkImage image, uint32_t mipLevels, std::span<const VkBufferImageCopy> regions, const void* data, VkDeviceSize dataSize)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		StagingAllocation staging = AllocateStagingLocked(dataSize);
+		memcpy(staging.data, data, static_cast<size_t>(dataSize));
+
+		// Region offsets are relative to data, rebase them onto the staging page
+		std::vector<VkBufferImageCopy> stagingRegions(regions.begin(), regions.end());
+		for (auto& region : stagingRegions)
+		{
+			region.bufferOffset += staging.offset;
+		}
+
+		RecordCopyBufferToImage(staging.buffer, image, mipLevels, stagingRegions);
+	}
+
+	StagingAllocation UploadContext::AllocateStaging(VkDeviceSize dataSize)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		return AllocateStagingLocked(dataSize);
+	}
+
+	StagingAllocation UploadContext::ReserveStaging(VkDeviceSize dataSize)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		StagingAllocation allocation = AllocateStagingLocked(dataSize);
+		FindStagingPage(allocation.buffer)->reservations++;
+		return allocation;
+	}
+
+	void UploadContext::ReleaseStaging(const StagingAllocation& allocation)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		StagingPage* page = FindStagingPage(allocation.buffer);
+		if (page && page->reservations > 0)
+		{
+			page->reservations--;
+		}
+	}
+
+	void UploadContext::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, const VkBufferCopy& region)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		RecordCopyBuffer(srcBuffer, dstBuffer, region);
+	}
+
+	void UploadContext::CopyBufferToImage(VkBuffer srcBuffer, VkImage image, uint32_t mipLevels, std::span<const VkBufferImageCopy> regions)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		RecordCopyBufferToImage(srcBuffer, image, mipLevels, regions);
+	}
+
+	void UploadContext::CopyBufferToImageWithMipmaps(VkBuffer srcBuffer, VkDeviceSize srcOffset, VkImage image, VkExtent2D extent, uint32_t mipLevels)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		RecordCopyAndBlitMipmaps(srcBuffer, srcOffset, image, extent, mipLevels);
+	}
+
+	void UploadContext::RecordCopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, const VkBufferCopy& region)
+	{
+		Batch& batch = GetBatch();
+		MarkStagingUse(srcBuffer);
+
+		vkCmdCopyBuffer(batch.transferCommandBuffer, srcBuffer, dstBuffer, 1, &region);
+
+		if (m_UseTransferQueue)
+		{
+			// Release on the transfer queue, acquire on the graphics queue. Both halves must match.
+			VkBufferMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			barrier.srcQueueFamilyIndex = m_TransferFamily;
+			barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+			barrier.buffer = dstBuffer;
+			barrier.offset = region.dstOffset;
+			barrier.size = region.size;
+
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = 0;
+			vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+			vkCmdPipelineBarrier(batch.graphicsCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+				0, 0, nullptr, 1, &barrier, 0, nullptr);
+		}
+	}
+
+	void UploadContext::RecordCopyBufferToImage(VkBuffer srcBuffer, VkImage image, uint32_t mipLevels, std::span<const VkBufferImageCopy> regions)
+	{
+		Batch& batch = GetBatch();
+		MarkStagingUse(srcBuffer);
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = mipLevels;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		vkCmdCopyBufferToImage(batch.transferCommandBuffer, srcBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		if (m_UseTransferQueue)
+		{
+			// The layout transition happens once, as part of the release/acquire pair
+			barrier.srcQueueFamilyIndex = m_TransferFamily;
+			barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+			barrier.dstAccessMask = 0;
+			vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			vkCmdPipelineBarrier(batch.graphicsCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+		else
+		{
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+	}
+
+	void UploadContext::RecordCopyAndBlitMipmaps(VkBuffer srcBuffer, VkDeviceSize srcOffset, VkImage image, VkExtent2D extent, uint32_t mipLevels)
+	{
+		Batch& batch = GetBatch();
+		MarkStagingUse(srcBuffer);
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = srcOffset;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { extent.width, extent.height, 1 };
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = m_UseTransferQueue ? 1 : mipLevels;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		vkCmdCopyBufferToImage(batch.transferCommandBuffer, srcBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		if (!m_UseTransferQueue)
+		{
+			RecordBlitMipmaps(batch.transferCommandBuffer, image, extent, mipLevels);
+			return;
+		}
+
+		// Only mip 0 holds data, it changes owner in the layout it was copied in. The other levels are
+		// discarded anyway, so the graphics queue takes them straight from undefined
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = m_TransferFamily;
+		barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+		vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		VkImageMemoryBarrier acquireBarriers[2] = { barrier, barrier };
+		acquireBarriers[0].srcAccessMask = 0;
+		acquireBarriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		acquireBarriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		acquireBarriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		acquireBarriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		acquireBarriers[1].subresourceRange.baseMipLevel = 1;
+		acquireBarriers[1].subresourceRange.levelCount = mipLevels - 1;
+		acquireBarriers[1].srcAccessMask = 0;
+		acquireBarriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		uint32_t acquireCount = mipLevels > 1 ? 2 : 1;
+		vkCmdPipelineBarrier(batch.graphicsCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, acquireCount, acquireBarriers);
+
+		RecordBlitMipmaps(batch.graphicsCommandBuffer, image, extent, mipLevels);
+	}
+
+	void UploadContext::RecordBlitMipmaps(VkCommandBuffer commandBuffer, VkImage image, VkExtent2D extent, uint32_t mipLevels) const
+	{
+		// Expects every level in transfer dst layout with mip 0 written, leaves them all shader readable
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		int32_t width = static_cast<int32_t>(extent.width);
+		int32_t height = static_cast<int32_t>(extent.height);
+
+		for (uint32_t i = 1; i < mipLevels; i++)
+		{
+			barrier.subresourceRange.baseMipLevel = i - 1;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			int32_t mipWidth = std::max(width / 2, 1);
+			int32_t mipHeight = std::max(height / 2, 1);
+
+			VkImageBlit blit{};
+			blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			blit.srcSubresource.mipLevel = i - 1;
+			blit.srcSubresource.baseArrayLayer = 0;
+			blit.srcSubresource.layerCount = 1;
+			blit.srcOffsets[0] = { 0, 0, 0 };
+			blit.srcOffsets[1] = { width, height, 1 };
+			blit.dstSubresource = blit.srcSubresource;
+			blit.dstSubresource.mipLevel = i;
+			blit.dstOffsets[0] = { 0, 0, 0 };
+			blit.dstOffsets[1] = { mipWidth, mipHeight, 1 };
+
+			vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			width = mipWidth;
+			height = mipHeight;
+		}
+
+		barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
+	UploadToken UploadContext::Submit()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (!m_IsRecording)
+		{
+			return m_LastSubmitted;
+		}
+
+		if (m_UseTransferQueue)
+		{
+			VK_CHECK(vkEndCommandBuffer(m_Recording.transferCommandBuffer))
+			VK_CHECK(vkEndCommandBuffer(m_Recording.graphicsCommandBuffer))
+
+			VkSubmitInfo transferSubmit{};
+			transferSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			transferSubmit.commandBufferCount = 1;
+			transferSubmit.pCommandBuffers = &m_Recording.transferCommandBuffer;
+			transferSubmit.signalSemaphoreCount = 1;
+			transferSubmit.pSignalSemaphores = &m_Recording.transferComplete;
+
+			VK_CHECK(vkQueueSubmit(m_TransferQueue, 1, &transferSubmit, VK_NULL_HANDLE))
+
+			// Tiny submission on the graphics queue that only holds the ownership acquires
+			VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+			VkSubmitInfo graphicsSubmit{};
+			graphicsSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			graphicsSubmit.waitSemaphoreCount = 1;
+			graphicsSubmit.pWaitSemaphores = &m_Recording.transferComplete;
+			graphicsSubmit.pWaitDstStageMask = &waitStage;
+			graphicsSubmit.commandBufferCount = 1;
+			graphicsSubmit.pCommandBuffers = &m_Recording.graphicsCommandBuffer;
+
+			VK_CHECK(vkQueueSubmit(m_GraphicsQueue, 1, &graphicsSubmit, m_Recording.fence))
+		}
+		else
+		{
+			// Make every copy in the batch visible to whatever is submitted to the queue afterwards
+			VkMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+			vkCmdPipelineBarrier(m_Recording.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+				0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+			VK_CHECK(vkEndCommandBuffer(m_Recording.transferCommandBuffer))
+
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &m_Recording.transferCommandBuffer;
+
+			VK_CHECK(vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, m_Recording.fence))
+		}
+
+		m_Recording.token = ++m_LastSubmitted;
+		m_InFlight.push_back(m_Recording);
+		m_IsRecording = false;
+
+		return m_LastSubmitted;
+	}
+
+	bool UploadContext::IsComplete(UploadToken token)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		RetireCompleted();
+		return token <= m_LastCompleted;
+	}
+
+	void UploadContext::Wait(UploadToken token)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		while (token > m_LastCompleted && !m_InFlight.empty())
+		{
+			VkFence fence = m_InFlight.front().fence;
+			vkWaitForFences(m_Device->GetVkDevice(), 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+			RetireCompleted();
+		}
+	}
+
+	UploadContext::Batch& UploadContext::GetBatch()
+	{
+		if (m_IsRecording)
+		{
+			return m_Recording;
+		}
+
+		RetireCompleted();
+
+		if (!m_FreeBatches.empty())
+		{
+			m_Recording = m_FreeBatches.back();
+			m_FreeBatches.pop_back();
+
+			vkResetFences(m_Device->GetVkDevice(), 1, &m_Recording.fence);
+			vkResetCommandBuffer(m_Recording.transferCommandBuffer, 0);
+			if (m_UseTransferQueue)
+			{
+				vkResetCommandBuffer(m_Recording.graphicsCommandBuffer, 0);
+			}
+		}
+		else
+		{
+			m_Recording = Batch{};
+
+			VkFenceCreateInfo fenceInfo{};
+			fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+			VK_CHECK(vkCreateFence(m_Device->GetVkDevice(), &fenceInfo, nullptr, &m_Recording.fence))
+
+			if (m_UseTransferQueue)
+			{
+				m_Recording.transferCommandBuffer = AllocateCommandBuffer(m_TransferCommandPool);
+				m_Recording.graphicsCommandBuffer = AllocateCommandBuffer(m_GraphicsCommandPool);
+
+				VkSemaphoreCreateInfo semaphoreInfo{};
+				semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+				VK_CHECK(vkCreateSemaphore(m_Device->GetVkDevice(), &semaphoreInfo, nullptr, &m_Recording.transferComplete))
+			}
+			else
+			{
+				m_Recording.transferCommandBuffer = AllocateCommandBuffer(m_GraphicsCommandPool);
+			}
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		VK_CHECK(vkBeginCommandBuffer(m_Recording.transferCommandBuffer, &beginInfo))
+		if (m_UseTransferQueue)
+		{
+			VK_CHECK(vkBeginCommandBuffer(m_Recording.graphicsCommandBuffer, &beginInfo))
+		}
+		m_IsRecording = true;
+
+		return m_Recording;
+	}
+
+	void UploadContext::RetireCompleted()
+	{
+		// Batches signal their fence on the graphics queue in submission order
+		while (!m_InFlight.empty() && vkGetFenceStatus(m_Device->GetVkDevice(), m_InFlight.front().fence) == VK_SUCCESS)
+		{
+			m_LastCompleted = m_InFlight.front().token;
+			m_FreeBatches.push_back(m_InFlight.front());
+			m_InFlight.pop_front();
+		}
+
+		TrimStaging();
+	}
+
+	void UploadContext::DestroyBatch(const Batch& batch) const
+	{
+		vkDestroyFence(m_Device->GetVkDevice(), batch.fence, nullptr);
+		if (batch.transferComplete)
+		{
+			vkDestroySemaphore(m_Device->GetVkDevice(), batch.transferComplete, nullptr);
+		}
+	}
+
+	StagingAllocation UploadContext::AllocateStagingLocked(VkDeviceSize dataSize)
+	{
+		// Make sure the allocation belongs to the batch that is being recorded
+		GetBatch();
+
+		auto fits = [dataSize](const StagingPage& page, VkDeviceSize head)
+		{
+			VkDeviceSize offset = (head + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+			return offset + dataSize <= page.buffer->GetDataSize();
+		};
+
+		if (m_CurrentPage >= m_StagingPages.size() || !fits(m_StagingPages[m_CurrentPage], m_StagingPages[m_CurrentPage].head))
+		{
+			m_CurrentPage = SIZE_MAX;
+
+			for (size_t i = 0; i < m_StagingPages.size(); i++)
+			{
+				if (m_StagingPages[i].lastUse <= m_LastCompleted && m_StagingPages[i].reservations == 0 && fits(m_StagingPages[i], 0))
+				{
+					m_StagingPages[i].head = 0;
+					m_CurrentPage = i;
+					break;
+				}
+			}
+
+			if (m_CurrentPage == SIZE_MAX)
+			{
+				StagingPage page{};
+				page.buffer = std::make_unique<StagingBuffer>(m_Device, std::max(STAGING_PAGE_SIZE, dataSize));
+				page.head = 0;
+				page.lastUse = 0;
+				page.reservations = 0;
+
+				m_StagingPages.push_back(std::move(page));
+				m_CurrentPage = m_StagingPages.size() - 1;
+			}
+		}
+
+		StagingPage& page = m_StagingPages[m_CurrentPage];
+		VkDeviceSize offset = (page.head + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+		page.head = offset + dataSize;
+		page.lastUse = m_LastSubmitted + 1;
+
+		StagingAllocation allocation{};
+		allocation.buffer = page.buffer->GetVkBuffer();
+		allocation.offset = offset;
+		allocation.data = static_cast<char*>(page.buffer->GetMappedData()) + offset;
+
+		return allocation;
+	}
+
+	UploadContext::StagingPage* UploadContext::FindStagingPage(VkBuffer buffer)
+	{
+		for (auto& page : m_StagingPages)
+		{
+			if (page.buffer->GetVkBuffer() == buffer)
+			{
+				return &page;
+			}
+		}
+		return nullptr;
+	}
+
+	void UploadContext::MarkStagingUse(VkBuffer srcBuffer)
+	{
+		// The batch being recorded is the one that will be submitted next
+		if (StagingPage* page = FindStagingPage(srcBuffer))
+		{
+			page->lastUse = m_LastSubmitted + 1;
+		}
+	}
+
+	void UploadContext::TrimStaging()
+	{
+		// Keep a single idle page around, everything else goes back to the allocator
+		bool keptIdlePage = false;
+
+		for (size_t i = 0; i < m_StagingPages.size();)
+		{
+			StagingPage& page = m_StagingPages[i];
+			bool isIdle = page.lastUse <= m_LastCompleted && page.reservations == 0 && !(m_IsRecording && i == m_CurrentPage);
+
+			if (isIdle && !keptIdlePage && page.buffer->GetDataSize() == STAGING_PAGE_SIZE)
+			{
+				keptIdlePage = true;
+				i++;
+			}
+			else if (isIdle)
+			{
+				if (m_CurrentPage == i)
+				{
+					m_CurrentPage = SIZE_MAX;
+				}
+				else if (m_CurrentPage != SIZE_MAX && m_CurrentPage > i)
+				{
+					m_CurrentPage--;
+				}
+				m_StagingPages.erase(m_StagingPages.begin() + i);
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+}
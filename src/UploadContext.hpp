@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "Device.hpp"
+#include "Buffer/StagingBuffer.hpp"
+
+#include <span>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+namespace VE
+{
+	using UploadToken = uint64_t;
+
+	struct StagingAllocation
+	{
+		VkBuffer		buffer;
+		VkDeviceSize	offset;
+		void*			data;
+	};
+
+	// Records buffer and image uploads into one command buffer and submits them as a batch.
+	// Submit returns a token that can be polled or waited on instead of stalling the queue.
+	// When the device has a dedicated transfer queue the copies run there and ownership is
+	// handed to the graphics queue, otherwise everything is recorded on the graphics queue.
+	class UploadContext
+	{
+	public:
+		explicit UploadContext(Device* device);
+		~UploadContext();
+
+		UploadContext(const UploadContext& otherContext) = delete;
+		UploadContext& operator=(const UploadContext& otherContext) = delete;
+	public:
+		static inline constexpr VkDeviceSize STAGING_PAGE_SIZE = 16ull * 1024 * 1024;
+		static inline constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+	public:
+		// Staging memory comes from a shared pool and is recycled once the batch reading it completes
+		void UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize dataSize);
+		void UploadImage(VkImage image, uint32_t mipLevels, std::span<const VkBufferImageCopy> regions, const void* data, VkDeviceSize dataSize);
+		StagingAllocation AllocateStaging(VkDeviceSize dataSize);
+		// Staging that stays valid across submits until released, lets worker threads fill it ahead of recording.
+		// Release it once the copy reading it has been recorded
+		StagingAllocation ReserveStaging(VkDeviceSize dataSize);
+		void ReleaseStaging(const StagingAllocation& allocation);
+		void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, const VkBufferCopy& region);
+		void CopyBufferToImage(VkBuffer srcBuffer, VkImage image, uint32_t mipLevels, std::span<const VkBufferImageCopy> regions);
+		// Copies mip 0 and fills the remaining levels with linear blits, the format must support them.
+		// Blits need a graphics queue, with a transfer queue they are recorded after the ownership acquire
+		void CopyBufferToImageWithMipmaps(VkBuffer srcBuffer, VkDeviceSize srcOffset, VkImage image, VkExtent2D extent, uint32_t mipLevels);
+		UploadToken Submit();
+		bool IsComplete(UploadToken token);
+		void Wait(UploadToken token);
+	private:
+		struct Batch
+		{
+			VkCommandBuffer	transferCommandBuffer;
+			VkCommandBuffer	graphicsCommandBuffer;	// Ownership acquires, only used with a transfer queue
+			VkSemaphore		transferComplete;		// Only used with a transfer queue
+			VkFence			fence;
+			UploadToken		token;
+		};
+
+		struct StagingPage
+		{
+			std::unique_ptr<StagingBuffer>	buffer;
+			VkDeviceSize					head;
+			UploadToken						lastUse;
+			uint32_t						reservations; // Pinned while non zero, regardless of lastUse
+		};
+	private:
+		VkCommandPool CreateCommandPool(uint32_t queueFamilyIndex) const;
+		VkCommandBuffer AllocateCommandBuffer(VkCommandPool commandPool) const;
+		Batch& GetBatch();
+		void RetireCompleted();
+		void DestroyBatch(const Batch& batch) const;
+		StagingAllocation AllocateStagingLocked(VkDeviceSize dataSize);
+		StagingPage* FindStagingPage(VkBuffer buffer);
+		void MarkStagingUse(VkBuffer srcBuffer);
+		void TrimStaging();
+		void RecordCopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, const VkBufferCopy& region);
+		void RecordCopyBufferToImage(VkBuffer srcBuffer, VkImage image, uint32_t mipLevels, std::span<const VkBufferImageCopy> regions);
+		void RecordCopyAndBlitMipmaps(VkBuffer srcBuffer, VkDeviceSize srcOffset, VkImage image, VkExtent2D extent, uint32_t mipLevels);
+		void RecordBlitMipmaps(VkCommandBuffer commandBuffer, VkImage image, VkExtent2D extent, uint32_t mipLevels) const;
+	private:
+		Device*				m_Device;
+		bool				m_UseTransferQueue;
+		uint32_t			m_TransferFamily;
+		uint32_t			m_GraphicsFamily;
+		VkQueue				m_TransferQueue;
+		VkQueue				m_GraphicsQueue;
+		VkCommandPool		m_TransferCommandPool;
+		VkCommandPool		m_GraphicsCommandPool;
+		Batch				m_Recording;
+		bool				m_IsRecording;
+		std::deque<Batch>	m_InFlight;
+		std::vector<Batch>	m_FreeBatches;
+		UploadToken			m_LastSubmitted;
+		UploadToken			m_LastCompleted;
+		std::vector<StagingPage>	m_StagingPages;
+		size_t				m_CurrentPage;
+		std::mutex			m_Mutex;
+	};
+}
@@ -0,0 +1,244 @@
+#include "VirtualTexture.hpp"
+
+#include "VirtualTextureCache.hpp"
+
+#include "Utilities.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <bit>
+
+namespace VE
+{
+	using Cache = VirtualTextureCache;
+
+	// Pages needed to cover a level, the table itself may be larger
+	static uint32_t PagesCovering(uint32_t size, uint32_t mip)
+	{
+		return (std::max(size >> mip, 1u) + Cache::PAGE_CONTENT - 1) / Cache::PAGE_CONTENT;
+	}
+
+	VirtualTexture::VirtualTexture(Device* device)
+		:	m_Device(device), m_Path(), m_Width(0), m_Height(0), m_TableWidth(0), m_TableHeight(0), m_TopMip(0),
+			m_IndirectionImage(VK_NULL_HANDLE), m_IndirectionView(VK_NULL_HANDLE), m_IndirectionAllocation{},
+			m_CacheId(INVALID_SLOT)
+	{
+	}
+
+	VirtualTexture::~VirtualTexture()
+	{
+		if (m_CacheId != INVALID_SLOT)
+		{
+			m_Device->GetVirtualTextureCache().Unregister(this);
+		}
+		if (m_IndirectionView)
+		{
+			vkDestroyImageView(m_Device->GetVkDevice(), m_IndirectionView, nullptr);
+		}
+		if (m_IndirectionImage)
+		{
+			vkDestroyImage(m_Device->GetVkDevice(), m_IndirectionImage, nullptr);
+		}
+		m_Device->GetAllocator().Free(m_IndirectionAllocation);
+	}
+
+	void VirtualTexture::Create(TextureData&& data)
+	{
+		if (data.format != VK_FORMAT_R8G8B8A8_UNORM)
+		{
+			throw std::runtime_error("Error: Virtual texture " + data.path + " has to be decoded to RGBA8");
+		}
+
+		m_Path = data.path;
+		m_Width = data.width;
+		m_Height = data.height;
+
+		// Power of two tables keep every level's pages inside the matching indirection mip
+		m_TableWidth = std::bit_ceil(PagesCovering(m_Width, 0));
+		m_TableHeight = std::bit_ceil(PagesCovering(m_Height, 0));
+
+		// The first level that fits into a single page, or the last one the source holds
+		m_TopMip = 0;
+		while (m_TopMip + 1 < data.mipLevels && (PagesCovering(m_Width, m_TopMip) > 1 || PagesCovering(m_Height, m_TopMip) > 1))
+		{
+			m_TopMip++;
+		}
+		if (PagesCovering(m_Width, m_TopMip) * PagesCovering(m_Height, m_TopMip) > MAX_TOP_PAGES)
+		{
+			throw std::runtime_error("Error: Virtual texture " + m_Path + " needs a longer mip chain");
+		}
+
+		m_LevelOffsets.resize(m_TopMip + 2);
+		m_LevelOffsets[0] = 0;
+		for (uint32_t mip = 0; mip <= m_TopMip; mip++)
+		{
+			m_LevelOffsets[mip + 1] = m_LevelOffsets[mip] + std::max(m_TableWidth >> mip, 1u) * std::max(m_TableHeight >> mip, 1u);
+		}
+		m_Pages.resize(m_LevelOffsets.back());
+		m_Indirection.resize(m_Pages.size());
+
+		m_Source = std::make_shared<const TextureData>(std::move(data));
+
+		CreateIndirectionImage();
+		m_CacheId = m_Device->GetVirtualTextureCache().Register(this);
+	}
+
+	bool VirtualTexture::IsReady() const
+	{
+		if (m_Pages.empty())
+		{
+			return false;
+		}
+
+		for (uint32_t page : GetTopPages())
+		{
+			if (m_Pages[page].slot == INVALID_SLOT)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<uint32_t> VirtualTexture::GetTopPages() const
+	{
+		std::vector<uint32_t> pages;
+		for (uint32_t y = 0; y < PagesCovering(m_Height, m_TopMip); y++)
+		{
+			for (uint32_t x = 0; x < PagesCovering(m_Width, m_TopMip); x++)
+			{
+				pages.push_back(GetPageIndex(m_TopMip, x, y));
+			}
+		}
+		return pages;
+	}
+
+	uint32_t VirtualTexture::GetPageIndex(uint32_t mip, uint32_t x, uint32_t y) const
+	{
+		return m_LevelOffsets[mip] + y * std::max(m_TableWidth >> mip, 1u) + x;
+	}
+
+	VirtualTexture::PageCoord VirtualTexture::GetPageCoord(uint32_t index) const
+	{
+		uint32_t mip = static_cast<uint32_t>(std::upper_bound(m_LevelOffsets.begin(), m_LevelOffsets.end(), index) - m_LevelOffsets.begin()) - 1;
+		uint32_t tableWidth = std::max(m_TableWidth >> mip, 1u);
+		uint32_t local = index - m_LevelOffsets[mip];
+		return { mip, local % tableWidth, local / tableWidth };
+	}
+
+	uint32_t VirtualTexture::GetParentIndex(uint32_t index) const
+	{
+		PageCoord coord = GetPageCoord(index);
+		return coord.mip == m_TopMip ? INVALID_SLOT : GetPageIndex(coord.mip + 1, coord.x >> 1, coord.y >> 1);
+	}
+
+	std::span<const uint32_t> VirtualTexture::BuildIndirection(uint32_t slotsPerSide)
+	{
+		// Coarse to fine, so a page without its own slot inherits the entry of its parent
+		for (uint32_t mip = m_TopMip + 1; mip-- > 0;)
+		{
+			for (uint32_t page = m_LevelOffsets[mip]; page < m_LevelOffsets[mip + 1]; page++)
+			{
+				uint32_t slot = m_Pages[page].slot;
+				if (slot != INVALID_SLOT)
+				{
+					m_Indirection[page] = (slot % slotsPerSide) | (slot / slotsPerSide) << 8 | mip << 16 | 1u << 24;
+				}
+				else
+				{
+					uint32_t parent = GetParentIndex(page);
+					m_Indirection[page] = parent == INVALID_SLOT ? 0 : m_Indirection[parent];
+				}
+			}
+		}
+		return m_Indirection;
+	}
+
+	void VirtualTexture::RecordIndirectionCopy(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset) const
+	{
+		std::vector<VkBufferImageCopy> regions(m_TopMip + 1);
+		for (uint32_t mip = 0; mip <= m_TopMip; mip++)
+		{
+			VkBufferImageCopy& region = regions[mip];
+			region.bufferOffset = srcOffset + static_cast<VkDeviceSize>(m_LevelOffsets[mip]) * sizeof(uint32_t);
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = mip;
+			region.imageSubresource.layerCount = 1;
+			region.imageExtent = { std::max(m_TableWidth >> mip, 1u), std::max(m_TableHeight >> mip, 1u), 1 };
+		}
+
+		vkCmdCopyBufferToImage(commandBuffer, srcBuffer, m_IndirectionImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			static_cast<uint32_t>(regions.size()), regions.data());
+	}
+
+	void VirtualTexture::ExtractPage(const TextureData& source, const PageCoord& coord, uint8_t* dst)
+	{
+		const uint8_t* level = source.pixels.get();
+		if (coord.mip > 0)
+		{
+			level = source.mipChain.data();
+			for (uint32_t i = 1; i < coord.mip; i++)
+			{
+				level += source.GetLevelSize(i);
+			}
+		}
+
+		int64_t levelWidth = std::max(source.width >> coord.mip, 1u);
+		int64_t levelHeight = std::max(source.height >> coord.mip, 1u);
+		int64_t originX = static_cast<int64_t>(coord.x) * Cache::PAGE_CONTENT - Cache::PAGE_BORDER;
+		int64_t originY = static_cast<int64_t>(coord.y) * Cache::PAGE_CONTENT - Cache::PAGE_BORDER;
+
+		for (uint32_t y = 0; y < Cache::PAGE_SIZE; y++)
+		{
+			int64_t sourceY = ((originY + y) % levelHeight + levelHeight) % levelHeight;
+			const uint8_t* row = level + sourceY * levelWidth * 4;
+			uint8_t* out = dst + static_cast<size_t>(y) * Cache::PAGE_SIZE * 4;
+
+			// Copy runs up to the level's right edge and continue from its left one
+			uint32_t x = 0;
+			while (x < Cache::PAGE_SIZE)
+			{
+				int64_t sourceX = ((originX + x) % levelWidth + levelWidth) % levelWidth;
+				uint32_t run = static_cast<uint32_t>(std::min<int64_t>(Cache::PAGE_SIZE - x, levelWidth - sourceX));
+				std::memcpy(out + x * 4, row + sourceX * 4, static_cast<size_t>(run) * 4);
+				x += run;
+			}
+		}
+	}
+
+	void VirtualTexture::CreateIndirectionImage()
+	{
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent.width = m_TableWidth;
+		imageInfo.extent.height = m_TableHeight;
+		imageInfo.extent.depth = 1;
+		imageInfo.mipLevels = m_TopMip + 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = VK_FORMAT_R8G8B8A8_UINT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+
+		VK_CHECK(vkCreateImage(m_Device->GetVkDevice(), &imageInfo, nullptr, &m_IndirectionImage))
+
+		m_IndirectionAllocation = m_Device->GetAllocator().AllocateImage(m_IndirectionImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = m_IndirectionImage;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = VK_FORMAT_R8G8B8A8_UINT;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = m_TopMip + 1;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		VK_CHECK(vkCreateImageView(m_Device->GetVkDevice(), &viewInfo, nullptr, &m_IndirectionView))
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "Device.hpp"
+#include "Texture.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <span>
+
+namespace VE
+{
+	// A texture split into pages that are streamed into the device's VirtualTextureCache on demand.
+	// Only the indirection image lives on the device per texture, it maps every page of every mip to the
+	// physical cache slot holding it or holding its nearest resident ancestor. The decoded source stays in
+	// host memory and is cut into pages by the streaming thread.
+	class VirtualTexture
+	{
+	public:
+		explicit VirtualTexture(Device* device);
+		~VirtualTexture();
+
+		VirtualTexture(const VirtualTexture& otherTexture) = delete;
+		VirtualTexture& operator=(const VirtualTexture& otherTexture) = delete;
+	public:
+		static inline constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+		static inline constexpr uint32_t MAX_TOP_PAGES = 16;
+
+		struct Page
+		{
+			uint32_t	slot = INVALID_SLOT;
+			bool		isPending = false;
+		};
+
+		struct PageCoord
+		{
+			uint32_t	mip;
+			uint32_t	x;
+			uint32_t	y;
+		};
+	public:
+		// Takes RGBA8 data with its full mip chain, see Texture::GenerateMipChain, and registers with the cache
+		void Create(TextureData&& data);
+		// True once every page of the top mip is resident, those pages are never evicted
+		bool IsReady() const;
+		inline VkDeviceSize GetMemorySize() const { return m_IndirectionAllocation.size; }
+		inline const std::string& GetPath() const { return m_Path; }
+		inline uint32_t GetWidth() const { return m_Width; }
+		inline uint32_t GetHeight() const { return m_Height; }
+		inline uint32_t GetTableWidth() const { return m_TableWidth; }
+		inline uint32_t GetTableHeight() const { return m_TableHeight; }
+		inline uint32_t GetTopMip() const { return m_TopMip; }
+		inline uint32_t GetPageCount() const { return static_cast<uint32_t>(m_Pages.size()); }
+		inline const std::shared_ptr<const TextureData>& GetSource() const { return m_Source; }
+		inline VkImage GetIndirectionImage() const { return m_IndirectionImage; }
+		inline VkImageView GetIndirectionView() const { return m_IndirectionView; }
+		inline uint32_t GetCacheId() const { return m_CacheId; }
+	public:
+		// Page state is owned by the cache, which calls these from the main thread
+		inline Page& GetPage(uint32_t index) { return m_Pages[index]; }
+		uint32_t GetPageIndex(uint32_t mip, uint32_t x, uint32_t y) const;
+		PageCoord GetPageCoord(uint32_t index) const;
+		// Index of the page one mip up covering this one, or INVALID_SLOT for top mip pages
+		uint32_t GetParentIndex(uint32_t index) const;
+		// The top mip pages that cover texels, usually just one
+		std::vector<uint32_t> GetTopPages() const;
+		// RGBA8_UINT entries level after level, slot x, slot y, resident mip and a valid flag
+		std::span<const uint32_t> BuildIndirection(uint32_t slotsPerSide);
+		void RecordIndirectionCopy(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset) const;
+		// Cuts a page with its border out of the source, edges wrap like a repeating sampler. Safe on any thread
+		static void ExtractPage(const TextureData& source, const PageCoord& coord, uint8_t* dst);
+	private:
+		void CreateIndirectionImage();
+	private:
+		Device*								m_Device;
+		std::string							m_Path;
+		std::shared_ptr<const TextureData>	m_Source;
+		uint32_t							m_Width;
+		uint32_t							m_Height;
+		uint32_t							m_TableWidth;
+		uint32_t							m_TableHeight;
+		uint32_t							m_TopMip;
+		std::vector<uint32_t>				m_LevelOffsets; // First page of every mip, plus the total page count
+		std::vector<Page>					m_Pages;
+		std::vector<uint32_t>				m_Indirection;
+		VkImage								m_IndirectionImage;
+		VkImageView							m_IndirectionView;
+		Allocation							m_IndirectionAllocation;
+		uint32_t							m_CacheId;
+	};
+}
@@ -0,0 +1,522 @@
+#include "VirtualTextureCache.hpp"
+
+#include "VirtualTexture.hpp"
+#include "Swapchain.hpp"
+#include "SamplerCache.hpp"
+#include "Descriptor/DescriptorAllocator.hpp"
+
+#include "Utilities.hpp"
+
+#include <array>
+#include <string>
+#include <tuple>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+namespace VE
+{
+	// Page texels of the frame's uploads come first in its staging buffer, the indirection tables follow
+	static constexpr VkDeviceSize INDIRECTION_STAGING_OFFSET = VirtualTextureCache::MAX_UPLOADS_PER_FRAME * VirtualTextureCache::PAGE_BYTES;
+
+	VirtualTextureCache::VirtualTextureCache(Device* device)
+		:	m_Device(device), m_PhysicalImage(VK_NULL_HANDLE), m_PhysicalView(VK_NULL_HANDLE), m_PhysicalAllocation{},
+			m_PhysicalSampler(VK_NULL_HANDLE), m_IndirectionSampler(VK_NULL_HANDLE), m_DescriptorSetLayout(VK_NULL_HANDLE),
+			m_IsPhysicalInitialized(false), m_Slots(SLOT_COUNT), m_NextId(0),
+			m_FrameCounter(0), m_FeedbackPixel(0), m_PendingCount(0), m_ResidentCount(0), m_ThreadPool(STREAMING_THREAD_COUNT)
+	{
+		CreatePhysicalImage();
+		CreateSamplers();
+		CreateDescriptorSetLayout();
+		CreateFrameData();
+	}
+
+	VirtualTextureCache::~VirtualTextureCache()
+	{
+		vkDestroyDescriptorSetLayout(m_Device->GetVkDevice(), m_DescriptorSetLayout, nullptr);
+		vkDestroyImageView(m_Device->GetVkDevice(), m_PhysicalView, nullptr);
+		vkDestroyImage(m_Device->GetVkDevice(), m_PhysicalImage, nullptr);
+		m_Device->GetAllocator().Free(m_PhysicalAllocation);
+	}
+
+	bool VirtualTextureCache::IsSupported(Device* device)
+	{
+		return	device->GetEnabledFeatures().fragmentStoresAndAtomics &&
+				device->SupportsFormatFeatures(VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) &&
+				device->SupportsFormatFeatures(VK_FORMAT_R8G8B8A8_UINT, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+	}
+
+	uint32_t VirtualTextureCache::Register(VirtualTexture* texture)
+	{
+		if (m_Registrations.size() >= MAX_VIRTUAL_TEXTURES)
+		{
+			throw std::runtime_error("Error: Too many virtual textures, the limit is " + std::to_string(MAX_VIRTUAL_TEXTURES));
+		}
+
+		Registration registration{};
+		registration.texture = texture;
+		registration.tableOffset = AllocateTableRange(texture->GetPageCount());
+		registration.isDirty = true;
+		registration.isInitialized = false;
+
+		std::vector<VkDescriptorSetLayout> layouts(Swapchain::MAX_FRAMES_IN_FLIGHT, m_DescriptorSetLayout);
+		registration.descriptorSets.resize(layouts.size());
+		registration.descriptorPool = m_Device->GetDescriptorAllocator().Allocate(layouts, registration.descriptorSets.data());
+
+		for (uint32_t frame = 0; frame < registration.descriptorSets.size(); frame++)
+		{
+			std::array<VkDescriptorImageInfo, 2> imageInfos{};
+			imageInfos[0] = { m_PhysicalSampler, m_PhysicalView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+			imageInfos[1] = { m_IndirectionSampler, texture->GetIndirectionView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+			VkDescriptorBufferInfo bufferInfo{ m_Frames[frame].feedbackBuffer->GetVkBuffer(), 0, VK_WHOLE_SIZE };
+
+			std::array<VkWriteDescriptorSet, 3> writes{};
+			for (uint32_t binding = 0; binding < writes.size(); binding++)
+			{
+				writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writes[binding].dstSet = registration.descriptorSets[frame];
+				writes[binding].dstBinding = binding;
+				writes[binding].descriptorCount = 1;
+				writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			}
+			writes[0].pImageInfo = &imageInfos[0];
+			writes[1].pImageInfo = &imageInfos[1];
+			writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[2].pBufferInfo = &bufferInfo;
+
+			vkUpdateDescriptorSets(m_Device->GetVkDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+			// The range may have been flagged by a texture registered there before
+			uint32_t* feedback = static_cast<uint32_t*>(m_Frames[frame].feedbackBuffer->GetMappedData()) + registration.tableOffset;
+			std::memset(feedback, 0, texture->GetPageCount() * sizeof(uint32_t));
+		}
+
+		uint32_t id = m_NextId++;
+		m_Registrations.emplace(id, std::move(registration));
+
+		for (uint32_t page : texture->GetTopPages())
+		{
+			RequestPage(id, page);
+		}
+
+		return id;
+	}
+
+	void VirtualTextureCache::Unregister(VirtualTexture* texture)
+	{
+		auto it = m_Registrations.find(texture->GetCacheId());
+		if (it == m_Registrations.end())
+		{
+			return;
+		}
+
+		for (Slot& slot : m_Slots)
+		{
+			if (slot.textureId == it->first)
+			{
+				slot = {};
+				m_ResidentCount--;
+			}
+		}
+
+		// Pages still being streamed for it are dropped when they arrive
+		m_Device->GetDescriptorAllocator().Free(it->second.descriptorPool, it->second.descriptorSets);
+		m_Registrations.erase(it);
+	}
+
+	void VirtualTextureCache::Update(VkCommandBuffer commandBuffer, uint32_t frame)
+	{
+		m_FrameCounter++;
+		m_FeedbackPixel = static_cast<uint32_t>(m_FrameCounter % FEEDBACK_PERIOD);
+
+		const FrameData& frameData = m_Frames[frame];
+		ProcessFeedback(frameData);
+		RecordUploads(commandBuffer, frameData);
+	}
+
+	void VirtualTextureCache::EndFrame(VkCommandBuffer commandBuffer)
+	{
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	void VirtualTextureCache::Bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t frame, const VirtualTexture& texture) const
+	{
+		const Registration& registration = m_Registrations.at(texture.GetCacheId());
+
+		DrawParams params{};
+		params.width = texture.GetWidth();
+		params.height = texture.GetHeight();
+		params.tableWidth = texture.GetTableWidth();
+		params.tableHeight = texture.GetTableHeight();
+		params.feedbackOffset = registration.tableOffset;
+		params.topMip = texture.GetTopMip();
+		params.feedbackPixel = m_FeedbackPixel;
+
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &registration.descriptorSets[frame], 0, nullptr);
+		vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(params), &params);
+	}
+
+	uint32_t VirtualTextureCache::AllocateTableRange(uint32_t pageCount) const
+	{
+		std::vector<std::pair<uint32_t, uint32_t>> ranges;
+		for (const auto& [id, registration] : m_Registrations)
+		{
+			ranges.emplace_back(registration.tableOffset, registration.texture->GetPageCount());
+		}
+		std::sort(ranges.begin(), ranges.end());
+
+		// First fit between the ranges of registered textures
+		uint32_t offset = 0;
+		for (const auto& [rangeOffset, rangeCount] : ranges)
+		{
+			if (rangeOffset - offset >= pageCount)
+			{
+				break;
+			}
+			offset = rangeOffset + rangeCount;
+		}
+
+		if (offset + pageCount > MAX_VIRTUAL_PAGES)
+		{
+			throw std::runtime_error("Error: Out of virtual texture pages, " + std::to_string(pageCount) + " more requested");
+		}
+		return offset;
+	}
+
+	void VirtualTextureCache::ProcessFeedback(const FrameData& frameData)
+	{
+		// The fence of this frame slot has been waited on, so its flags are complete
+		uint32_t* feedback = static_cast<uint32_t*>(frameData.feedbackBuffer->GetMappedData());
+
+		std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> requests;
+		for (auto& [id, registration] : m_Registrations)
+		{
+			VirtualTexture& texture = *registration.texture;
+			uint32_t* flags = feedback + registration.tableOffset;
+
+			for (uint32_t page = 0; page < texture.GetPageCount(); page++)
+			{
+				if (flags[page] == 0)
+				{
+					continue;
+				}
+				flags[page] = 0;
+
+				const VirtualTexture::Page& state = texture.GetPage(page);
+				if (state.slot == VirtualTexture::INVALID_SLOT && !state.isPending)
+				{
+					requests.emplace_back(texture.GetPageCoord(page).mip, id, page);
+				}
+				Touch(registration, page);
+			}
+		}
+
+		// Coarse pages first, they stand in for the fine ones until those arrive
+		std::sort(requests.begin(), requests.end(), [](const auto& a, const auto& b) { return std::get<0>(a) > std::get<0>(b); });
+
+		for (const auto& [mip, id, page] : requests)
+		{
+			if (m_PendingCount >= MAX_PENDING_PAGES)
+			{
+				break;
+			}
+			RequestPage(id, page);
+		}
+	}
+
+	void VirtualTextureCache::RequestPage(uint32_t textureId, uint32_t page)
+	{
+		VirtualTexture& texture = *m_Registrations.at(textureId).texture;
+		texture.GetPage(page).isPending = true;
+		m_PendingCount++;
+
+		m_ThreadPool.Submit([this, textureId, page, coord = texture.GetPageCoord(page), source = texture.GetSource()]()
+		{
+			StreamedPage streamed{ textureId, page, std::vector<uint8_t>(PAGE_BYTES) };
+			VirtualTexture::ExtractPage(*source, coord, streamed.texels.data());
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Streamed.push_back(std::move(streamed));
+		});
+	}
+
+	void VirtualTextureCache::Touch(Registration& registration, uint32_t page)
+	{
+		// Resident ancestors are what gets sampled until the page itself arrives, keep them too
+		for (; page != VirtualTexture::INVALID_SLOT; page = registration.texture->GetParentIndex(page))
+		{
+			uint32_t slot = registration.texture->GetPage(page).slot;
+			if (slot != VirtualTexture::INVALID_SLOT)
+			{
+				m_Slots[slot].lastUse = m_FrameCounter;
+			}
+		}
+	}
+
+	uint32_t VirtualTextureCache::AcquireSlot(bool isPinned)
+	{
+		uint32_t bestSlot = VirtualTexture::INVALID_SLOT;
+		uint64_t bestUse = UINT64_MAX;
+
+		for (uint32_t i = 0; i < m_Slots.size(); i++)
+		{
+			const Slot& slot = m_Slots[i];
+			if (slot.textureId == UINT32_MAX)
+			{
+				return i;
+			}
+
+			bool isRecent = slot.lastUse + FEEDBACK_PERIOD > m_FrameCounter;
+			if (slot.isPinned || (isRecent && !isPinned))
+			{
+				continue;
+			}
+			if (slot.lastUse < bestUse)
+			{
+				bestSlot = i;
+				bestUse = slot.lastUse;
+			}
+		}
+
+		if (bestSlot == VirtualTexture::INVALID_SLOT && isPinned)
+		{
+			throw std::runtime_error("Error: Virtual texture cache is full of top mip pages");
+		}
+		return bestSlot;
+	}
+
+	void VirtualTextureCache::Evict(uint32_t slot)
+	{
+		auto it = m_Registrations.find(m_Slots[slot].textureId);
+		if (it != m_Registrations.end())
+		{
+			it->second.texture->GetPage(m_Slots[slot].page).slot = VirtualTexture::INVALID_SLOT;
+			it->second.isDirty = true;
+			m_ResidentCount--;
+		}
+		m_Slots[slot] = {};
+	}
+
+	void VirtualTextureCache::RecordUploads(VkCommandBuffer commandBuffer, const FrameData& frameData)
+	{
+		std::vector<StreamedPage> streamed;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			size_t count = std::min<size_t>(m_Streamed.size(), MAX_UPLOADS_PER_FRAME);
+			streamed.assign(std::make_move_iterator(m_Streamed.begin()), std::make_move_iterator(m_Streamed.begin() + count));
+			m_Streamed.erase(m_Streamed.begin(), m_Streamed.begin() + count);
+		}
+		m_PendingCount -= static_cast<uint32_t>(streamed.size());
+
+		uint8_t* staging = static_cast<uint8_t*>(frameData.stagingBuffer->GetMappedData());
+
+		std::vector<VkBufferImageCopy> pageCopies;
+		for (const StreamedPage& page : streamed)
+		{
+			auto it = m_Registrations.find(page.textureId);
+			if (it == m_Registrations.end())
+			{
+				continue;
+			}
+
+			VirtualTexture& texture = *it->second.texture;
+			texture.GetPage(page.page).isPending = false;
+
+			// Without a free slot the page is dropped, feedback asks for it again while it's still wanted
+			bool isPinned = texture.GetPageCoord(page.page).mip == texture.GetTopMip();
+			uint32_t slot = AcquireSlot(isPinned);
+			if (slot == VirtualTexture::INVALID_SLOT)
+			{
+				continue;
+			}
+
+			Evict(slot);
+			m_Slots[slot] = { page.textureId, page.page, m_FrameCounter, isPinned };
+			texture.GetPage(page.page).slot = slot;
+			it->second.isDirty = true;
+			m_ResidentCount++;
+
+			VkDeviceSize offset = pageCopies.size() * PAGE_BYTES;
+			std::memcpy(staging + offset, page.texels.data(), static_cast<size_t>(PAGE_BYTES));
+
+			VkBufferImageCopy region{};
+			region.bufferOffset = offset;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = { static_cast<int32_t>(slot % SLOTS_PER_SIDE * PAGE_SIZE), static_cast<int32_t>(slot / SLOTS_PER_SIDE * PAGE_SIZE), 0 };
+			region.imageExtent = { PAGE_SIZE, PAGE_SIZE, 1 };
+			pageCopies.push_back(region);
+		}
+
+		std::vector<Registration*> dirty;
+		for (auto& [id, registration] : m_Registrations)
+		{
+			if (registration.isDirty)
+			{
+				std::span<const uint32_t> entries = registration.texture->BuildIndirection(SLOTS_PER_SIDE);
+				std::memcpy(staging + INDIRECTION_STAGING_OFFSET + registration.tableOffset * sizeof(uint32_t), entries.data(), entries.size_bytes());
+				dirty.push_back(&registration);
+			}
+		}
+
+		bool updatePhysical = !pageCopies.empty() || !m_IsPhysicalInitialized;
+		if (!updatePhysical && dirty.empty())
+		{
+			return;
+		}
+
+		// Earlier frames may still sample what gets overwritten, the barrier orders the copies after their fragment work
+		std::vector<VkImageMemoryBarrier> barriers;
+		auto addBarrier = [&barriers](VkImage image, uint32_t mipLevels, bool isInitialized)
+		{
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.oldLayout = isInitialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = image;
+			barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1 };
+			barriers.push_back(barrier);
+		};
+
+		if (updatePhysical)
+		{
+			addBarrier(m_PhysicalImage, 1, m_IsPhysicalInitialized);
+		}
+		for (const Registration* registration : dirty)
+		{
+			addBarrier(registration->texture->GetIndirectionImage(), registration->texture->GetTopMip() + 1, registration->isInitialized);
+		}
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+			static_cast<uint32_t>(barriers.size()), barriers.data());
+
+		if (!pageCopies.empty())
+		{
+			vkCmdCopyBufferToImage(commandBuffer, frameData.stagingBuffer->GetVkBuffer(), m_PhysicalImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(pageCopies.size()), pageCopies.data());
+		}
+		for (Registration* registration : dirty)
+		{
+			registration->texture->RecordIndirectionCopy(commandBuffer, frameData.stagingBuffer->GetVkBuffer(),
+				INDIRECTION_STAGING_OFFSET + registration->tableOffset * sizeof(uint32_t));
+			registration->isDirty = false;
+			registration->isInitialized = true;
+		}
+		m_IsPhysicalInitialized = true;
+
+		for (VkImageMemoryBarrier& barrier : barriers)
+		{
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		}
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr,
+			static_cast<uint32_t>(barriers.size()), barriers.data());
+	}
+
+	void VirtualTextureCache::CreatePhysicalImage()
+	{
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent.width = SLOTS_PER_SIDE * PAGE_SIZE;
+		imageInfo.extent.height = SLOTS_PER_SIDE * PAGE_SIZE;
+		imageInfo.extent.depth = 1;
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+
+		VK_CHECK(vkCreateImage(m_Device->GetVkDevice(), &imageInfo, nullptr, &m_PhysicalImage))
+
+		m_PhysicalAllocation = m_Device->GetAllocator().AllocateImage(m_PhysicalImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = m_PhysicalImage;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+		viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+		VK_CHECK(vkCreateImageView(m_Device->GetVkDevice(), &viewInfo, nullptr, &m_PhysicalView))
+	}
+
+	void VirtualTextureCache::CreateSamplers()
+	{
+		// The page border covers bilinear footprints, mip selection and wrapping happen in the shader
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_LINEAR;
+		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.anisotropyEnable = VK_FALSE;
+		samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+		samplerInfo.unnormalizedCoordinates = VK_FALSE;
+		samplerInfo.compareEnable = VK_FALSE;
+		samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+		samplerInfo.minLod = 0.0f;
+		samplerInfo.maxLod = 0.0f;
+
+		m_PhysicalSampler = m_Device->GetSamplerCache().Get(samplerInfo);
+
+		// Integer formats can't be filtered, the shader only uses texelFetch on it anyway
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+		m_IndirectionSampler = m_Device->GetSamplerCache().Get(samplerInfo);
+	}
+
+	void VirtualTextureCache::CreateDescriptorSetLayout()
+	{
+		std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+		for (uint32_t i = 0; i < bindings.size(); i++)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		}
+		bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VK_CHECK(vkCreateDescriptorSetLayout(m_Device->GetVkDevice(), &layoutInfo, nullptr, &m_DescriptorSetLayout))
+	}
+
+	void VirtualTextureCache::CreateFrameData()
+	{
+		m_Frames.resize(Swapchain::MAX_FRAMES_IN_FLIGHT);
+		for (FrameData& frame : m_Frames)
+		{
+			// Host visible so the flags can be read back without a copy, they are cleared by the host after reading
+			VkDeviceSize feedbackSize = MAX_VIRTUAL_PAGES * sizeof(uint32_t);
+			frame.feedbackBuffer = std::make_unique<StorageBuffer>(m_Device, feedbackSize, 0,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			std::memset(frame.feedbackBuffer->GetMappedData(), 0, static_cast<size_t>(feedbackSize));
+
+			frame.stagingBuffer = std::make_unique<StagingBuffer>(m_Device, INDIRECTION_STAGING_OFFSET + MAX_VIRTUAL_PAGES * sizeof(uint32_t));
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "Device.hpp"
+#include "ThreadPool.hpp"
+
+#include "Buffer/StagingBuffer.hpp"
+#include "Buffer/StorageBuffer.hpp"
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace VE
+{
+	class VirtualTexture;
+
+	// Physical page cache shared by all virtual textures, works without sparse binding.
+	// The fragment shader flags the pages it wants in a per frame feedback buffer, sampled on a rotating
+	// 1 in 16 pixel pattern. Once the frame's fence has passed Update reads the flags back, queues missing
+	// pages on the streaming thread and records the copies of finished pages into the frame's command buffer.
+	// Slots are reused least recently used first, the top mip of every texture stays resident so a sample
+	// always finds at least a blurry page.
+	class VirtualTextureCache
+	{
+	public:
+		explicit VirtualTextureCache(Device* device);
+		~VirtualTextureCache();
+
+		VirtualTextureCache(const VirtualTextureCache& otherCache) = delete;
+		VirtualTextureCache& operator=(const VirtualTextureCache& otherCache) = delete;
+	public:
+		// Physical page edge, the content is surrounded by a border so bilinear filtering never reads a neighbour
+		static inline constexpr uint32_t PAGE_SIZE = 128;
+		static inline constexpr uint32_t PAGE_BORDER = 4;
+		static inline constexpr uint32_t PAGE_CONTENT = PAGE_SIZE - 2 * PAGE_BORDER;
+		static inline constexpr VkDeviceSize PAGE_BYTES = PAGE_SIZE * PAGE_SIZE * 4;
+		static inline constexpr uint32_t SLOTS_PER_SIDE = 32;
+		static inline constexpr uint32_t SLOT_COUNT = SLOTS_PER_SIDE * SLOTS_PER_SIDE;
+		// Pages of all registered textures together, sizes the feedback and indirection staging
+		static inline constexpr uint32_t MAX_VIRTUAL_PAGES = 64 * 1024;
+		static inline constexpr uint32_t MAX_VIRTUAL_TEXTURES = 64;
+		static inline constexpr uint32_t MAX_UPLOADS_PER_FRAME = 16;
+		static inline constexpr uint32_t MAX_PENDING_PAGES = 64;
+		// Every pixel of a 4x4 block writes feedback once per period, a slot untouched for a period is evictable
+		static inline constexpr uint32_t FEEDBACK_PERIOD = 16;
+		static inline constexpr uint32_t STREAMING_THREAD_COUNT = 1;
+
+		struct DrawParams
+		{
+			uint32_t	width;
+			uint32_t	height;
+			uint32_t	tableWidth;
+			uint32_t	tableHeight;
+			uint32_t	feedbackOffset;
+			uint32_t	topMip;
+			uint32_t	feedbackPixel;
+			uint32_t	padding;
+		};
+	public:
+		// The device needs fragmentStoresAndAtomics for the feedback writes
+		static bool IsSupported(Device* device);
+		// Returns the id the texture is known by, the top mip pages are requested right away
+		uint32_t Register(VirtualTexture* texture);
+		void Unregister(VirtualTexture* texture);
+		// Reads the feedback of the frame that last used this slot and records page and indirection copies,
+		// call after the frame's fence has been waited on and outside of the render pass
+		void Update(VkCommandBuffer commandBuffer, uint32_t frame);
+		// Makes the frame's feedback writes visible to the host once its fence signals, call after the render pass
+		void EndFrame(VkCommandBuffer commandBuffer);
+		void Bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t frame, const VirtualTexture& texture) const;
+		inline VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+		inline uint32_t GetResidentCount() const { return m_ResidentCount; }
+	private:
+		struct Slot
+		{
+			uint32_t	textureId = UINT32_MAX;
+			uint32_t	page = 0;
+			uint64_t	lastUse = 0;
+			bool		isPinned = false;
+		};
+
+		struct Registration
+		{
+			VirtualTexture*					texture;
+			uint32_t						tableOffset;
+			std::vector<VkDescriptorSet>	descriptorSets;
+			VkDescriptorPool				descriptorPool; // Of the device's descriptor allocator
+			bool							isDirty;
+			bool							isInitialized; // The indirection image has left VK_IMAGE_LAYOUT_UNDEFINED
+		};
+
+		struct StreamedPage
+		{
+			uint32_t				textureId;
+			uint32_t				page;
+			std::vector<uint8_t>	texels;
+		};
+
+		struct FrameData
+		{
+			std::unique_ptr<StorageBuffer>	feedbackBuffer;
+			std::unique_ptr<StagingBuffer>	stagingBuffer; // Page texels first, indirection tables after them
+		};
+	private:
+		void CreatePhysicalImage();
+		void CreateSamplers();
+		void CreateDescriptorSetLayout();
+		void CreateFrameData();
+		uint32_t AllocateTableRange(uint32_t pageCount) const;
+		void ProcessFeedback(const FrameData& frameData);
+		void RequestPage(uint32_t textureId, uint32_t page);
+		void Touch(Registration& registration, uint32_t page);
+		// Least recently used slot not touched within the feedback period, pinned pages may take any unpinned slot
+		uint32_t AcquireSlot(bool isPinned);
+		void Evict(uint32_t slot);
+		void RecordUploads(VkCommandBuffer commandBuffer, const FrameData& frameData);
+	private:
+		Device*										m_Device;
+		VkImage										m_PhysicalImage;
+		VkImageView									m_PhysicalView;
+		Allocation									m_PhysicalAllocation;
+		VkSampler									m_PhysicalSampler;
+		VkSampler									m_IndirectionSampler;
+		VkDescriptorSetLayout						m_DescriptorSetLayout;
+		bool										m_IsPhysicalInitialized;
+		std::vector<FrameData>						m_Frames;
+		std::vector<Slot>							m_Slots;
+		std::unordered_map<uint32_t, Registration>	m_Registrations;
+		uint32_t									m_NextId;
+		uint64_t									m_FrameCounter;
+		uint32_t									m_FeedbackPixel;
+		uint32_t									m_PendingCount;
+		uint32_t									m_ResidentCount;
+		std::vector<StreamedPage>					m_Streamed; // Guarded by m_Mutex
+		std::mutex									m_Mutex;
+		ThreadPool									m_ThreadPool; // Last, so the streaming thread is joined before m_Streamed goes away
+	};
+}
@@ -21,4 +21,10 @@ namespace VE
 
         m_Window = glfwCreateWindow(m_Width, m_Height, m_WindowTitle.c_str(), nullptr, nullptr);
     }
+
+    void Window::SetSubtitle(const std::string& subtitle)
+    {
+        std::string title = m_WindowTitle + " - " + subtitle;
+        glfwSetWindowTitle(m_Window, title.c_str());
+    }
 }
\ No newline at end of file
@@ -17,6 +17,8 @@ namespace VE
         Window& operator=(const Window& otherWindow) = delete;
     public:
         void InitWindow();
+        // Shown after the title the window was created with
+        void SetSubtitle(const std::string& subtitle);
     public:
         inline bool ShouldClose() const { return glfwWindowShouldClose(m_Window); }
         inline GLFWwindow* GetGLFWWindow() const { return m_Window; }